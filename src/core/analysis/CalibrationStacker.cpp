@@ -0,0 +1,216 @@
+// File: src/core/analysis/CalibrationStacker.cpp
+/**
+ * @file src/core/analysis/CalibrationStacker.cpp
+ * @brief Implements the streaming stacker of calibration frames.
+ */
+#include "CalibrationStacker.hpp"
+#include "../io/raw/RawFile.hpp"
+#include "../utils/ThreadPool.hpp"
+#include <opencv2/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <sstream>
+#include <libintl.h>
+
+#define _(string) gettext(string)
+
+namespace {
+
+/// Frames a uint32 per-pixel sum of 16-bit values can hold: floor((2^32 - 1) / 65535).
+constexpr int MAX_STACKED_FRAMES = 65537;
+
+/**
+ * @brief Adds one row of a frame to the per-pixel sums and the square sums of a
+ * 2-periodic tile row (lanes alternate even and odd columns).
+ */
+void AccumulateRowPeriod2(const uint16_t* src, uint32_t* sums, int cols, uint64_t& even_squares, uint64_t& odd_squares) {
+    int c = 0;
+#if CV_SIMD128
+    // With c a multiple of 8, lane 0 of every 64-bit pair holds an even column.
+    cv::v_uint64x2 v_squares = cv::v_setzero_u64();
+    for (; c <= cols - cv::v_uint16x8::nlanes; c += cv::v_uint16x8::nlanes) {
+        const cv::v_uint16x8 v = cv::v_load(src + c);
+        cv::v_uint32x4 low, high;
+        cv::v_expand(v, low, high);
+        cv::v_store(sums + c, cv::v_load(sums + c) + low);
+        cv::v_store(sums + c + 4, cv::v_load(sums + c + 4) + high);
+        cv::v_uint32x4 square_low, square_high;
+        cv::v_mul_expand(v, v, square_low, square_high);
+        cv::v_uint64x2 a, b;
+        cv::v_expand(square_low, a, b);
+        v_squares = v_squares + a + b;
+        cv::v_expand(square_high, a, b);
+        v_squares = v_squares + a + b;
+    }
+    uint64_t lanes[2];
+    cv::v_store(lanes, v_squares);
+    even_squares += lanes[0];
+    odd_squares += lanes[1];
+#endif
+    for (; c < cols; ++c) {
+        const uint64_t value = src[c];
+        sums[c] += static_cast<uint32_t>(value);
+        ((c & 1) ? odd_squares : even_squares) += value * value;
+    }
+}
+
+/// Accumulators of one group of pixels, reduced from the per-pixel sums.
+struct GroupTotals {
+    uint64_t pixel_count = 0;
+    uint64_t sum = 0;            ///< Sum of the per-pixel sums.
+    double sum_of_squared_sums = 0.0;
+    double square_sum = 0.0;     ///< Sum of the squared samples (exact per position, see WideSum).
+};
+
+StackedLevel ToStackedLevel(const GroupTotals& totals, const RawHistogram& means, int frame_count) {
+    StackedLevel level;
+    if (totals.pixel_count == 0) return level;
+    const double n = static_cast<double>(frame_count);
+    const double pixels = static_cast<double>(totals.pixel_count);
+    level.mean = static_cast<double>(totals.sum) / (n * pixels);
+    level.median = means.GetMedian();
+
+    // Per-pixel variance over frames, averaged over pixels (unbiased in the frame count).
+    double temporal_variance = 0.0;
+    if (frame_count > 1) {
+        temporal_variance = (totals.square_sum - totals.sum_of_squared_sums / n) / (pixels * (n - 1.0));
+        temporal_variance = std::max(temporal_variance, 0.0);
+    }
+    // The spread of the per-pixel means still holds 1/n of the temporal variance.
+    const double mean_variance = totals.sum_of_squared_sums / (n * n * pixels) - level.mean * level.mean;
+    level.temporal_noise = std::sqrt(temporal_variance);
+    level.fixed_pattern_noise = std::sqrt(std::max(mean_variance - temporal_variance / n, 0.0));
+    return level;
+}
+
+} // namespace
+
+bool CalibrationStacker::Add(const RawFile& frame, std::ostream& log_stream) {
+    const cv::Mat active = frame.GetActiveRawImage();
+    if (active.empty() || active.type() != CV_16UC1) {
+        log_stream << _("[FATAL ERROR] Could not read direct raw sensor data from file: ") << frame.GetFilename() << std::endl;
+        return false;
+    }
+
+    if (m_frame_count == 0) {
+        m_rows = active.rows;
+        m_cols = active.cols;
+        m_period = GetCfaTileSites(frame, m_sites, m_has_g2);
+        m_sums.assign(static_cast<size_t>(m_rows) * m_cols, 0);
+        m_square_sums.fill(WideSum{});
+    } else if (active.rows != m_rows || active.cols != m_cols) {
+        log_stream << _("[ERROR] Calibration frame size differs from the first frame: ") << frame.GetFilename() << std::endl;
+        return false;
+    } else if (m_frame_count >= MAX_STACKED_FRAMES) {
+        log_stream << _("[ERROR] Too many calibration frames to stack; ignoring: ") << frame.GetFilename() << std::endl;
+        return false;
+    }
+
+    // Unknown layouts accumulate with period 2; only their overall level is reported.
+    // One frame's squares fit 64 bits (up to 2^32 pixels per position); they are
+    // added to the 128-bit totals once per frame.
+    const int period = m_period > 0 ? m_period : 2;
+    std::array<uint64_t, 36> frame_squares{};
+    for (int r = 0; r < m_rows; ++r) {
+        const uint16_t* src = active.ptr<uint16_t>(r);
+        uint32_t* sums = m_sums.data() + static_cast<size_t>(r) * m_cols;
+        uint64_t* row_squares = frame_squares.data() + (r % period) * period;
+        if (period == 2) {
+            AccumulateRowPeriod2(src, sums, m_cols, row_squares[0], row_squares[1]);
+        } else {
+            for (int c = 0, phase = 0; c < m_cols; ++c) {
+                const uint64_t value = src[c];
+                sums[c] += static_cast<uint32_t>(value);
+                row_squares[phase] += value * value;
+                if (++phase == period) phase = 0;
+            }
+        }
+    }
+    for (int position = 0; position < period * period; ++position) {
+        m_square_sums[position].Add(frame_squares[position]);
+    }
+    ++m_frame_count;
+    return true;
+}
+
+std::optional<StackedCalibrationFrames> CalibrationStacker::Finish() const {
+    if (m_frame_count == 0) return std::nullopt;
+
+    const int period = m_period > 0 ? m_period : 2;
+    std::array<GroupTotals, 4> channel_totals;
+    std::array<RawHistogram, 4> channel_means;
+    for (int r = 0; r < m_rows; ++r) {
+        const uint32_t* sums = m_sums.data() + static_cast<size_t>(r) * m_cols;
+        const int* row_sites = m_sites.data() + (r % period) * period;
+        for (int c = 0, phase = 0; c < m_cols; ++c) {
+            const int site = m_period > 0 ? row_sites[phase] : 0;
+            GroupTotals& totals = channel_totals[site];
+            const uint64_t sum = sums[c];
+            ++totals.pixel_count;
+            totals.sum += sum;
+            totals.sum_of_squared_sums += static_cast<double>(sum) * static_cast<double>(sum);
+            const uint64_t rounded_mean = (sum + m_frame_count / 2) / m_frame_count;
+            ++channel_means[site].GetBins()[std::min<uint64_t>(rounded_mean, RawHistogram::BIN_COUNT - 1)];
+            if (++phase == period) phase = 0;
+        }
+    }
+    for (int position = 0; position < period * period; ++position) {
+        const int site = m_period > 0 ? m_sites[position] : 0;
+        channel_totals[site].square_sum += m_square_sums[position].ToDouble();
+    }
+
+    StackedCalibrationFrames result;
+    result.frame_count = m_frame_count;
+    GroupTotals all_totals;
+    RawHistogram all_means;
+    for (size_t site = 0; site < 4; ++site) {
+        all_totals.pixel_count += channel_totals[site].pixel_count;
+        all_totals.sum += channel_totals[site].sum;
+        all_totals.sum_of_squared_sums += channel_totals[site].sum_of_squared_sums;
+        all_totals.square_sum += channel_totals[site].square_sum;
+        all_means.Merge(channel_means[site]);
+    }
+    result.all = ToStackedLevel(all_totals, all_means, m_frame_count);
+    if (m_period > 0) {
+        std::array<StackedLevel, 4> channels;
+        for (size_t site = 0; site < 4; ++site) {
+            channels[site] = ToStackedLevel(channel_totals[site], channel_means[site], m_frame_count);
+        }
+        if (!m_has_g2) {
+            channels[2] = channels[1];
+        }
+        result.channels = channels;
+    }
+    return result;
+}
+
+std::optional<StackedCalibrationFrames> StackCalibrationFrames(const std::vector<std::string>& filenames, std::ostream& log_stream) {
+    if (filenames.empty()) return std::nullopt;
+
+    // Frames decode concurrently; folding them in is a short serialized pass.
+    // Each pool thread holds at most one decoded frame, so memory does not grow
+    // with the number of frames.
+    CalibrationStacker stacker;
+    std::mutex stacker_mutex;
+    std::vector<std::ostringstream> frame_logs(filenames.size());
+    std::vector<char> frame_ok(filenames.size(), 0);
+    DynaRange::Utils::ThreadPool::Shared().ParallelFor(filenames.size(), [&](size_t index) {
+        RawFile frame(filenames[index]);
+        if (!frame.Load()) {
+            frame_logs[index] << _("[ERROR] Could not load calibration frame: ") << filenames[index] << std::endl;
+            return;
+        }
+        std::lock_guard<std::mutex> lock(stacker_mutex);
+        frame_ok[index] = stacker.Add(frame, frame_logs[index]) ? 1 : 0;
+    });
+
+    bool all_ok = true;
+    for (size_t index = 0; index < filenames.size(); ++index) {
+        log_stream << frame_logs[index].str();
+        all_ok = all_ok && frame_ok[index];
+    }
+    if (!all_ok) return std::nullopt;
+    return stacker.Finish();
+}
@@ -0,0 +1,103 @@
+// File: src/core/analysis/CalibrationStacker.hpp
+/**
+ * @file src/core/analysis/CalibrationStacker.hpp
+ * @brief Declares the streaming stacker of dark and saturation calibration frames.
+ * @details Frames are folded one at a time into a per-pixel uint32 sum plus the sum of
+ * squares of each CFA tile position, so memory stays at four bytes per pixel whatever
+ * the number of frames. The per-pixel sums give the stacked level and the spread of
+ * the per-pixel means (fixed pattern); the sums of squares give the frame-to-frame
+ * (temporal) noise.
+ *
+ * The sums of squares are kept in 128 bits: a single frame fits 64 bits, but a stack
+ * of saturated frames from a large sensor does not.
+ */
+#pragma once
+
+#include "RawHistogram.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class RawFile;
+
+/**
+ * @struct StackedLevel
+ * @brief The level and noise split of a group of stacked pixels.
+ */
+struct StackedLevel {
+    double mean = 0.0;                ///< Mean of every sample of every frame.
+    double median = 0.0;              ///< Median of the per-pixel means, rounded to raw units.
+    double temporal_noise = 0.0;      ///< Frame-to-frame standard deviation (RMS over pixels); 0 with a single frame.
+    double fixed_pattern_noise = 0.0; ///< Standard deviation of the per-pixel means, with the temporal part removed.
+};
+
+/**
+ * @struct StackedCalibrationFrames
+ * @brief The result of stacking calibration frames.
+ */
+struct StackedCalibrationFrames {
+    int frame_count = 0;                             ///< Number of frames stacked.
+    StackedLevel all;                                ///< Every pixel of the active area.
+    std::optional<std::array<StackedLevel, 4>> channels; ///< Per CfaSite; nullopt if the layout is unknown. X-Trans repeats G1 as G2.
+};
+
+/**
+ * @class CalibrationStacker
+ * @brief Accumulates calibration frames of identical geometry.
+ * @details Add() is not thread-safe; callers decoding frames in parallel serialize it.
+ */
+class CalibrationStacker {
+public:
+    /**
+     * @brief Folds the active area of a loaded frame into the accumulators.
+     * @details The first frame fixes the geometry and CFA layout; frames that differ
+     * are rejected.
+     * @param frame The loaded RAW file.
+     * @param log_stream Stream for logging messages.
+     * @return true if the frame was added.
+     */
+    bool Add(const RawFile& frame, std::ostream& log_stream);
+
+    /// @brief Gets the number of frames added.
+    int GetFrameCount() const { return m_frame_count; }
+
+    /**
+     * @brief Computes the stacked levels and noise split.
+     * @return The result, or std::nullopt if no frame was added.
+     */
+    std::optional<StackedCalibrationFrames> Finish() const;
+
+private:
+    /// An unsigned 128-bit sum, as two 64-bit words.
+    struct WideSum {
+        uint64_t low = 0;
+        uint64_t high = 0;
+
+        void Add(uint64_t value) {
+            low += value;
+            if (low < value) ++high;
+        }
+        double ToDouble() const { return static_cast<double>(high) * 18446744073709551616.0 + static_cast<double>(low); }
+    };
+
+    int m_rows = 0;
+    int m_cols = 0;
+    int m_period = 0;                 ///< CFA tile period, or 0 if unknown.
+    bool m_has_g2 = true;
+    CfaTileSites m_sites{};
+    int m_frame_count = 0;
+    std::vector<uint32_t> m_sums;     ///< Per-pixel sum over frames.
+    std::array<WideSum, 36> m_square_sums{}; ///< Sum of squares per tile position, over pixels and frames.
+};
+
+/**
+ * @brief Decodes calibration frames in parallel and stacks them.
+ * @details At most one decoded frame per pool thread is held at a time.
+ * @param filenames Paths to the RAW frames.
+ * @param log_stream Stream for logging messages.
+ * @return The stacked result, or std::nullopt if any frame could not be used.
+ */
+std::optional<StackedCalibrationFrames> StackCalibrationFrames(const std::vector<std::string>& filenames, std::ostream& log_stream);
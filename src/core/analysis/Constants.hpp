@@ -19,4 +19,17 @@ namespace DynaRange::Analysis::Constants {
      */
     constexpr double MAX_SATURATION_RATIO = 0.01;
 
+    /**
+     * @brief Largest per-patch difference (normalized units) between sampling engines reported as a match.
+     * @details Both engines read the same samples, so only float rounding is tolerated.
+     */
+    constexpr double PATCH_SAMPLING_TOLERANCE = 1e-6;
+
+    /**
+     * @brief Largest difference between the fused patch statistics and a cv::meanStdDev() reference.
+     * @details Absolute for the mean, relative for the standard deviation. The reference is
+     * taken around the first pixel, so it does not lose digits on bright, quiet patches.
+     */
+    constexpr double PATCH_STATISTICS_TOLERANCE = 1e-9;
+
 } // namespace DynaRange::Analysis::Constants
\ No newline at end of file
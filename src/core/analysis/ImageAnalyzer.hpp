@@ -7,9 +7,75 @@
 
 #include <opencv2/core.hpp>
 #include "../analysis/Analysis.hpp"
+#include "PatchSamplingPlan.hpp"
+#include <functional>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Gives the pixels (CV_32FC1) of a patch rectangle given in crop coordinates.
+ */
+using PatchSampler = std::function<cv::Mat(const cv::Rect&)>;
+
+/**
+ * @struct RawPatchLevels
+ * @brief Normalization of patches sampled as raw uint16 values.
+ * @details Given to the measurement functions when the sampler returns CV_16UC1 raw
+ * pixels instead of normalized CV_32FC1 ones; the levels are then applied only to the
+ * final statistics.
+ */
+struct RawPatchLevels {
+    double black_level;      ///< Raw value mapped to 0.
+    double saturation_level; ///< Raw value mapped to 1.
+};
+
+/**
+ * @struct PatchMeasurement
+ * @brief The measurement of one patch, before any acceptance threshold is applied.
+ */
+struct PatchMeasurement {
+    cv::Rect rect;           ///< Sampled rectangle in crop coordinates.
+    double signal;           ///< Mean (or truncated-normal estimate when black clipping is detected).
+    double noise;            ///< Standard deviation (or its truncated-normal estimate).
+    double saturation_ratio; ///< Fraction of saturated pixels.
+};
+
+/**
+ * @brief Measures every patch of the grid once, without applying any SNR threshold.
+ * @details Patches whose truncated-normal estimation fails are left out. The patches
+ * are measured in parallel on the shared ThreadPool, so the sampler must be safe to
+ * call concurrently.
+ * @param plan The patch rectangles to sample (see ChartProfile::GetSamplingPlan()).
+ * @param sample_patch Gives the pixels of each patch rectangle.
+ * @param dark_value The calibrated black level of the sensor, used for special filtering.
+ * @param raw_levels If set, the sampler returns raw CV_16UC1 pixels, measured with exact
+ *        integer sums (see ComputeIntegerPatchStatistics()) and normalized with these levels.
+ * @return The measurements, in row-major grid order.
+ */
+std::vector<PatchMeasurement> MeasurePatches(const PatchSamplingPlan& plan, const PatchSampler& sample_patch, double dark_value,
+                                             const std::optional<RawPatchLevels>& raw_levels = std::nullopt);
+
+/**
+ * @brief Measures every patch of a cropped chart image once.
+ * @details If the image size does not match the plan, the plan is recompiled for it.
+ * @see The sampler overload.
+ */
+std::vector<PatchMeasurement> MeasurePatches(const cv::Mat& imgcrop, const PatchSamplingPlan& plan, double dark_value);
+
+/**
+ * @brief Selects the measured patches that pass an SNR threshold and are not saturated.
+ * @details Cheap enough to be applied once per candidate threshold.
+ * @param measurements The table from MeasurePatches().
+ * @param min_snr_db The minimum SNR in dB for a patch to be considered valid.
+ * @param overlay_base If not empty, a copy of it with the accepted patches outlined
+ *        is returned in PatchAnalysisResult::image_with_patches.
+ * @return A PatchAnalysisResult struct containing the signal and noise vectors.
+ */
+PatchAnalysisResult FilterPatches(const std::vector<PatchMeasurement>& measurements, double min_snr_db, const cv::Mat& overlay_base = cv::Mat());
 
 /**
  * @brief Analyzes a cropped chart image to find patches and measure their signal and noise.
+ * @details Equivalent to FilterPatches(MeasurePatches(...)).
  * @param imgcrop The input image, corrected for geometry and cropped to the chart area.
  * @param NCOLS The number of columns in the patch grid.
  * @param NROWS The number of rows in the patch grid.
@@ -19,4 +85,4 @@
  * @param dark_value The calibrated black level of the sensor, used for special filtering.
  * @return A PatchAnalysisResult struct containing the signal and noise vectors.
  */
-PatchAnalysisResult AnalyzePatches(cv::Mat imgcrop, int NCOLS, int NROWS, double patch_ratio, bool create_overlay_image, double min_snr_db, double dark_value);
\ No newline at end of file
+PatchAnalysisResult AnalyzePatches(cv::Mat imgcrop, int NCOLS, int NROWS, double patch_ratio, bool create_overlay_image, double min_snr_db, double dark_value);
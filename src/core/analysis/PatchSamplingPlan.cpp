@@ -0,0 +1,41 @@
+// File: src/core/analysis/PatchSamplingPlan.cpp
+/**
+ * @file src/core/analysis/PatchSamplingPlan.cpp
+ * @brief Implements the compilation of the patch sampling plan.
+ */
+#include "PatchSamplingPlan.hpp"
+#include <cmath>
+
+PatchSamplingPlan CompilePatchSamplingPlan(cv::Size crop_size, int grid_cols, int grid_rows, double patch_ratio) {
+    PatchSamplingPlan plan;
+    plan.crop_size = crop_size;
+    plan.grid_cols = grid_cols;
+    plan.grid_rows = grid_rows;
+    plan.patch_ratio = patch_ratio;
+    if (crop_size.width <= 0 || crop_size.height <= 0 || grid_cols <= 0 || grid_rows <= 0) {
+        return plan;
+    }
+
+    const double patch_width_float = static_cast<double>(crop_size.width) / grid_cols;
+    const double patch_height_float = static_cast<double>(crop_size.height) / grid_rows;
+    const double safe_x = patch_width_float * (1.0 - patch_ratio) / 2.0;
+    const double safe_y = patch_height_float * (1.0 - patch_ratio) / 2.0;
+
+    plan.spans.reserve(static_cast<size_t>(grid_cols) * grid_rows);
+    for (int j = 0; j < grid_rows; j++) {
+        const int y1 = static_cast<int>(round(static_cast<double>(j) * patch_height_float + safe_y));
+        const int y2 = static_cast<int>(round(static_cast<double>(j + 1) * patch_height_float - safe_y));
+        for (int i = 0; i < grid_cols; i++) {
+            const int x1 = static_cast<int>(round(static_cast<double>(i) * patch_width_float + safe_x));
+            const int x2 = static_cast<int>(round(static_cast<double>(i + 1) * patch_width_float - safe_x));
+
+            if (x1 >= x2 || y1 >= y2) continue;
+            if (x1 < 0 || y1 < 0 || x2 > crop_size.width || y2 > crop_size.height) continue;
+
+            const int width = x2 - x1;
+            const int height = y2 - y1;
+            plan.spans.push_back({x1, y1, width, height, width * height, j * grid_cols + i});
+        }
+    }
+    return plan;
+}
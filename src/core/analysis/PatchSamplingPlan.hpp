@@ -0,0 +1,50 @@
+// File: src/core/analysis/PatchSamplingPlan.hpp
+/**
+ * @file src/core/analysis/PatchSamplingPlan.hpp
+ * @brief Declares the precomputed sampling geometry of the chart patch grid.
+ * @details The grid geometry only depends on the chart area, the grid size and the
+ * patch ratio, which are fixed for a whole series; it is compiled once (see
+ * ChartProfile::GetSamplingPlan()) and shared by every channel, file and pass.
+ */
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @struct PatchSpan
+ * @brief The sampled rectangle of one patch, in crop coordinates.
+ * @details Rows y .. y + height - 1 are each sampled from column x over width pixels.
+ */
+struct PatchSpan {
+    int x;
+    int y;
+    int width;
+    int height;
+    int pixel_count; ///< width * height.
+    int grid_index;  ///< Row-major index of the patch in the chart grid.
+
+    cv::Rect GetRect() const { return cv::Rect(x, y, width, height); }
+};
+
+/**
+ * @struct PatchSamplingPlan
+ * @brief The patches that can be sampled, as one contiguous array in row-major grid order.
+ */
+struct PatchSamplingPlan {
+    cv::Size crop_size;            ///< Size of the chart area the grid is laid over.
+    int grid_cols = 0;             ///< Number of columns in the patch grid.
+    int grid_rows = 0;             ///< Number of rows in the patch grid.
+    double patch_ratio = 0.0;      ///< Relative area of the center of each patch that is sampled.
+    std::vector<PatchSpan> spans;  ///< Patches large enough to sample and inside the chart area.
+};
+
+/**
+ * @brief Compiles the sampling plan of a patch grid.
+ * @param crop_size The size of the chart area.
+ * @param grid_cols The number of columns in the patch grid.
+ * @param grid_rows The number of rows in the patch grid.
+ * @param patch_ratio The relative area of the center of each patch to sample.
+ * @return The plan; patches too small to sample are left out.
+ */
+PatchSamplingPlan CompilePatchSamplingPlan(cv::Size crop_size, int grid_cols, int grid_rows, double patch_ratio);
@@ -0,0 +1,110 @@
+// File: src/core/analysis/PatchStatistics.cpp
+/**
+ * @file src/core/analysis/PatchStatistics.cpp
+ * @brief Implements the fused patch statistics kernel.
+ */
+#include "PatchStatistics.hpp"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cmath>
+
+PatchStatistics ComputePatchStatistics(const cv::Mat& roi, float saturation_threshold) {
+    PatchStatistics stats;
+    if (roi.empty() || roi.type() != CV_32FC1) {
+        return stats;
+    }
+
+    // Moments are taken around the first pixel: for a bright, quiet patch E[x^2] and
+    // E[x]^2 are nearly equal, and subtracting them would cancel most significant digits.
+    const double shift = roi.at<float>(0, 0);
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    int zero_count = 0;
+    int saturated_count = 0;
+    for (int r = 0; r < roi.rows; ++r) {
+        const float* src = roi.ptr<float>(r);
+        int c = 0;
+#if CV_SIMD128_64F
+        const cv::v_float64x2 v_shift = cv::v_setall_f64(shift);
+        const cv::v_float32x4 v_zero = cv::v_setzero_f32();
+        const cv::v_float32x4 v_threshold = cv::v_setall_f32(saturation_threshold);
+        cv::v_float64x2 v_sum = cv::v_setzero_f64(), v_sum_sq = cv::v_setzero_f64();
+        // Comparison masks are all ones (-1 as int), so subtracting them counts matches.
+        cv::v_int32x4 v_zero_count = cv::v_setzero_s32(), v_saturated_count = cv::v_setzero_s32();
+        for (; c <= roi.cols - cv::v_float32x4::nlanes; c += cv::v_float32x4::nlanes) {
+            const cv::v_float32x4 v = cv::v_load(src + c);
+            const cv::v_float64x2 low = cv::v_cvt_f64(v) - v_shift;
+            const cv::v_float64x2 high = cv::v_cvt_f64_high(v) - v_shift;
+            v_sum = v_sum + low + high;
+            v_sum_sq = v_sum_sq + low * low + high * high;
+            v_zero_count = v_zero_count - cv::v_reinterpret_as_s32(v == v_zero);
+            v_saturated_count = v_saturated_count - cv::v_reinterpret_as_s32(v > v_threshold);
+        }
+        sum += cv::v_reduce_sum(v_sum);
+        sum_sq += cv::v_reduce_sum(v_sum_sq);
+        zero_count += cv::v_reduce_sum(v_zero_count);
+        saturated_count += cv::v_reduce_sum(v_saturated_count);
+#endif
+        for (; c < roi.cols; ++c) {
+            const double value = src[c] - shift;
+            sum += value;
+            sum_sq += value * value;
+            zero_count += (src[c] == 0.0f) ? 1 : 0;
+            saturated_count += (src[c] > saturation_threshold) ? 1 : 0;
+        }
+    }
+
+    stats.count = roi.total();
+    // A float minus another float is exact in double, so the shift costs no precision.
+    const double shifted_mean = sum / static_cast<double>(stats.count);
+    const double variance = sum_sq / static_cast<double>(stats.count) - shifted_mean * shifted_mean;
+    stats.mean = shift + shifted_mean;
+    stats.stddev = std::sqrt(std::max(variance, 0.0));
+    stats.zero_count = zero_count;
+    stats.saturated_count = saturated_count;
+    return stats;
+}
+
+PatchStatistics ComputeIntegerPatchStatistics(const cv::Mat& roi, double black_level, double saturation_level, float saturation_threshold) {
+    PatchStatistics stats;
+    if (roi.empty() || roi.type() != CV_16UC1) {
+        return stats;
+    }
+
+    // Raw-domain equivalents of the normalized thresholds.
+    const double range = saturation_level - black_level;
+    const double raw_saturation_threshold = black_level + static_cast<double>(saturation_threshold) * range;
+
+    // Moments are taken around the first pixel, as in ComputePatchStatistics(). The
+    // shifted values fit in 17 bits, so a uint64 sum of squares overflows only past 2^32 pixels.
+    const int64_t shift = roi.at<uint16_t>(0, 0);
+    int64_t sum = 0;
+    uint64_t sum_sq = 0;
+    int zero_count = 0;
+    int saturated_count = 0;
+    for (int r = 0; r < roi.rows; ++r) {
+        const uint16_t* src = roi.ptr<uint16_t>(r);
+        int64_t row_sum = 0;
+        uint64_t row_sum_sq = 0;
+        for (int c = 0; c < roi.cols; ++c) {
+            const uint32_t value = src[c];
+            const int64_t delta = static_cast<int64_t>(value) - shift;
+            row_sum += delta;
+            row_sum_sq += static_cast<uint64_t>(delta * delta);
+            zero_count += (value <= black_level) ? 1 : 0;
+            saturated_count += (value > raw_saturation_threshold) ? 1 : 0;
+        }
+        sum += row_sum;
+        sum_sq += row_sum_sq;
+    }
+
+    stats.count = roi.total();
+    const double n = static_cast<double>(stats.count);
+    const double shifted_mean = static_cast<double>(sum) / n;
+    const double raw_variance = static_cast<double>(sum_sq) / n - shifted_mean * shifted_mean;
+    stats.mean = (static_cast<double>(shift) + shifted_mean - black_level) / range;
+    stats.stddev = std::sqrt(std::max(raw_variance, 0.0)) / range;
+    stats.zero_count = zero_count;
+    stats.saturated_count = saturated_count;
+    return stats;
+}
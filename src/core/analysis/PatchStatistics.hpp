@@ -0,0 +1,53 @@
+// File: src/core/analysis/PatchStatistics.hpp
+/**
+ * @file src/core/analysis/PatchStatistics.hpp
+ * @brief Declares the fused statistics kernel used to measure chart patches.
+ */
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct PatchStatistics
+ * @brief First and second moments of a patch plus its clipped-pixel counts.
+ */
+struct PatchStatistics {
+    size_t count = 0;           ///< Number of pixels.
+    double mean = 0.0;          ///< Mean value.
+    double stddev = 0.0;        ///< Population standard deviation, as cv::meanStdDev().
+    int zero_count = 0;         ///< Pixels exactly equal to 0.
+    int saturated_count = 0;    ///< Pixels strictly above the saturation threshold.
+};
+
+/**
+ * @brief Measures a patch in a single vectorized pass, without allocating.
+ * @details Replaces cv::meanStdDev() plus two countNonZero() calls over comparison
+ * masks. Sums of the values and of their squares are accumulated in double
+ * precision around the first pixel, so the variance does not suffer the
+ * cancellation of E[x^2] - E[x]^2 on bright, quiet patches (cv::meanStdDev() does).
+ * The relative error of the standard deviation is then about count * 2^-53 (under
+ * 1e-9 for any patch the analysis uses), and the mean matches cv::meanStdDev() up
+ * to summation order; the counts are exact.
+ * @param roi The patch pixels (CV_32FC1; may be a non-continuous view).
+ * @param saturation_threshold Pixels above this value are counted as saturated.
+ * @return The statistics; all zero for an empty or non-CV_32FC1 input.
+ */
+PatchStatistics ComputePatchStatistics(const cv::Mat& roi, float saturation_threshold);
+
+/**
+ * @brief Measures a raw uint16 patch with exact integer accumulation.
+ * @details Sums and sums of squares around the first pixel are accumulated in 64-bit
+ * integers, so they do not depend on summation order, vector width or compiler, and
+ * the variance is formed from well-conditioned values; black and saturation
+ * normalization is applied only to the final mean and standard deviation. A pixel
+ * counts as zero when it is at or below the black level, and as saturated when its
+ * normalized value would be above the threshold.
+ * @param roi The raw patch pixels (CV_16UC1; may be a non-continuous view).
+ * @param black_level The black level subtracted from the mean.
+ * @param saturation_level The saturation level; (saturation - black) is the normalization scale.
+ * @param saturation_threshold Normalized level above which pixels are counted as saturated.
+ * @return The normalized statistics; all zero for an empty or non-CV_16UC1 input.
+ */
+PatchStatistics ComputeIntegerPatchStatistics(const cv::Mat& roi, double black_level, double saturation_level, float saturation_threshold);
@@ -0,0 +1,120 @@
+// File: src/core/analysis/RawHistogram.cpp
+/**
+ * @file src/core/analysis/RawHistogram.cpp
+ * @brief Implements the counting histogram of 16-bit raw values.
+ */
+#include "RawHistogram.hpp"
+#include "../io/raw/CfaTable.hpp"
+#include "../io/raw/RawFile.hpp"
+#include "../utils/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+
+RawHistogram::RawHistogram() : m_bins(BIN_COUNT, 0) {}
+
+void RawHistogram::Merge(const RawHistogram& other) {
+    for (size_t value = 0; value < BIN_COUNT; ++value) {
+        m_bins[value] += other.m_bins[value];
+    }
+}
+
+uint64_t RawHistogram::GetCount() const {
+    uint64_t count = 0;
+    for (uint64_t bin : m_bins) count += bin;
+    return count;
+}
+
+double RawHistogram::GetMean() const {
+    // 65535 * 2^32 pixels still fits a uint64 sum.
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    for (size_t value = 0; value < BIN_COUNT; ++value) {
+        count += m_bins[value];
+        sum += m_bins[value] * value;
+    }
+    return count > 0 ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+}
+
+double RawHistogram::GetQuantile(double percentile) const {
+    const uint64_t count = GetCount();
+    if (count == 0) return 0.0;
+    uint64_t index = static_cast<uint64_t>(static_cast<double>(count) * percentile);
+    index = std::min(index, count - 1);
+    uint64_t cumulative = 0;
+    for (size_t value = 0; value < BIN_COUNT; ++value) {
+        cumulative += m_bins[value];
+        if (cumulative > index) return static_cast<double>(value);
+    }
+    return static_cast<double>(BIN_COUNT - 1);
+}
+
+int GetCfaTileSites(const RawFile& file, CfaTileSites& sites, bool& has_g2) {
+    using namespace DynaRange::IO::Raw;
+    if (const auto pattern = file.GetCfaPattern()) {
+        for (CfaSite site : {CfaSite::R, CfaSite::G1, CfaSite::G2, CfaSite::B}) {
+            const CfaOffsets offsets = GetCfaOffsets(*pattern, site);
+            sites[offsets.row * 2 + offsets.col] = static_cast<int>(site);
+        }
+        has_g2 = true;
+        return 2;
+    }
+    const std::string layout = file.GetCfaLayout();
+    if (layout.size() != static_cast<size_t>(MAX_CFA_PERIOD * MAX_CFA_PERIOD)) {
+        return 0;
+    }
+    for (size_t i = 0; i < layout.size(); ++i) {
+        switch (layout[i]) {
+            case 'R': case 'r': sites[i] = static_cast<int>(CfaSite::R); break;
+            case 'G': case 'g': sites[i] = static_cast<int>(CfaSite::G1); break;
+            case 'B': case 'b': sites[i] = static_cast<int>(CfaSite::B); break;
+            default: return 0;
+        }
+    }
+    has_g2 = false;
+    return MAX_CFA_PERIOD;
+}
+
+std::optional<CfaHistograms> ComputeCfaHistograms(const RawFile& file) {
+    using namespace DynaRange::IO::Raw;
+    std::array<BayerPlaneView, 4> planes;
+    for (int row = 0; row < 2; ++row) {
+        for (int col = 0; col < 2; ++col) {
+            planes[BayerPlaneIndex(row, col)] = file.GetBayerPlaneView({row, col});
+            if (planes[BayerPlaneIndex(row, col)].empty()) return std::nullopt;
+        }
+    }
+
+    CfaHistograms result;
+    CfaTileSites sites{};
+    const int period = GetCfaTileSites(file, sites, result.has_g2);
+    result.has_channels = period > 0;
+
+    // Each channel is counted by its own task, straight into its histogram: a Bayer
+    // channel reads one position plane, an X-Trans channel the columns of each plane
+    // whose tile phase holds its color. Every pixel belongs to exactly one channel.
+    DynaRange::Utils::ThreadPool::Shared().ParallelFor(4, [&](size_t channel) {
+        uint64_t* bins = result.channels[channel].GetBins();
+        const int phases = period > 0 ? period / 2 : 1;
+        for (int plane_row = 0; plane_row < 2; ++plane_row) {
+            for (int plane_col = 0; plane_col < 2; ++plane_col) {
+                const BayerPlaneView& plane = planes[BayerPlaneIndex(plane_row, plane_col)];
+                for (int r = 0; r < plane.rows; ++r) {
+                    const int tile_row = period > 0 ? (2 * r + plane_row) % period : 0;
+                    const uint16_t* src = plane.data + r * plane.row_step;
+                    for (int phase = 0; phase < phases; ++phase) {
+                        const int site = period > 0 ? sites[tile_row * period + (2 * phase + plane_col) % period] : 0;
+                        if (site != static_cast<int>(channel)) continue;
+                        for (int c = phase; c < plane.cols; c += phases) {
+                            ++bins[src[c * plane.col_step]];
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    for (const auto& channel : result.channels) {
+        result.all.Merge(channel);
+    }
+    return result;
+}
@@ -0,0 +1,94 @@
+// File: src/core/analysis/RawHistogram.hpp
+/**
+ * @file src/core/analysis/RawHistogram.hpp
+ * @brief Declares the counting histogram of 16-bit raw values used for calibration frames.
+ * @details A raw value has at most 65536 levels, so one counting pass gives the exact
+ * mean, median and any quantile of a frame in O(65536) memory, without copying or
+ * sorting its pixels.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+class RawFile;
+
+/**
+ * @class RawHistogram
+ * @brief Counts of every 16-bit raw value.
+ */
+class RawHistogram {
+public:
+    /// Number of bins: one per 16-bit value.
+    static constexpr size_t BIN_COUNT = 65536;
+
+    RawHistogram();
+
+    /// @brief Gets the bins, for counting loops.
+    uint64_t* GetBins() { return m_bins.data(); }
+
+    /// @brief Adds the counts of another histogram.
+    void Merge(const RawHistogram& other);
+
+    /// @brief Gets the number of values counted.
+    uint64_t GetCount() const;
+
+    /**
+     * @brief Gets the exact mean of the values counted.
+     * @return The mean, or 0 if the histogram is empty.
+     */
+    double GetMean() const;
+
+    /**
+     * @brief Gets a quantile of the values counted.
+     * @details The value at sorted index floor(count * percentile), clamped to the last
+     * one: the same element CalculateQuantile() selects.
+     * @param percentile The quantile to get, in [0, 1].
+     * @return The quantile, or 0 if the histogram is empty.
+     */
+    double GetQuantile(double percentile) const;
+
+    /// @brief Gets the median of the values counted (see GetQuantile()).
+    double GetMedian() const { return GetQuantile(0.5); }
+
+private:
+    std::vector<uint64_t> m_bins;
+};
+
+/**
+ * @struct CfaHistograms
+ * @brief The histograms of a frame's active area, as a whole and per CFA channel.
+ */
+struct CfaHistograms {
+    RawHistogram all;                    ///< Every pixel of the active area.
+    std::array<RawHistogram, 4> channels; ///< Pixels of each channel, indexed by CfaSite.
+    bool has_channels = false;           ///< False if the CFA layout is unknown (only `all` is filled).
+    bool has_g2 = true;                  ///< False for layouts without a second green site (X-Trans: all greens are G1).
+};
+
+/// The channel (CfaSite index) of every pixel of a CFA tile (up to 6x6), in raster order.
+using CfaTileSites = std::array<int, 36>;
+
+/**
+ * @brief Gets the channel of every pixel of a file's CFA tile.
+ * @details Bayer layouts map to their four sites; the 6x6 X-Trans tile maps its
+ * colors to R, G1 and B.
+ * @param file The loaded RAW file.
+ * @param sites Receives the channel of each tile pixel, row-major with the tile's period.
+ * @param has_g2 Receives whether the layout has a second green site.
+ * @return The period of the tile, or 0 if the layout is unknown.
+ */
+int GetCfaTileSites(const RawFile& file, CfaTileSites& sites, bool& has_g2);
+
+/**
+ * @brief Counts the active area of a RAW file, reading each pixel once.
+ * @details The four position planes are read in place; the channels are counted
+ * concurrently, each straight into its own histogram, so no partial histograms are
+ * allocated. The pixels of a trailing odd row or column of the active area are not counted.
+ * @param file The loaded RAW file.
+ * @return The histograms, or std::nullopt if the pixel data is not available.
+ */
+std::optional<CfaHistograms> ComputeCfaHistograms(const RawFile& file);
@@ -5,91 +5,175 @@
  * calibration.
  */
 #include "RawProcessor.hpp"
+#include "CalibrationStacker.hpp"
+#include "RawHistogram.hpp"
 #include "../io/raw/RawFile.hpp"
-#include "../math/Math.hpp" // Para CalculateQuantile (ahora no usada) y CalculateMean (si existe)
 #include <iomanip>
 #include <iostream>
 #include <libintl.h>
-#include <opencv2/core.hpp> // *** NUEVO INCLUDE para cv::mean ***
-#include <numeric>         // *** NUEVO INCLUDE para std::accumulate (si CalculateMean no existe) ***
 
 #define _(string) gettext(string)
 
-std::optional<double> ProcessDarkFrame(const std::string &filename,
-                                       std::ostream &log_stream) {
-  log_stream << _("Calculating black level from: ") << filename << "..."
-             << std::endl;
-  RawFile dark_file(filename);
-  if (!dark_file.Load())
+namespace {
+
+/**
+ * @brief Loads a calibration frame and counts its active area.
+ * @return The histograms, or std::nullopt (with the reason logged) on failure.
+ */
+std::optional<CfaHistograms> LoadFrameHistograms(const std::string &filename,
+                                                 std::ostream &log_stream) {
+  RawFile file(filename);
+  if (!file.Load())
     return std::nullopt;
 
-  // Get the already-cropped active image directly.
-  cv::Mat active_img = dark_file.GetActiveRawImage();
-  if (active_img.empty()) {
+  auto histograms = ComputeCfaHistograms(file);
+  if (!histograms || histograms->all.GetCount() == 0) {
     log_stream << _("[FATAL ERROR] Could not read direct raw sensor data from file: ") << filename << std::endl;
     log_stream << _("  This is likely because the file is in a compressed RAW format (e.g., from a smartphone) that is not supported for calibration.") << std::endl;
     return std::nullopt;
   }
+  return histograms;
+}
 
-  // --- *** INICIO: CAMBIO DE MEDIANA A MEDIA *** ---
-  // Convertir la imagen a CV_64F para cálculo preciso de la media
-  cv::Mat active_img_double;
-  active_img.convertTo(active_img_double, CV_64F);
-
-  // Calcular la media de los píxeles del área activa
-  cv::Scalar mean_scalar = cv::mean(active_img_double);
-  double mean_value = mean_scalar[0]; // cv::mean devuelve un Scalar, tomamos el primer (y único) canal
-
-  /* --- CÓDIGO ANTERIOR (MEDIANA) COMENTADO ---
-  // Convert the active area to a vector to calculate the median.
-  std::vector<double> pixels;
-  pixels.reserve(active_img.total());
-  active_img.reshape(1, 1).convertTo(pixels, CV_64F);
-
-  // Calculate the median (quantile 0.5) on the active pixels.
-  // This is robust against hot pixels and correctly identifies a true zero black level.
-  double median_value = CalculateQuantile(pixels, 0.5);
-  if (median_value == 0.0 && cv::countNonZero(active_img) > 0) {
-      log_stream << _("[INFO] Zero black level detected, ignoring hot pixels.") << std::endl;
+/**
+ * @brief Measures a level on the whole frame and on each of its channels.
+ * @param measure Reads the level from one histogram (mean, median...).
+ */
+template <typename Measure>
+CalibrationFrameLevel MeasureFrameLevel(const CfaHistograms &histograms,
+                                        Measure measure) {
+  CalibrationFrameLevel result;
+  result.level = measure(histograms.all);
+  if (histograms.has_channels) {
+    std::array<double, 4> levels{};
+    for (size_t site = 0; site < 4; ++site) {
+      levels[site] = measure(histograms.channels[site]);
+    }
+    if (!histograms.has_g2) {
+      levels[2] = levels[1];
+    }
+    result.channel_levels = levels;
   }
-  log_stream << _("Black level obtained (active area median): ") << std::fixed
-             << std::setprecision(2) << median_value << std::endl;
-  return median_value;
-  --- FIN CÓDIGO ANTERIOR --- */
+  return result;
+}
 
-  // Nueva salida de log indicando que se usa la media
-  log_stream << _("Black level obtained (active area mean): ") << std::fixed
-             << std::setprecision(2) << mean_value << std::endl;
-  return mean_value; // Devolver la media calculada
-  // --- *** FIN: CAMBIO DE MEDIANA A MEDIA *** ---
+void LogChannelLevels(const CalibrationFrameLevel &level,
+                      std::ostream &log_stream) {
+  if (!level.channel_levels)
+    return;
+  const auto &levels = *level.channel_levels;
+  log_stream << _("  Per channel (R, G1, G2, B): ") << std::fixed
+             << std::setprecision(2) << levels[0] << ", " << levels[1] << ", "
+             << levels[2] << ", " << levels[3] << std::endl;
 }
 
-// La función ProcessSaturationFrame no necesita cambios, ya usa mediana como R.
-std::optional<double> ProcessSaturationFrame(const std::string &filename,
-                                             std::ostream &log_stream) {
-  log_stream << _("Calculating saturation point from: ") << filename << "..."
+/**
+ * @brief Reduces a stack to a level, overall and per channel.
+ * @param select Reads the level from one stacked group (mean, median...).
+ */
+template <typename Select>
+CalibrationFrameLevel ToFrameLevel(const StackedCalibrationFrames &stack,
+                                   Select select) {
+  CalibrationFrameLevel result;
+  result.level = select(stack.all);
+  if (stack.channels) {
+    std::array<double, 4> levels{};
+    for (size_t site = 0; site < 4; ++site) {
+      levels[site] = select((*stack.channels)[site]);
+    }
+    result.channel_levels = levels;
+  }
+  return result;
+}
+
+void LogNoiseSplit(const StackedCalibrationFrames &stack,
+                   std::ostream &log_stream) {
+  log_stream << _("  Temporal noise: ") << std::fixed << std::setprecision(3)
+             << stack.all.temporal_noise << _(", fixed-pattern noise: ")
+             << stack.all.fixed_pattern_noise << std::endl;
+}
+
+/**
+ * @brief Announces and stacks several calibration frames.
+ * @return The stack, or std::nullopt (with the reason logged) on failure.
+ */
+std::optional<StackedCalibrationFrames>
+StackFrames(const std::vector<std::string> &filenames,
+            std::ostream &log_stream) {
+  log_stream << _("Stacking ") << filenames.size()
+             << _(" calibration frames...") << std::endl;
+  return StackCalibrationFrames(filenames, log_stream);
+}
+
+} // namespace
+
+std::optional<CalibrationFrameLevel> ProcessDarkFrame(const std::string &filename,
+                                                      std::ostream &log_stream) {
+  log_stream << _("Calculating black level from: ") << filename << "..."
              << std::endl;
-  RawFile sat_file(filename);
-  if (!sat_file.Load())
+  const auto histograms = LoadFrameHistograms(filename, log_stream);
+  if (!histograms)
     return std::nullopt;
 
-  // Get the already-cropped active image directly.
-  cv::Mat active_img = sat_file.GetActiveRawImage();
-  if (active_img.empty()) {
-    log_stream << _("[FATAL ERROR] Could not read direct raw sensor data from file: ") << filename << std::endl;
-    log_stream << _("  This is likely because the file is in a compressed RAW format (e.g., from a smartphone) that is not supported for calibration.") << std::endl;
-    return std::nullopt;
-  }
+  // Exact mean of the active area, from the counts of each raw value.
+  const CalibrationFrameLevel black = MeasureFrameLevel(
+      *histograms, [](const RawHistogram &h) { return h.GetMean(); });
+  log_stream << _("Black level obtained (active area mean): ") << std::fixed
+             << std::setprecision(2) << black.level << std::endl;
+  LogChannelLevels(black, log_stream);
+  return black;
+}
 
-  // Convert only the active area to a vector for quantile calculation.
-  std::vector<double> pixels;
-  pixels.reserve(active_img.total());
-  active_img.reshape(1, 1).convertTo(pixels, CV_64F);
+std::optional<CalibrationFrameLevel> ProcessSaturationFrame(const std::string &filename,
+                                                            std::ostream &log_stream) {
+  log_stream << _("Calculating saturation point from: ") << filename << "..."
+             << std::endl;
+  const auto histograms = LoadFrameHistograms(filename, log_stream);
+  if (!histograms)
+    return std::nullopt;
 
   // Calculate the median (quantile 0.5) on the active pixels only.
   // This is how R code doit.
-  double median_value = CalculateQuantile(pixels, 0.5);
+  const CalibrationFrameLevel saturation = MeasureFrameLevel(
+      *histograms, [](const RawHistogram &h) { return h.GetMedian(); });
   log_stream << _("Saturation point obtained (active area median): ") << std::fixed
-             << std::setprecision(2) << median_value << std::endl;
-  return median_value;
-}
\ No newline at end of file
+             << std::setprecision(2) << saturation.level << std::endl;
+  LogChannelLevels(saturation, log_stream);
+  return saturation;
+}
+
+std::optional<CalibrationFrameLevel>
+ProcessDarkFrames(const std::vector<std::string> &filenames,
+                  std::ostream &log_stream) {
+  if (filenames.size() == 1)
+    return ProcessDarkFrame(filenames.front(), log_stream);
+  const auto stack = StackFrames(filenames, log_stream);
+  if (!stack)
+    return std::nullopt;
+
+  const CalibrationFrameLevel black = ToFrameLevel(
+      *stack, [](const StackedLevel &level) { return level.mean; });
+  log_stream << _("Black level obtained (stacked mean): ") << std::fixed
+             << std::setprecision(2) << black.level << std::endl;
+  LogChannelLevels(black, log_stream);
+  LogNoiseSplit(*stack, log_stream);
+  return black;
+}
+
+std::optional<CalibrationFrameLevel>
+ProcessSaturationFrames(const std::vector<std::string> &filenames,
+                        std::ostream &log_stream) {
+  if (filenames.size() == 1)
+    return ProcessSaturationFrame(filenames.front(), log_stream);
+  const auto stack = StackFrames(filenames, log_stream);
+  if (!stack)
+    return std::nullopt;
+
+  const CalibrationFrameLevel saturation = ToFrameLevel(
+      *stack, [](const StackedLevel &level) { return level.median; });
+  log_stream << _("Saturation point obtained (stacked median): ") << std::fixed
+             << std::setprecision(2) << saturation.level << std::endl;
+  LogChannelLevels(saturation, log_stream);
+  LogNoiseSplit(*stack, log_stream);
+  return saturation;
+}
@@ -5,22 +5,60 @@
  */
 #pragma once
 
+#include <array>
 #include <string>
 #include <optional>
 #include <ostream>
+#include <vector>
+
+/**
+ * @struct CalibrationFrameLevel
+ * @brief A level measured on a calibration frame, overall and per CFA channel.
+ */
+struct CalibrationFrameLevel {
+    double level = 0.0; ///< Level of the whole active area.
+    /// Level of each channel, indexed by CfaSite; std::nullopt if the CFA layout is
+    /// unknown. Layouts without a second green site (X-Trans) repeat G1 as G2.
+    std::optional<std::array<double, 4>> channel_levels;
+};
 
 /**
  * @brief Processes a dark frame to determine the camera's black level.
+ * @details The level is the exact mean of the active area, computed from a single
+ * counting pass per CFA channel (see ComputeCfaHistograms()).
  * @param filename Path to the dark frame RAW file.
  * @param log_stream Stream for logging messages.
  * @return An optional containing the calculated black level, or std::nullopt on failure.
  */
-std::optional<double> ProcessDarkFrame(const std::string& filename, std::ostream& log_stream);
+std::optional<CalibrationFrameLevel> ProcessDarkFrame(const std::string& filename, std::ostream& log_stream);
 
 /**
  * @brief Processes a saturated frame to determine the camera's saturation point.
+ * @details The level is the exact median of the active area, computed from a single
+ * counting pass per CFA channel (see ComputeCfaHistograms()).
  * @param filename Path to the saturated (white) frame RAW file.
  * @param log_stream Stream for logging messages.
  * @return An optional containing the calculated saturation level, or std::nullopt on failure.
  */
-std::optional<double> ProcessSaturationFrame(const std::string& filename, std::ostream& log_stream);
+std::optional<CalibrationFrameLevel> ProcessSaturationFrame(const std::string& filename, std::ostream& log_stream);
+
+/**
+ * @brief Determines the black level from one or more dark frames.
+ * @details A single frame goes through ProcessDarkFrame(). Several frames are stacked
+ * (see StackCalibrationFrames()) and the level is the mean of the stack; the
+ * temporal and fixed-pattern parts of the dark noise are logged.
+ * @param filenames Paths to the dark frame RAW files.
+ * @param log_stream Stream for logging messages.
+ * @return The black level, or std::nullopt on failure.
+ */
+std::optional<CalibrationFrameLevel> ProcessDarkFrames(const std::vector<std::string>& filenames, std::ostream& log_stream);
+
+/**
+ * @brief Determines the saturation point from one or more saturated frames.
+ * @details A single frame goes through ProcessSaturationFrame(). Several frames are
+ * stacked and the level is the median of the per-pixel means.
+ * @param filenames Paths to the saturated (white) frame RAW files.
+ * @param log_stream Stream for logging messages.
+ * @return The saturation level, or std::nullopt on failure.
+ */
+std::optional<CalibrationFrameLevel> ProcessSaturationFrames(const std::vector<std::string>& filenames, std::ostream& log_stream);
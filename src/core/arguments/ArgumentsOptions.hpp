@@ -84,6 +84,27 @@ struct RawChannelSelection {
     AvgMode avg_mode = AvgMode::Full;
 };
 
+/**
+ * @enum PatchSamplingEngine
+ * @brief Specifies how the pixels of the chart patches are read from the RAW data.
+ */
+enum class PatchSamplingEngine {
+    Rectified = 0, ///< Normalize, keystone-correct and crop each channel plane, then measure (default).
+    Mosaic = 1,    ///< Map each patch pixel back through the keystone table and read the mosaic directly.
+    Validate = 2,  ///< Run both engines and report the per-patch differences; results come from Rectified.
+    Integer = 3    ///< As Mosaic, but keep patches as uint16 and normalize only the exact integer statistics.
+};
+
+/**
+ * @enum CalibrationProfileMode
+ * @brief Specifies how the persistent calibration profile store is used.
+ */
+enum class CalibrationProfileMode {
+    Use = 0,     ///< Reuse stored levels when they apply and save new ones (default).
+    Refresh = 1, ///< Ignore stored levels, measure or estimate them again and overwrite the profiles.
+    Off = 2      ///< Neither read nor write calibration profiles.
+};
+
 /**
  * @struct ProgramOptions
  * @brief Holds all the configuration options for the dynamic range analysis.
@@ -95,10 +116,10 @@ struct ProgramOptions {
     double dark_value = DEFAULT_BLACK_LEVEL;
     /** @brief Saturation level value used for normalization. */
     double saturation_value = DEFAULT_SATURATION_LEVEL;
-    /** @brief Path to the dark frame RAW file (optional). */
-    std::string dark_file_path;
-    /** @brief Path to the saturation frame RAW file (optional). */
-    std::string sat_file_path;
+    /** @brief Paths to the dark frame RAW files (optional); several frames are stacked. */
+    std::vector<std::string> dark_file_paths;
+    /** @brief Paths to the saturation frame RAW files (optional); several frames are stacked. */
+    std::vector<std::string> sat_file_paths;
     /** @brief List of input RAW file paths for analysis. */
     std::vector<std::string> input_files;
     /** @brief Order of the polynomial fit for SNR curves (2 or 3). */
@@ -125,6 +146,20 @@ struct ProgramOptions {
     int source_image_index = 0;
     /** @brief If true, generate extended debug images (pre/post keystone, crop). */
     bool generate_full_debug = false;
+    /**
+     * @brief Maximum number of decoded RAW files kept in memory at once.
+     * @details 0 loads every file during initialization (default). A positive value
+     * streams the analysis: files are decoded just ahead of being analyzed.
+     */
+    int max_inflight_frames = 0;
+    /** @brief If true, pre-analysis results are read from and written to the on-disk cache. */
+    bool use_preanalysis_cache = true;
+    /** @brief If true, pre-analysis brightness is estimated from a pixel sample with an error bound. */
+    bool fast_preanalysis = false;
+    /** @brief How patch pixels are read from the RAW data. */
+    PatchSamplingEngine sampling_engine = PatchSamplingEngine::Rectified;
+    /** @brief How stored calibration profiles are used. */
+    CalibrationProfileMode calibration_profile_mode = CalibrationProfileMode::Use;
 
     // --- Output Settings ---
     /** @brief Base filename (or full path) for the output CSV file. */
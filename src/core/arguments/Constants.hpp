@@ -33,6 +33,18 @@ namespace DynaRange::Arguments::Constants {
     constexpr const char* ChartPatches = "chart-patches";
     constexpr const char* ChartCoords = "chart-coords";
 
+    // --- Execution Arguments ---
+    /** @brief Maximum number of decoded frames in flight; enables the streaming pipeline. */
+    constexpr const char* MaxInflightFrames = "max-inflight";
+    /** @brief Disables the persistent on-disk pre-analysis cache. */
+    constexpr const char* NoCache = "no-cache";
+    /** @brief Estimates pre-analysis statistics from a sample of the pixels. */
+    constexpr const char* FastPreAnalysis = "fast-preanalysis";
+    /** @brief Selects how patch pixels are read (rectified, mosaic or validate). */
+    constexpr const char* SamplingEngine = "sampling-engine";
+    /** @brief Selects how stored calibration profiles are used (use, refresh or off). */
+    constexpr const char* CalibrationProfiles = "calibration-profile";
+
     // --- Internal Flags (no user-facing CLI equivalent) ---
     constexpr const char* GeneratePlot = "generate-plot";
     constexpr const char* CreateChartMode = "create-chart-mode";
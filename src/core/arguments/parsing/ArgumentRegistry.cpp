@@ -27,9 +27,9 @@ std::map<std::string, ArgumentDescriptor> ArgumentRegistry::RegisterAll()
 
     // --- Core Analysis Arguments ---
     descriptors[BlackLevel] = { BlackLevel, "B", _("Camera RAW black level"), ArgType::Double, DEFAULT_BLACK_LEVEL };
-    descriptors[BlackFile] = { BlackFile, "b", _("Totally dark RAW file ideally shot at base ISO"), ArgType::String, std::string("") };
+    descriptors[BlackFile] = { BlackFile, "b", _("Totally dark RAW file(s) ideally shot at base ISO; several files (or wildcards) are stacked"), ArgType::StringVector, std::vector<std::string> {} };
     descriptors[SaturationLevel] = { SaturationLevel, "S", _("Camera RAW saturation level"), ArgType::Double, DEFAULT_SATURATION_LEVEL };
-    descriptors[SaturationFile] = { SaturationFile, "s", _("Totally clipped RAW file ideally shot at base ISO"), ArgType::String, std::string("") };
+    descriptors[SaturationFile] = { SaturationFile, "s", _("Totally clipped RAW file(s) ideally shot at base ISO; several files (or wildcards) are stacked"), ArgType::StringVector, std::vector<std::string> {} };
     descriptors[InputFiles] = { InputFiles, "i", _("Input RAW files shot over the test chart ideally for every ISO"), ArgType::StringVector, std::vector<std::string> {}, false }; // is_required=false, handled by CLI parser logic
     descriptors[PatchRatio] = { PatchRatio, "r", _("Relative patch width/height used to compute signal and noise readings (default=0.5)"), ArgType::Double, DEFAULT_PATCH_RATIO, false, 0.0, 1.0 };
     descriptors[SnrThresholdDb] = { SnrThresholdDb, "d", _("SNR threshold(s) list in dB for DR calculation (default=12 0)"), ArgType::DoubleVector, DEFAULT_SNR_THRESHOLDS_DB };
@@ -52,6 +52,13 @@ std::map<std::string, ArgumentDescriptor> ArgumentRegistry::RegisterAll()
     descriptors[ChartCoords] = { ChartCoords, "x", _("Manual chart corners: x1 y1 x2 y2 x3 y3 x4 y4"), ArgType::DoubleVector, std::vector<double>() };
     descriptors[FullDebug] = { FullDebug, "D", _("Generate additional debug images (pre/post keystone, crop area)"), ArgType::Flag, false };
 
+    // --- Execution Arguments ---
+    descriptors[MaxInflightFrames] = { MaxInflightFrames, "", _("Stream the analysis keeping at most N decoded RAW files in memory (default=0, load all files up front)"), ArgType::Int, 0, false, 0, 1024 };
+    descriptors[NoCache] = { NoCache, "", _("Do not read or write the persistent pre-analysis cache"), ArgType::Flag, false };
+    descriptors[FastPreAnalysis] = { FastPreAnalysis, "", _("Estimate the brightness of files read without decoding from a pixel sample; files whose order is uncertain are scanned fully"), ArgType::Flag, false };
+    descriptors[SamplingEngine] = { SamplingEngine, "", _("Patch sampling engine: rectified (warp and crop each channel), mosaic (read patches straight from the RAW data), integer (as mosaic, with exact integer patch statistics) or validate (run both and report per-patch differences)"), ArgType::String, std::string("rectified") };
+    descriptors[CalibrationProfiles] = { CalibrationProfiles, "", _("Stored calibration profiles: use (reuse stored black and saturation levels and save new ones), refresh (measure them again and overwrite the stored ones) or off"), ArgType::String, std::string("use") };
+
 
     // --- Internal Flags (no CLI exposure) ---
     descriptors[GeneratePlot] = { GeneratePlot, "", "", ArgType::Flag, false };
@@ -14,6 +14,36 @@
 
 namespace DynaRange::Arguments::Parsing {
 
+namespace {
+
+/**
+ * @brief Expands the patterns of a calibration file option and checks every match.
+ * @details Each pattern must name at least one existing file: a pattern that
+ * matches nothing would otherwise leave the option empty and silently fall back
+ * to the default level.
+ * @throws CLI::ValidationError naming the option and the offending pattern or file.
+ */
+std::vector<std::string> ExpandCalibrationFiles(const CLI::Option& option, const std::vector<std::string>& patterns)
+{
+    std::vector<std::string> files;
+    for (const auto& pattern : patterns) {
+        const std::vector<std::string> matches = PlatformUtils::ExpandWildcards({pattern});
+        if (matches.empty()) {
+            throw CLI::ValidationError(option.get_name(), _("No file matches: ") + pattern);
+        }
+        for (const auto& file : matches) {
+            const std::string error = CLI::ExistingFile(file);
+            if (!error.empty()) {
+                throw CLI::ValidationError(option.get_name(), error);
+            }
+            files.push_back(file);
+        }
+    }
+    return files;
+}
+
+} // namespace
+
 // File: src/core/arguments/parsing/CliParser.cpp
 std::map<std::string, std::any> CliParser::Parse(int argc, char* argv[], const std::map<std::string, ArgumentDescriptor>& descriptors)
 {
@@ -36,9 +66,9 @@ std::map<std::string, std::any> CliParser::Parse(int argc, char* argv[], const s
     auto chart_patches_opt = app.add_option("-M,--chart-patches", temp_opts.chart_patches, descriptors.at(ChartPatches).help_text)->expected(2);
     auto chart_coords_opt = app.add_option("-x,--chart-coords", temp_opts.chart_coords, descriptors.at(ChartCoords).help_text)->expected(8);
     auto input_opt = app.add_option("-i,--input-files", temp_opts.input_files, descriptors.at(InputFiles).help_text);
-    auto black_file_opt = app.add_option("-b,--black-file", temp_opts.dark_file_path, descriptors.at(BlackFile).help_text)->check(CLI::ExistingFile);
+    auto black_file_opt = app.add_option("-b,--black-file", temp_opts.dark_file_paths, descriptors.at(BlackFile).help_text);
     auto black_level_opt = app.add_option("-B,--black-level", temp_opts.dark_value, descriptors.at(BlackLevel).help_text);
-    auto sat_file_opt = app.add_option("-s,--saturation-file", temp_opts.sat_file_path, descriptors.at(SaturationFile).help_text)->check(CLI::ExistingFile);
+    auto sat_file_opt = app.add_option("-s,--saturation-file", temp_opts.sat_file_paths, descriptors.at(SaturationFile).help_text);
     auto sat_level_opt = app.add_option("-S,--saturation-level", temp_opts.saturation_value, descriptors.at(SaturationLevel).help_text);
     auto output_opt = app.add_option("-o,--output-file", temp_opts.output_filename, descriptors.at(OutputFile).help_text);
     auto snr_opt = app.add_option("-d,--snrthreshold-db", temp_snr_thresholds, descriptors.at(SnrThresholdDb).help_text);
@@ -51,14 +81,29 @@ std::map<std::string, std::any> CliParser::Parse(int argc, char* argv[], const s
     auto print_patch_opt = app.add_option("-g,--print-patches", temp_opts.print_patch_filename, descriptors.at(PrintPatches).help_text)->expected(0, 1)->default_str("_USE_DEFAULT_PRINT_PATCHES_");
     auto raw_channel_opt = app.add_option("-w,--raw-channels", temp_raw_channels, descriptors.at(RawChannels).help_text)->expected(5);
     auto debug_opt = app.add_flag("-D,--debug", temp_opts.generate_full_debug, descriptors.at(FullDebug).help_text);
+    auto max_inflight_opt = app.add_option("--max-inflight", temp_opts.max_inflight_frames, descriptors.at(MaxInflightFrames).help_text)->check(CLI::Range(0, 1024));
+    bool temp_no_cache = false;
+    app.add_flag("--no-cache", temp_no_cache, descriptors.at(NoCache).help_text);
+    bool temp_fast_preanalysis = false;
+    app.add_flag("--fast-preanalysis", temp_fast_preanalysis, descriptors.at(FastPreAnalysis).help_text);
+    std::string temp_sampling_engine;
+    auto sampling_engine_opt = app.add_option("--sampling-engine", temp_sampling_engine, descriptors.at(SamplingEngine).help_text)
+                                   ->check(CLI::IsMember({"rectified", "mosaic", "integer", "validate"}, CLI::ignore_case));
+    std::string temp_calibration_profile;
+    auto calibration_profile_opt = app.add_option("--calibration-profile", temp_calibration_profile, descriptors.at(CalibrationProfiles).help_text)
+                                       ->check(CLI::IsMember({"use", "refresh", "off"}, CLI::ignore_case));
 
 
     // --- Single Parse Pass ---
+    std::vector<std::string> black_files, sat_files;
     try {
         app.parse(argc, argv);
         if (chart_opt->count() == 0 && chart_colour_opt->count() == 0 && input_opt->count() == 0) {
             throw CLI::RequiredError(_("--input-files is required unless creating a chart with --chart or --chart-colour."));
         }
+        // Calibration files take wildcards, so they are checked once expanded.
+        if (black_file_opt->count() > 0) black_files = ExpandCalibrationFiles(*black_file_opt, temp_opts.dark_file_paths);
+        if (sat_file_opt->count() > 0) sat_files = ExpandCalibrationFiles(*sat_file_opt, temp_opts.sat_file_paths);
     } catch (const CLI::ParseError& e) {
         // Use standard streams for error output from CLI11's exit mechanism
         // exit() prints the error message and terminates.
@@ -77,7 +122,7 @@ std::map<std::string, std::any> CliParser::Parse(int argc, char* argv[], const s
     if (chart_patches_opt->count() > 0) values[ChartPatches] = temp_opts.chart_patches;
     if (chart_coords_opt->count() > 0) values[ChartCoords] = temp_opts.chart_coords;
     if (black_file_opt->count() > 0) {
-        values[BlackFile] = temp_opts.dark_file_path;
+        values[BlackFile] = black_files;
         values[BlackLevelIsDefault] = false;
     }
     if (black_level_opt->count() > 0) {
@@ -85,7 +130,7 @@ std::map<std::string, std::any> CliParser::Parse(int argc, char* argv[], const s
         values[BlackLevelIsDefault] = false;
     }
     if (sat_file_opt->count() > 0) {
-        values[SaturationFile] = temp_opts.sat_file_path;
+        values[SaturationFile] = sat_files;
         values[SaturationLevelIsDefault] = false;
     }
     if (sat_level_opt->count() > 0) {
@@ -100,10 +145,15 @@ std::map<std::string, std::any> CliParser::Parse(int argc, char* argv[], const s
     if (plot_format_opt->count() > 0) values[PlotFormat] = temp_plot_format;
     if (plot_params_opt->count() > 0) values[PlotParams] = temp_plot_params;
     if (print_patch_opt->count() > 0) values[PrintPatches] = temp_opts.print_patch_filename;
+    if (max_inflight_opt->count() > 0) values[MaxInflightFrames] = temp_opts.max_inflight_frames;
+    if (sampling_engine_opt->count() > 0) values[SamplingEngine] = temp_sampling_engine;
+    if (calibration_profile_opt->count() > 0) values[CalibrationProfiles] = temp_calibration_profile;
 
     // --debug -D Full debug plotting
     // Read the actual boolean value parsed by CLI11 into temp_opts.generate_full_debug
     values[FullDebug] = temp_opts.generate_full_debug;
+    values[NoCache] = temp_no_cache;
+    values[FastPreAnalysis] = temp_fast_preanalysis;
 
     values[InputFiles] = PlatformUtils::ExpandWildcards(temp_opts.input_files);
     if (snr_opt->count() > 0) {
@@ -65,8 +65,8 @@ ProgramOptions OptionsConverter::ToProgramOptions(const std::map<std::string, st
     opts.chart_patches = Get<std::vector<int>>(ChartPatches, values);
     opts.dark_value = Get<double>(BlackLevel, values);
     opts.saturation_value = Get<double>(SaturationLevel, values);
-    opts.dark_file_path = Get<std::string>(BlackFile, values);
-    opts.sat_file_path = Get<std::string>(SaturationFile, values);
+    opts.dark_file_paths = Get<std::vector<std::string>>(BlackFile, values);
+    opts.sat_file_paths = Get<std::vector<std::string>>(SaturationFile, values);
     opts.output_filename = Get<std::string>(OutputFile, values);
     opts.input_files = Get<std::vector<std::string>>(InputFiles, values);
     opts.poly_order = Get<int>(PolyFit, values);
@@ -143,6 +143,35 @@ ProgramOptions OptionsConverter::ToProgramOptions(const std::map<std::string, st
     // --debug -D Full Plotting
     opts.generate_full_debug = Get<bool>(FullDebug, values);
 
+    // --max-inflight Streaming pipeline
+    opts.max_inflight_frames = Get<int>(MaxInflightFrames, values);
+    // --no-cache Persistent pre-analysis cache
+    opts.use_preanalysis_cache = !Get<bool>(NoCache, values);
+    // --fast-preanalysis Sampled pre-analysis
+    opts.fast_preanalysis = Get<bool>(FastPreAnalysis, values);
+    // --sampling-engine Patch sampling engine
+    std::string engine_str = Get<std::string>(SamplingEngine, values);
+    std::transform(engine_str.begin(), engine_str.end(), engine_str.begin(), ::tolower); // Case-insensitive
+    if (engine_str == "mosaic") {
+        opts.sampling_engine = PatchSamplingEngine::Mosaic;
+    } else if (engine_str == "validate") {
+        opts.sampling_engine = PatchSamplingEngine::Validate;
+    } else if (engine_str == "integer") {
+        opts.sampling_engine = PatchSamplingEngine::Integer;
+    } else {
+        opts.sampling_engine = PatchSamplingEngine::Rectified;
+    }
+    // --calibration-profile Persistent calibration profiles
+    std::string profile_str = Get<std::string>(CalibrationProfiles, values);
+    std::transform(profile_str.begin(), profile_str.end(), profile_str.begin(), ::tolower); // Case-insensitive
+    if (profile_str == "refresh") {
+        opts.calibration_profile_mode = CalibrationProfileMode::Refresh;
+    } else if (profile_str == "off") {
+        opts.calibration_profile_mode = CalibrationProfileMode::Off;
+    } else {
+        opts.calibration_profile_mode = CalibrationProfileMode::Use;
+    }
+
 
     // --- Populate NEW GUI-specific members ---
     opts.gui_manual_camera_name = Get<std::string>(GuiManualCameraName, values);
@@ -9,10 +9,14 @@
 #include "Reporting.hpp"
 #include "Validation.hpp"
 #include "../artifacts/image/DebugImageWriter.hpp"
+#include "../io/raw/RawFileCache.hpp"
 #include "../arguments/ArgumentsOptions.hpp"
 #include "../utils/OutputNamingContext.hpp"
 #include "../utils/PathManager.hpp"
 #include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
 #include <ostream>
 #include <string>       
 #include <vector> 
@@ -73,11 +77,21 @@ ReportOutput RunDynamicRangeAnalysis(ProgramOptions& opts, std::ostream& log_str
         .plot_labels = init_result.plot_labels,
         .generated_command = init_result.generated_command,
         .source_image_index = init_result.source_image_index,
-        .generate_full_debug = opts.generate_full_debug // Copiar flag desde ProgramOptions
+        .generate_full_debug = opts.generate_full_debug, // Copiar flag desde ProgramOptions
+        .max_inflight_frames = opts.max_inflight_frames,
+        .sampling_engine = opts.sampling_engine
     };
 
     // Phase 2: Processing - Run the analysis loop over the loaded RAW files
+    const auto processing_start = std::chrono::steady_clock::now();
     ProcessingResult results = ProcessFiles(analysis_params, paths, log_stream, cancel_flag, init_result.loaded_raw_files);
+    const double processing_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - processing_start).count();
+    // Per-file I/O, including frames decoded again by the analysis.
+    DynaRange::IO::Raw::LogIngestionStatistics(init_result.loaded_raw_files, log_stream);
+    std::ostringstream timing;
+    timing << std::fixed << std::setprecision(2) << _("Timing: initialization ") << init_result.init_wall_seconds
+           << _(" s, processing ") << processing_seconds << " s.";
+    log_stream << timing.str() << std::endl;
     // Guardar PrintPatches DESPUÉS del procesamiento usando Factory
     if (results.debug_patch_image.has_value() && !analysis_params.print_patch_filename.empty())
     {
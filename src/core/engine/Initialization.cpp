@@ -14,10 +14,17 @@
 #include "../setup/SensorResolution.hpp"
 #include "../utils/CommandGenerator.hpp"
 #include "../setup/PreAnalysis.hpp" // <<-- Necesario para PreAnalysisResult
-#include "../setup/Constants.hpp"
+#include "../setup/PreAnalysisCache.hpp"
+#include "../setup/CalibrationProfileStore.hpp"
+#include "../io/raw/RawSummary.hpp"
+#include "../io/raw/RawFileCache.hpp"
+#include "../utils/ThreadPool.hpp"
+#include <chrono>
+#include <iomanip>
+#include <sstream>
 #include <libintl.h>
-#include <opencv2/core.hpp>
-#include <utility> // For std::pair and std::move
+#include <optional>
+#include <utility> // For std::move
 #include <map>     // <<-- Necesario para std::map
 #include <algorithm> // <<-- Necesario para std::find_if
 
@@ -25,6 +32,7 @@
 
 InitializationResult InitializeAnalysis(const ProgramOptions& opts, std::ostream& log_stream) {
 
+    const auto init_start = std::chrono::steady_clock::now();
     InitializationResult result;
     ProgramOptions local_opts = opts;
     const DynaRange::Engine::Initialization::InputFileFilter file_filter;
@@ -35,67 +43,47 @@ InitializationResult InitializeAnalysis(const ProgramOptions& opts, std::ostream
         return result;
     }
 
+    // Run-scoped decode cache: every stage below borrows the same decoded files,
+    // so each input is opened and unpacked at most once during initialization.
+    // Files it has to decode are read ahead on its I/O thread by the pre-analysis.
+    // In streaming mode only the most recent files keep their pixels, bounding memory.
+    const bool is_streaming = local_opts.max_inflight_frames > 0;
+    DynaRange::IO::Raw::RawFileCache raw_cache(is_streaming ? static_cast<size_t>(local_opts.max_inflight_frames) : 0);
+    // Results of earlier runs over the same files are reused from the on-disk cache.
+    PreAnalysisCache persistent_cache(local_opts.use_preanalysis_cache ? PreAnalysisCache::GetDefaultDirectory() : std::filesystem::path{});
+
     log_stream << _("Pre-analyzing files to extract metadata...") << std::endl;
-    // ExtractFileInfo ahora devuelve FileInfo Y RawFile cargados
-    auto [initial_file_info_vec, loaded_raw_files] = ExtractFileInfo(local_opts.input_files, log_stream);
+    std::vector<FileInfo> initial_file_info_vec = ExtractFileInfo(local_opts.input_files, log_stream, raw_cache, &persistent_cache, local_opts.fast_preanalysis);
+    if (persistent_cache.IsEnabled()) {
+        log_stream << _("Pre-analysis cache: ") << persistent_cache.GetHitCount() << _(" hit(s), ")
+                   << persistent_cache.GetMissCount() << _(" miss(es).") << std::endl;
+    }
 
     if (initial_file_info_vec.empty()) {
         log_stream << _("Error: None of the input files could be processed.") << std::endl;
         return result;
     }
 
-    // --- Obtener los resultados del pre-análisis (que incluyen has_saturated_pixels) ---
-    // ExtractFileInfo ya hizo la llamada a PreAnalyzeRawFiles internamente.
-    // Necesitamos reconstruir esa información aquí usando los FileInfo y RawFile que tenemos.
-    // Esto es un poco ineficiente, idealmente ExtractFileInfo devolvería directamente PreAnalysisResult.
-    std::vector<PreAnalysisResult> pre_analysis_results;
-    pre_analysis_results.reserve(initial_file_info_vec.size());
-    for(const auto& finfo : initial_file_info_vec) {
-        // Encontrar el RawFile correspondiente para la comprobación de saturación
-        auto raw_it = std::find_if(loaded_raw_files.begin(), loaded_raw_files.end(),
-            [&](const RawFile& rf){ return rf.GetFilename() == finfo.filename; });
-
-        bool is_saturated = false; // Asumir no saturado si falla algo
-        if (raw_it != loaded_raw_files.end()) {
-             cv::Mat active_img = raw_it->GetActiveRawImage();
-             if (!active_img.empty()) {
-                 // Usar local_opts.saturation_value aquí asume que ya ha sido calculado
-                 // por CalibrationHandler. Esto podría ser problemático si no.
-                 // Sería más seguro usar un valor temporal alto aquí como hacía ExtractFileInfo
-                 // y que SelectPreAnalysisRawIndex reciba el valor final después de CalibrationHandler.
-                 // Por ahora, asumimos que HandleCalibration se llama antes.
-                 int saturated_pixels = cv::countNonZero(active_img >= (local_opts.saturation_value * 0.99));
-                 double total_pixels = active_img.total();
-                 double saturation_ratio = (total_pixels > 0) ? static_cast<double>(saturated_pixels) / total_pixels : 0.0;
-                 is_saturated = (saturation_ratio > DynaRange::Setup::Constants::MAX_PRE_ANALYSIS_SATURATION_RATIO);
-             }
-        }
-        pre_analysis_results.push_back({finfo.filename, finfo.mean_brightness, finfo.iso_speed, is_saturated, local_opts.saturation_value});
-    }
-    // ---------------------------------------------------------------------------------
-
-
     const DynaRange::Engine::Initialization::CalibrationHandler calib_handler;
+    // Calibrations of earlier sessions on the same camera are reused from the profile store.
+    const bool use_profiles = local_opts.calibration_profile_mode != CalibrationProfileMode::Off;
+    const CalibrationProfileStore profile_store(use_profiles ? CalibrationProfileStore::GetDefaultDirectory() : std::filesystem::path{});
     // ¡Importante! HandleCalibration puede cambiar local_opts.saturation_value
-    if (!calib_handler.HandleCalibration(local_opts, initial_file_info_vec, log_stream)) {
+    if (!calib_handler.HandleCalibration(local_opts, initial_file_info_vec, log_stream, &raw_cache, &profile_store)) {
         return result;
     }
 
-    // --- RE-CALCULAR has_saturated_pixels con el valor de saturación FINAL ---
-    // (Esto es necesario si HandleCalibration cambió saturation_value)
-    for(auto& pa_result : pre_analysis_results) {
-         auto raw_it = std::find_if(loaded_raw_files.begin(), loaded_raw_files.end(),
-            [&](const RawFile& rf){ return rf.GetFilename() == pa_result.filename; });
-         if (raw_it != loaded_raw_files.end()) {
-             cv::Mat active_img = raw_it->GetActiveRawImage();
-             if (!active_img.empty()) {
-                 int saturated_pixels = cv::countNonZero(active_img >= (local_opts.saturation_value * 0.99));
-                 double total_pixels = active_img.total();
-                 double saturation_ratio = (total_pixels > 0) ? static_cast<double>(saturated_pixels) / total_pixels : 0.0;
-                 pa_result.has_saturated_pixels = (saturation_ratio > DynaRange::Setup::Constants::MAX_PRE_ANALYSIS_SATURATION_RATIO);
-                 pa_result.saturation_value_used = local_opts.saturation_value;
-             }
-         }
+    // --- Calcular has_saturated_pixels con el valor de saturación FINAL ---
+    // Se responde desde el histograma de cada fichero: no se vuelve a recorrer ningún píxel.
+    std::vector<PreAnalysisResult> pre_analysis_results;
+    pre_analysis_results.reserve(initial_file_info_vec.size());
+    for (const auto& finfo : initial_file_info_vec) {
+        bool is_saturated = false; // Asumir no saturado si falla algo
+        const auto& summary = finfo.summary; // Del pre-análisis: no se abre el fichero.
+        if (summary && summary->IsValid()) {
+            is_saturated = HasSaturatedPixels(*summary, local_opts.saturation_value);
+        }
+        pre_analysis_results.push_back({finfo.filename, finfo.mean_brightness, finfo.iso_speed, is_saturated, local_opts.saturation_value, summary});
     }
 
     const DynaRange::Engine::Initialization::ConfigReporter reporter;
@@ -105,32 +93,38 @@ InitializationResult InitializeAnalysis(const ProgramOptions& opts, std::ostream
     local_opts.input_files = order.sorted_filenames;
     local_opts.plot_labels = GeneratePlotLabels(order.sorted_filenames, initial_file_info_vec, order.was_exif_sort_possible);
 
-    // Reorder the loaded_raw_files vector to match the final sorted order
-    std::vector<RawFile> sorted_loaded_files;
-    sorted_loaded_files.reserve(order.sorted_filenames.size());
-    // Reorder pre_analysis_results to match the final sorted order too
-    std::vector<PreAnalysisResult> sorted_pre_analysis_results; // <<-- NUEVO VECTOR ORDENADO
-    sorted_pre_analysis_results.reserve(order.sorted_filenames.size()); // <<-- RESERVAR ESPACIO
+    if (local_opts.sensor_resolution_mpx == 0.0) {
+        local_opts.sensor_resolution_mpx = DetectSensorResolution(local_opts.input_files, log_stream, &raw_cache);
+    }
 
+    // Hand the decoded files over to the analysis stage in the final sorted order.
+    std::vector<RawFile> loaded_raw_files;
+    loaded_raw_files.reserve(order.sorted_filenames.size());
+    std::vector<PreAnalysisResult> sorted_pre_analysis_results;
+    sorted_pre_analysis_results.reserve(order.sorted_filenames.size());
+    // Files answered by the persistent cache are opened only now (headers only; pixels
+    // on first use), with the summary that was stored for them.
+    raw_cache.Prefetch(order.sorted_filenames);
     for (const auto& filename : order.sorted_filenames) {
-        // Mover RawFile
-        auto raw_it = std::find_if(loaded_raw_files.begin(), loaded_raw_files.end(),
-            [&](RawFile& file){ return file.GetFilename() == filename; });
-        if (raw_it != loaded_raw_files.end()) {
-            sorted_loaded_files.push_back(std::move(*raw_it));
-        }
-        // Copiar PreAnalysisResult
         auto pa_it = std::find_if(pre_analysis_results.begin(), pre_analysis_results.end(),
-            [&](const PreAnalysisResult& pa){ return pa.filename == filename; }); // <<-- BUSCAR EN pre_analysis_results
-        if (pa_it != pre_analysis_results.end()) { // <<-- SI SE ENCUENTRA
-            sorted_pre_analysis_results.push_back(*pa_it); // <<-- AÑADIR AL VECTOR ORDENADO
+            [&](const PreAnalysisResult& pa){ return pa.filename == filename; });
+        const RawFile* opened_file = raw_cache.Acquire(filename);
+        if (opened_file && pa_it != pre_analysis_results.end() && pa_it->summary && !pa_it->summary->IsSampled()) {
+            opened_file->PrimeSummary(pa_it->summary);
+        }
+        std::optional<RawFile> raw_file = raw_cache.Release(filename);
+        if (raw_file) {
+            // In streaming mode the residency limit has left at most max_inflight_frames
+            // files decoded; the analysis starts with those instead of decoding them again.
+            loaded_raw_files.push_back(std::move(*raw_file));
+        }
+        if (pa_it != pre_analysis_results.end()) {
+            sorted_pre_analysis_results.push_back(*pa_it);
         }
     }
-    loaded_raw_files = std::move(sorted_loaded_files);
-
-    if (local_opts.sensor_resolution_mpx == 0.0) {
-        local_opts.sensor_resolution_mpx = DetectSensorResolution(local_opts.input_files, log_stream);
-    }
+    // Logged after the hand-over so files first opened above are counted; the per-file
+    // I/O of the handed-over files is reported after the analysis.
+    raw_cache.LogStatistics(log_stream);
 
     // Store detected dimensions and Bayer pattern from the first valid file.
     if (!loaded_raw_files.empty()) {
@@ -141,6 +135,16 @@ InitializationResult InitializeAnalysis(const ProgramOptions& opts, std::ostream
         result.bayer_pattern = loaded_raw_files[0].GetFilterPattern(); // Store Bayer pattern
     }
 
+    // Only layouts with a known gather table can be split into channels; never guess one.
+    for (const auto& raw_file : loaded_raw_files) {
+        if (!raw_file.GetCfaTable()) {
+            log_stream << _("[FATAL ERROR] Unsupported CFA pattern '") << raw_file.GetFilterPattern() << _("' in file: ")
+                       << raw_file.GetFilename() << std::endl;
+            log_stream << _("  Only 2x2 Bayer layouts (RGGB, BGGR, GRBG, GBRG) and X-Trans can be analyzed.") << std::endl;
+            return result;
+        }
+    }
+
     if (local_opts.plot_command_mode == 2) {
         local_opts.generated_command = CommandGenerator::GenerateCommand(CommandFormat::PlotShort);
     } else if (local_opts.plot_command_mode == 3) {
@@ -155,6 +159,12 @@ InitializationResult InitializeAnalysis(const ProgramOptions& opts, std::ostream
         log_stream
     );
 
+    result.init_wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - init_start).count();
+    std::ostringstream init_time;
+    init_time << std::fixed << std::setprecision(2) << result.init_wall_seconds;
+    log_stream << _("Initialization completed in ") << init_time.str() << _(" s using up to ")
+               << DynaRange::Utils::ThreadPool::Shared().GetConcurrency() << _(" threads.") << std::endl;
+
     result.success = true;
     result.loaded_raw_files = std::move(loaded_raw_files);
     result.sorted_filenames = local_opts.input_files;
@@ -30,6 +30,7 @@ struct InitializationResult {
     bool saturation_level_is_default = true;
     int source_image_index = 0;
     std::string bayer_pattern;
+    double init_wall_seconds = 0.0; ///< Wall-clock time spent in the initialization phase.
 };
 
 /**
@@ -6,6 +6,7 @@
 #include "PatchAnalysisStrategy.hpp"
 #include "../analysis/ImageAnalyzer.hpp"
 #include "../utils/Formatters.hpp"
+#include <cmath>
 #include <libintl.h>
 #include <mutex>
 
@@ -13,21 +14,26 @@
 
 namespace DynaRange::Engine {
 
-PatchAnalysisResult PerformTwoPassPatchAnalysis(
-    const cv::Mat& prepared_image,
+namespace { // Anonymous namespace for internal helpers
+
+/**
+ * @brief Applies the strict threshold and, if needed, the permissive one to measured patches.
+ * @details The patches are measured once by the caller; each pass is only a filter
+ * over the measurement table.
+ * @param overlay_base If not empty, the patches of the chosen pass are outlined on a copy of it.
+ */
+PatchAnalysisResult RunTwoPassAnalysis(
+    const std::vector<PatchMeasurement>& measurements,
+    const cv::Mat& overlay_base,
     DataSource channel,
-    const ChartProfile& chart,
-    double patch_ratio,
     std::ostream& log_stream,
     double strict_min_snr_db,
     double permissive_min_snr_db,
     double max_requested_threshold,
-    bool create_overlay_image,
-    std::mutex& log_mutex,
-    double dark_value)
+    std::mutex& log_mutex)
 {
-    // --- Pass 1: Analyze with the strict threshold ---
-    PatchAnalysisResult patch_data = AnalyzePatches(prepared_image, chart.GetGridCols(), chart.GetGridRows(), patch_ratio, create_overlay_image, strict_min_snr_db, dark_value);
+    // --- Pass 1: Filter with the strict threshold ---
+    PatchAnalysisResult patch_data = FilterPatches(measurements, strict_min_snr_db);
 
     // --- Validation Step ---
     bool needs_reanalysis = false;
@@ -46,7 +52,7 @@ PatchAnalysisResult PerformTwoPassPatchAnalysis(
         }
     }
 
-    // --- Pass 2 (Conditional): Re-analyze with the permissive threshold ---
+    // --- Pass 2 (Conditional): Re-filter with the permissive threshold ---
     if (needs_reanalysis) {
         {
             std::lock_guard<std::mutex> lock(log_mutex);
@@ -54,7 +60,10 @@ PatchAnalysisResult PerformTwoPassPatchAnalysis(
                        << " with permissive threshold to find low-SNR data."
                        << std::endl;
         }
-        patch_data = AnalyzePatches(prepared_image, chart.GetGridCols(), chart.GetGridRows(), patch_ratio, create_overlay_image, permissive_min_snr_db, dark_value);
+        patch_data = FilterPatches(measurements, permissive_min_snr_db, overlay_base);
+    } else if (!overlay_base.empty()) {
+        // The overlay is drawn once, for the pass that was kept.
+        patch_data = FilterPatches(measurements, strict_min_snr_db, overlay_base);
     }
 
     if (patch_data.signal.empty()) {
@@ -65,4 +74,40 @@ PatchAnalysisResult PerformTwoPassPatchAnalysis(
     return patch_data;
 }
 
+} // end anonymous namespace
+
+PatchAnalysisResult PerformTwoPassPatchAnalysis(
+    const cv::Mat& prepared_image,
+    DataSource channel,
+    const ChartProfile& chart,
+    std::ostream& log_stream,
+    double strict_min_snr_db,
+    double permissive_min_snr_db,
+    double max_requested_threshold,
+    bool create_overlay_image,
+    std::mutex& log_mutex,
+    double dark_value)
+{
+    const auto measurements = MeasurePatches(prepared_image, chart.GetSamplingPlan(), dark_value);
+    return RunTwoPassAnalysis(measurements, create_overlay_image ? prepared_image : cv::Mat(), channel, log_stream,
+                              strict_min_snr_db, permissive_min_snr_db, max_requested_threshold, log_mutex);
+}
+
+PatchAnalysisResult PerformTwoPassPatchAnalysis(
+    const PatchSampler& sample_patch,
+    DataSource channel,
+    const ChartProfile& chart,
+    std::ostream& log_stream,
+    double strict_min_snr_db,
+    double permissive_min_snr_db,
+    double max_requested_threshold,
+    std::mutex& log_mutex,
+    double dark_value,
+    const std::optional<RawPatchLevels>& raw_levels)
+{
+    const auto measurements = MeasurePatches(chart.GetSamplingPlan(), sample_patch, dark_value, raw_levels);
+    return RunTwoPassAnalysis(measurements, cv::Mat(), channel, log_stream,
+                              strict_min_snr_db, permissive_min_snr_db, max_requested_threshold, log_mutex);
+}
+
 } // namespace DynaRange::Engine
\ No newline at end of file
@@ -6,13 +6,16 @@
  * analysis pass, validating its results, and conditionally re-running a more
  * permissive pass to handle high-ISO "floating curves". It adheres to SRP
  * by separating this strategy from the main file processing orchestration.
+ * The patches are measured only once; both passes filter the same measurements.
  */
 #pragma once
 
 #include "../analysis/Analysis.hpp"
+#include "../analysis/ImageAnalyzer.hpp"
 #include "../setup/ChartProfile.hpp"
 #include <ostream>
 #include <mutex>
+#include <optional>
 
 namespace DynaRange::Engine {
 
@@ -20,8 +23,7 @@ namespace DynaRange::Engine {
  * @brief Executes a two-pass analysis strategy on a prepared single-channel image.
  * @param prepared_image The single-channel image, already corrected for keystone and cropped.
  * @param channel The data source channel being analyzed (for logging).
- * @param chart The chart profile containing grid dimensions.
- * @param patch_ratio The relative area of the center of each patch to sample.
+ * @param chart The chart profile whose sampling plan gives the patch rectangles.
  * @param log_stream The output stream for logging messages.
  * @param strict_min_snr_db The strict minimum SNR threshold for the first pass.
  * @param permissive_min_snr_db The permissive minimum SNR threshold for the second pass.
@@ -35,7 +37,6 @@ PatchAnalysisResult PerformTwoPassPatchAnalysis(
     const cv::Mat& prepared_image,
     DataSource channel,
     const ChartProfile& chart,
-    double patch_ratio,
     std::ostream& log_stream,
     double strict_min_snr_db,
     double permissive_min_snr_db,
@@ -45,4 +46,25 @@ PatchAnalysisResult PerformTwoPassPatchAnalysis(
     double dark_value
 );
 
+/**
+ * @brief Executes the two-pass analysis strategy reading the patches through a sampler.
+ * @details Used by engines that never build the cropped chart image; no overlay is produced.
+ * @param sample_patch Gives the pixels of each patch rectangle.
+ * @param raw_levels If set, the sampler returns raw uint16 pixels normalized with these levels.
+ * @return A PatchAnalysisResult struct containing the signal and noise from the chosen pass.
+ * @see The image overload for the remaining parameters.
+ */
+PatchAnalysisResult PerformTwoPassPatchAnalysis(
+    const PatchSampler& sample_patch,
+    DataSource channel,
+    const ChartProfile& chart,
+    std::ostream& log_stream,
+    double strict_min_snr_db,
+    double permissive_min_snr_db,
+    double max_requested_threshold,
+    std::mutex& log_mutex,
+    double dark_value,
+    const std::optional<RawPatchLevels>& raw_levels = std::nullopt
+);
+
 }
\ No newline at end of file
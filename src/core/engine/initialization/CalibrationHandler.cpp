@@ -5,32 +5,186 @@
  */
 #include "CalibrationHandler.hpp"
 #include "../../analysis/RawProcessor.hpp"
+#include "../../io/raw/RawFile.hpp"
 #include "../../setup/CalibrationEstimator.hpp"
+#include "../../setup/CalibrationProfileStore.hpp"
+#include "../../utils/ThreadPool.hpp"
 #include <libintl.h>
+#include <optional>
+#include <sstream>
 
 #define _(string) gettext(string)
 
 namespace DynaRange::Engine::Initialization {
 
-bool CalibrationHandler::HandleCalibration(ProgramOptions& opts, const std::vector<FileInfo>& file_info, std::ostream& log_stream) const
+namespace {
+
+/**
+ * @brief Checks whether a stored record can stand in for the requested calibration.
+ * @details With frames, only a record measured from those very frames (same
+ * fingerprint) is reused. Without frames, a record measured from frames is reused,
+ * since it is only stored under the key of the frames themselves, but an estimate
+ * only if it was made from the current input files.
+ */
+bool IsReusable(const std::optional<CalibrationRecord>& record, const std::vector<std::string>& frames, const std::string& frames_fingerprint, const std::string& inputs_fingerprint)
+{
+    if (!record) return false;
+    if (!frames.empty()) {
+        return record->source == CalibrationProfileStore::SOURCE_FRAMES && !frames_fingerprint.empty() && record->fingerprint == frames_fingerprint;
+    }
+    if (record->source == CalibrationProfileStore::SOURCE_FRAMES) return true;
+    return !inputs_fingerprint.empty() && record->fingerprint == inputs_fingerprint;
+}
+
+/**
+ * @brief Finds the stored record of one kind that covers every ISO of the session.
+ * @return The record, or nullptr unless every profile has a reusable record and they
+ *         all agree on the level, since the session applies a single level.
+ */
+const CalibrationRecord* FindReusableRecord(const std::vector<CalibrationProfile>& profiles, std::optional<CalibrationRecord> CalibrationProfile::* kind, const std::vector<std::string>& frames, const std::string& frames_fingerprint, const std::string& inputs_fingerprint)
+{
+    if (profiles.empty()) return nullptr;
+    for (const auto& profile : profiles) {
+        const auto& record = profile.*kind;
+        if (!IsReusable(record, frames, frames_fingerprint, inputs_fingerprint)) return nullptr;
+        if (record->level != (profiles.front().*kind)->level) return nullptr;
+    }
+    return &*(profiles.front().*kind);
+}
+
+bool IsSameKey(const CalibrationProfileKey& a, const CalibrationProfileKey& b)
+{
+    return a.camera_model == b.camera_model && a.serial_number == b.serial_number &&
+           a.iso_speed == b.iso_speed && a.bit_depth == b.bit_depth;
+}
+
+/**
+ * @brief Builds the profile key of a set of calibration frames from their own metadata.
+ * @return The key, or std::nullopt (with the reason logged) if a frame cannot be read
+ *         or the frames do not share one body, ISO and bit depth.
+ */
+std::optional<CalibrationProfileKey> MakeFramesKey(const std::vector<std::string>& frames, std::ostream& log_stream)
+{
+    std::optional<CalibrationProfileKey> key;
+    for (const auto& filename : frames) {
+        RawFile file(filename);
+        if (!file.LoadMetadata()) return std::nullopt;
+        CalibrationProfileKey frame_key{file.GetCameraModel(), file.GetSerialNumber(), file.GetIsoSpeed(), file.GetBitDepth().value_or(0)};
+        if (!key) {
+            key = std::move(frame_key);
+        } else if (!IsSameKey(*key, frame_key)) {
+            log_stream << _("[INFO] The calibration frames were shot with different cameras or ISOs (")
+                       << key->ToString() << "; " << frame_key.ToString() << _("); their level is not saved.") << std::endl;
+            return std::nullopt;
+        }
+    }
+    return key;
+}
+
+std::string DescribeGroups(const std::vector<CalibrationProfileGroup>& groups)
+{
+    std::string text;
+    for (const auto& group : groups) {
+        if (!text.empty()) text += "; ";
+        text += group.key.ToString();
+    }
+    return text;
+}
+
+void LogProfileRecord(const char* label, const CalibrationRecord& record, const std::vector<CalibrationProfileGroup>& groups, std::ostream& log_stream)
 {
+    log_stream << label << record.level << _(" (calibration profile of ") << DescribeGroups(groups) << ", "
+               << record.source << ", " << record.created << ")" << std::endl;
+}
+
+CalibrationRecord MakeRecord(const CalibrationFrameLevel& level, const std::vector<std::string>& frames, std::string fingerprint)
+{
+    CalibrationRecord record;
+    record.level = level.level;
+    record.channel_levels = level.channel_levels;
+    record.source = CalibrationProfileStore::SOURCE_FRAMES;
+    record.files = frames;
+    record.fingerprint = std::move(fingerprint);
+    return record;
+}
+
+CalibrationRecord MakeRecord(double level, const std::vector<FileInfo>& file_info, std::string fingerprint)
+{
+    CalibrationRecord record;
+    record.level = level;
+    record.source = CalibrationProfileStore::SOURCE_ESTIMATED;
+    for (const auto& info : file_info) record.files.push_back(info.filename);
+    record.fingerprint = std::move(fingerprint);
+    return record;
+}
+
+} // namespace
+
+bool CalibrationHandler::HandleCalibration(ProgramOptions& opts, const std::vector<FileInfo>& file_info, std::ostream& log_stream, DynaRange::IO::Raw::RawFileCache* raw_cache, const CalibrationProfileStore* profile_store) const
+{
+    // --- 0. STORED CALIBRATION PROFILES ---
+    // Levels given as numbers are used as they are; anything to be measured or
+    // estimated is first looked up in the profiles of the camera, one per ISO of
+    // the inputs, before any file is read. In refresh mode nothing is reused, so
+    // the new results overwrite the stored ones.
+    const bool wants_black = !opts.dark_file_paths.empty() || opts.black_level_is_default;
+    const bool wants_saturation = !opts.sat_file_paths.empty() || opts.saturation_level_is_default;
+    std::vector<CalibrationProfileGroup> profile_groups;
+    std::vector<CalibrationProfile> profiles;
+    if (profile_store && profile_store->IsEnabled() && (wants_black || wants_saturation)) {
+        profile_groups = MakeCalibrationProfileGroups(file_info);
+        for (const auto& group : profile_groups) {
+            profiles.push_back(profile_store->Lookup(group.key).value_or(CalibrationProfile{}));
+        }
+    }
+    const bool use_profiles = !profile_groups.empty();
+    const bool reuse_profiles = use_profiles && opts.calibration_profile_mode == CalibrationProfileMode::Use;
+    std::vector<std::string> input_files;
+    for (const auto& info : file_info) input_files.push_back(info.filename);
+    const std::string inputs_fingerprint = use_profiles ? CalibrationProfileStore::FingerprintFiles(input_files) : std::string{};
+    const std::string dark_fingerprint = use_profiles && !opts.dark_file_paths.empty() ? CalibrationProfileStore::FingerprintFiles(opts.dark_file_paths) : std::string{};
+    const std::string sat_fingerprint = use_profiles && !opts.sat_file_paths.empty() ? CalibrationProfileStore::FingerprintFiles(opts.sat_file_paths) : std::string{};
+
+    bool black_resolved = false;
+    bool saturation_resolved = false;
+    if (reuse_profiles && wants_black) {
+        if (const auto* record = FindReusableRecord(profiles, &CalibrationProfile::black, opts.dark_file_paths, dark_fingerprint, inputs_fingerprint)) {
+            opts.dark_value = record->level;
+            LogProfileRecord(_("Black level obtained: "), *record, profile_groups, log_stream);
+            black_resolved = true;
+        }
+    }
+    if (reuse_profiles && wants_saturation) {
+        if (const auto* record = FindReusableRecord(profiles, &CalibrationProfile::saturation, opts.sat_file_paths, sat_fingerprint, inputs_fingerprint)) {
+            opts.saturation_value = record->level;
+            LogProfileRecord(_("Saturation point obtained: "), *record, profile_groups, log_stream);
+            saturation_resolved = true;
+        }
+    }
+    // New estimates replace the record of their kind in every profile of the session;
+    // levels measured from frames only in the profile of the frames' own key.
+    std::optional<CalibrationRecord> new_black;
+    std::optional<CalibrationRecord> new_saturation;
+
     // --- 1. DEFAULT CALIBRATION ESTIMATION ---
-    if (opts.dark_file_path.empty() && opts.black_level_is_default) {
+    if (!black_resolved && opts.dark_file_paths.empty() && opts.black_level_is_default) {
         log_stream << _("[INFO] Black level not specified. Attempting to estimate from RAW file...") << std::endl;
-        auto estimated_black = CalibrationEstimator::EstimateBlackLevel(opts, file_info, log_stream);
+        auto estimated_black = CalibrationEstimator::EstimateBlackLevel(opts, file_info, log_stream, raw_cache);
         if (estimated_black) {
             opts.dark_value = *estimated_black;
+            new_black = MakeRecord(*estimated_black, file_info, inputs_fingerprint);
         } else {
             log_stream << _("[Warning] Could not estimate black level. Using fallback default value: ") 
                        << opts.dark_value << std::endl;
         }
     }
 
-    if (opts.sat_file_path.empty() && opts.saturation_level_is_default) {
+    if (!saturation_resolved && opts.sat_file_paths.empty() && opts.saturation_level_is_default) {
         log_stream << _("[INFO] Saturation level not specified. Attempting to estimate from RAW file...") << std::endl;
-        auto estimated_sat = CalibrationEstimator::EstimateSaturationLevel(opts, file_info, log_stream);
+        auto estimated_sat = CalibrationEstimator::EstimateSaturationLevel(opts, file_info, log_stream, raw_cache);
         if (estimated_sat) {
             opts.saturation_value = *estimated_sat;
+            new_saturation = MakeRecord(*estimated_sat, file_info, inputs_fingerprint);
         } else {
             log_stream << _("[Warning] Could not estimate saturation level. Using fallback default value: ")
                        << opts.saturation_value << std::endl;
@@ -38,21 +192,72 @@ bool CalibrationHandler::HandleCalibration(ProgramOptions& opts, const std::vect
     }
 
     // --- 2. CALIBRATION FROM EXPLICIT FILES (overwrites estimates) ---
-    if (!opts.dark_file_path.empty()) {
-        auto dark_val_opt = ProcessDarkFrame(opts.dark_file_path, log_stream);
+    // The dark and saturation frames are independent: decode them concurrently,
+    // buffering their messages so the log keeps its usual order. Several frames
+    // of a kind are stacked.
+    const bool process_dark = !black_resolved && !opts.dark_file_paths.empty();
+    const bool process_sat = !saturation_resolved && !opts.sat_file_paths.empty();
+    std::optional<CalibrationFrameLevel> dark_val_opt;
+    std::optional<CalibrationFrameLevel> sat_val_opt;
+    std::ostringstream dark_log;
+    std::ostringstream sat_log;
+    DynaRange::Utils::ThreadPool::Shared().ParallelFor(2, [&](size_t task) {
+        if (task == 0 && process_dark) {
+            dark_val_opt = ProcessDarkFrames(opts.dark_file_paths, dark_log);
+        } else if (task == 1 && process_sat) {
+            sat_val_opt = ProcessSaturationFrames(opts.sat_file_paths, sat_log);
+        }
+    });
+
+    log_stream << dark_log.str();
+    if (process_dark) {
         if (!dark_val_opt) { 
             log_stream << _("Fatal error processing dark frame.") << std::endl; 
             return false;
         }
-        opts.dark_value = *dark_val_opt;
+        opts.dark_value = dark_val_opt->level;
+        new_black = MakeRecord(*dark_val_opt, opts.dark_file_paths, dark_fingerprint);
     }
-    if (!opts.sat_file_path.empty()) {
-        auto sat_val_opt = ProcessSaturationFrame(opts.sat_file_path, log_stream);
+    log_stream << sat_log.str();
+    if (process_sat) {
         if (!sat_val_opt) { 
             log_stream << _("Fatal error processing saturation frame.") << std::endl; 
             return false;
         }
-        opts.saturation_value = *sat_val_opt;
+        opts.saturation_value = sat_val_opt->level;
+        new_saturation = MakeRecord(*sat_val_opt, opts.sat_file_paths, sat_fingerprint);
+    }
+
+    // --- 3. PERSIST THE NEW RESULTS ---
+    if (use_profiles && (new_black || new_saturation)) {
+        const auto dark_key = process_dark ? MakeFramesKey(opts.dark_file_paths, log_stream) : std::nullopt;
+        const auto sat_key = process_sat ? MakeFramesKey(opts.sat_file_paths, log_stream) : std::nullopt;
+        bool dark_stored = false;
+        bool sat_stored = false;
+        std::vector<CalibrationProfileGroup> saved_groups;
+        for (size_t i = 0; i < profile_groups.size(); ++i) {
+            const auto& key = profile_groups[i].key;
+            const bool store_black = new_black && (!process_dark || (dark_key && IsSameKey(*dark_key, key)));
+            const bool store_saturation = new_saturation && (!process_sat || (sat_key && IsSameKey(*sat_key, key)));
+            if (!store_black && !store_saturation) continue;
+            if (store_black) profiles[i].black = new_black;
+            if (store_saturation) profiles[i].saturation = new_saturation;
+            profile_store->Store(key, profiles[i]);
+            saved_groups.push_back(profile_groups[i]);
+            dark_stored = dark_stored || (store_black && process_dark);
+            sat_stored = sat_stored || (store_saturation && process_sat);
+        }
+        if (dark_key && !dark_stored) {
+            log_stream << _("[INFO] The dark frames (") << dark_key->ToString()
+                       << _(") match no camera and ISO of the input files; the black level is not saved.") << std::endl;
+        }
+        if (sat_key && !sat_stored) {
+            log_stream << _("[INFO] The saturation frames (") << sat_key->ToString()
+                       << _(") match no camera and ISO of the input files; the saturation level is not saved.") << std::endl;
+        }
+        if (!saved_groups.empty()) {
+            log_stream << _("[INFO] Calibration profile saved for ") << DescribeGroups(saved_groups) << "." << std::endl;
+        }
     }
     
     return true;
@@ -10,8 +10,11 @@
 
 #include "../../arguments/ArgumentsOptions.hpp"
 #include "../../setup/MetadataExtractor.hpp" // For FileInfo
+#include "../../io/raw/RawFileCache.hpp"
 #include <ostream>
 
+class CalibrationProfileStore;
+
 namespace DynaRange::Engine::Initialization {
 
 /**
@@ -26,13 +29,21 @@ public:
      * 1. If explicit calibration files are provided in `opts`, it processes them.
      * 2. Otherwise, if default values are being used, it attempts to estimate them.
      * 3. If estimation fails, it falls back to the hardcoded default values.
+     * Levels to be measured or estimated are first looked up in the calibration
+     * profiles of the camera (one per ISO of the inputs), and new results are saved
+     * to them. A level measured from frames is saved only in the profile matching
+     * the frames' own camera, ISO and bit depth, and reused for the same frames or
+     * when no frames are given; an estimated level only for the same input files.
+     * CalibrationProfileMode::Refresh measures everything again.
      * The function modifies the ProgramOptions object directly.
      * @param opts A reference to the program options, which will be updated.
      * @param file_info A vector of pre-analyzed file metadata for estimation.
      * @param log_stream The output stream for logging messages.
+     * @param raw_cache Optional run-scoped decode cache used by the estimators.
+     * @param profile_store Optional persistent store of per-camera calibration profiles.
      * @return true on success, false if a fatal error occurs during processing.
      */
-    bool HandleCalibration(ProgramOptions& opts, const std::vector<FileInfo>& file_info, std::ostream& log_stream) const;
+    bool HandleCalibration(ProgramOptions& opts, const std::vector<FileInfo>& file_info, std::ostream& log_stream, DynaRange::IO::Raw::RawFileCache* raw_cache = nullptr, const CalibrationProfileStore* profile_store = nullptr) const;
 };
 
 } // namespace DynaRange::Engine::Initialization
\ No newline at end of file
@@ -17,14 +17,9 @@ namespace DynaRange::Engine::Initialization {
 
 void InputFileFilter::Filter(ProgramOptions& opts, std::ostream& log_stream) const {
     // --- 1. Exclude Calibration Files from Analysis ---
-    if (!opts.dark_file_path.empty() || !opts.sat_file_path.empty()) {
-        std::set<std::string> calibration_files;
-        if (!opts.dark_file_path.empty()) {
-            calibration_files.insert(opts.dark_file_path);
-        }
-        if (!opts.sat_file_path.empty()) {
-            calibration_files.insert(opts.sat_file_path);
-        }
+    if (!opts.dark_file_paths.empty() || !opts.sat_file_paths.empty()) {
+        std::set<std::string> calibration_files(opts.dark_file_paths.begin(), opts.dark_file_paths.end());
+        calibration_files.insert(opts.sat_file_paths.begin(), opts.sat_file_paths.end());
 
         std::vector<std::string> files_to_remove;
         opts.input_files.erase(
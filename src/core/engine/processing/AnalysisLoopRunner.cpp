@@ -6,14 +6,20 @@
 #include "AnalysisLoopRunner.hpp"
 #include "../PatchAnalysisStrategy.hpp"
 #include "ResultAggregator.hpp"
+#include "MosaicPatchSampler.hpp"
 #include "../../graphics/geometry/KeystoneCorrection.hpp"
 #include "../../utils/PathManager.hpp"
 #include "../../analysis/Constants.hpp"   
 #include "../../graphics/ImageProcessing.hpp"
 #include "../../utils/Formatters.hpp"
+#include "../../utils/ThreadPool.hpp"
+#include "../../io/raw/RawPrefetcher.hpp"
 #include <libintl.h>
-#include <future> 
+#include <algorithm>
+#include <array>
 #include <mutex>
+#include <optional>
+#include <sstream>
 #include <opencv2/core.hpp>
 
 #define _(string) gettext(string)
@@ -25,7 +31,7 @@ std::vector<SingleFileResult> AnalyzeSingleRawFile(
     const RawFile& raw_file,
     const AnalysisParameters& params, // Contiene generate_full_debug
     const ChartProfile& chart,
-    const cv::Mat& keystone_params,
+    const DynaRange::Graphics::Geometry::KeystoneRemap& keystone,
     std::ostream& log_stream,
     bool generate_debug_image, // Este es para printpatches
     const std::atomic<bool>& cancel_flag,
@@ -64,34 +70,129 @@ std::vector<SingleFileResult> AnalyzeSingleRawFile(
     }
 
 
+    // The rectified engine prepares every channel; the mosaic engines only the G1 plane
+    // when its debug images are requested, and read all other patches in place.
+    const PatchSamplingEngine engine = params.sampling_engine;
+    const bool reads_mosaic = (engine == PatchSamplingEngine::Mosaic || engine == PatchSamplingEngine::Integer);
+    std::vector<DataSource> channels_to_prepare;
     for (const auto& channel : channels_to_analyze) {
-        if (cancel_flag) return {};
-        // *** PASAR params.generate_full_debug ***
-        cv::Mat img_prepared = PrepareChartImage(
+        const bool needs_debug_images = (channel == DataSource::G1) && (generate_debug_image || params.generate_full_debug);
+        if (!reads_mosaic || needs_debug_images) {
+            channels_to_prepare.push_back(channel);
+        }
+    }
+
+    // All prepared channels are normalized from a single pass over the mosaic.
+    std::map<DataSource, cv::Mat> prepared_channels;
+    if (!channels_to_prepare.empty()) {
+        prepared_channels = PrepareAllBayerChannels(
             raw_file,
             params.dark_value,
             params.saturation_value,
-            keystone_params,
+            keystone,
             chart,
             log_stream,
-            channel,
+            channels_to_prepare,
             paths,
             camera_model_name,
-            params.generate_full_debug // <-- Pasar el flag
+            params.generate_full_debug,
+            log_mutex
         );
+    }
+
+    const auto cfa_pattern = raw_file.GetCfaPattern();
+    const auto cfa_table = cfa_pattern ? std::nullopt : raw_file.GetCfaTable();
+    // The channels are analyzed in parallel on the shared pool, which also runs the
+    // file-level loop, so both levels draw from the same set of threads.
+    std::vector<std::optional<PatchAnalysisResult>> channel_results(channels_to_analyze.size());
+    DynaRange::Utils::ThreadPool::Shared().ParallelFor(channels_to_analyze.size(), [&](size_t channel_index) {
+        const DataSource channel = channels_to_analyze[channel_index];
+        if (cancel_flag) return;
+        bool should_draw_overlay = generate_debug_image && (channel == DataSource::G1);
+
+        // Mosaic sampler of the channel, for the mosaic, integer and validate engines.
+        // Bayer planes are read in place; other layouts read the channel's pixel
+        // population from the four position planes through the CFA table.
+        std::optional<DynaRange::Engine::Processing::MosaicPatchSampler> sampler;
+        if (engine != PatchSamplingEngine::Rectified) {
+            DynaRange::IO::Raw::BayerPlaneView plane;
+            std::array<DynaRange::IO::Raw::BayerPlaneView, 4> position_planes;
+            if (cfa_pattern) {
+                plane = raw_file.GetBayerPlaneView(DynaRange::IO::Raw::GetCfaOffsets(*cfa_pattern, GetCfaSite(channel)));
+            } else if (cfa_table) {
+                for (int row = 0; row < 2; ++row) {
+                    for (int col = 0; col < 2; ++col) {
+                        position_planes[DynaRange::IO::Raw::BayerPlaneIndex(row, col)] = raw_file.GetBayerPlaneView({row, col});
+                    }
+                }
+                const bool has_all_planes = std::none_of(position_planes.begin(), position_planes.end(),
+                                                         [](const auto& position_plane) { return position_plane.empty(); });
+                if (has_all_planes) plane = position_planes[0];
+            }
+            const cv::Rect plane_area(0, 0, plane.cols, plane.rows);
+            if (!plane.empty() && !keystone.roi.empty() && (keystone.roi & plane_area) == keystone.roi) {
+                if (cfa_pattern) {
+                    sampler.emplace(plane, keystone, params.dark_value, params.saturation_value);
+                } else {
+                    sampler.emplace(position_planes, *cfa_table, GetCfaSite(channel), keystone, params.dark_value, params.saturation_value);
+                }
+            }
+        }
+
+        auto prepared_it = prepared_channels.find(channel);
+        if (prepared_it == prepared_channels.end()) {
+            if (!sampler) {
+                std::lock_guard<std::mutex> lock(log_mutex);
+                log_stream << _("Error: Failed to sample the chart from the mosaic for channel: ") << Formatters::DataSourceToString(channel) << " for file " << raw_file.GetFilename() << std::endl;
+                return;
+            }
+            // The integer engine keeps the patches as uint16 and normalizes only their statistics.
+            const bool integer_stats = (engine == PatchSamplingEngine::Integer);
+            const PatchSampler sample_patch = [&sampler, integer_stats](const cv::Rect& patch) {
+                return integer_stats ? sampler->SampleRawPatch(patch) : sampler->SamplePatch(patch);
+            };
+            channel_results[channel_index] = DynaRange::Engine::PerformTwoPassPatchAnalysis(
+                sample_patch, channel, chart, log_stream,
+                strict_min_snr_db, permissive_min_snr_db, max_requested_threshold,
+                log_mutex,
+                params.dark_value,
+                integer_stats ? std::optional<RawPatchLevels>(sampler->GetRawLevels()) : std::nullopt
+            );
+            return;
+        }
+
+        cv::Mat img_prepared = std::move(prepared_it->second);
         if (img_prepared.empty()) {
             std::lock_guard<std::mutex> lock(log_mutex);
             log_stream << _("Error: Failed to prepare image for channel: ") << Formatters::DataSourceToString(channel) << " for file " << raw_file.GetFilename() << std::endl;
-            continue;
+            return;
         }
 
-        bool should_draw_overlay = generate_debug_image && (channel == DataSource::G1);
-        individual_channel_patches[channel] = DynaRange::Engine::PerformTwoPassPatchAnalysis(
-            img_prepared, channel, chart, params.patch_ratio, log_stream,
+        if (engine == PatchSamplingEngine::Validate) {
+            // The comparison runs unlocked; only its report is appended under the lock.
+            std::ostringstream validation_log;
+            if (sampler) {
+                DynaRange::Engine::Processing::ValidatePatchSampling(img_prepared, *sampler, channel, chart.GetSamplingPlan(), validation_log);
+            } else {
+                validation_log << _("  - Sampling check [") << Formatters::DataSourceToString(channel) << _("]: the mosaic engine cannot read this file.") << std::endl;
+            }
+            std::lock_guard<std::mutex> lock(log_mutex);
+            log_stream << validation_log.str();
+        }
+
+        channel_results[channel_index] = DynaRange::Engine::PerformTwoPassPatchAnalysis(
+            img_prepared, channel, chart, log_stream,
             strict_min_snr_db, permissive_min_snr_db, max_requested_threshold, should_draw_overlay,
             log_mutex,
             params.dark_value
         );
+    });
+    if (cancel_flag) return {};
+
+    for (size_t i = 0; i < channels_to_analyze.size(); ++i) {
+        if (channel_results[i]) {
+            individual_channel_patches[channels_to_analyze[i]] = std::move(*channel_results[i]);
+        }
     }
 
     auto results = DynaRange::Engine::Processing::AggregateAndFinalizeResults(individual_channel_patches, raw_file, params, generate_debug_image, log_stream, log_mutex);
@@ -131,60 +232,125 @@ ProcessingResult AnalysisLoopRunner::Run()
     ProcessingResult result;
     std::mutex log_mutex;
 
-    cv::Mat keystone_params;
-    bool optimized = DynaRange::EngineConfig::OPTIMIZE_KEYSTONE_CALCULATION;
-    if (optimized) {
+    DynaRange::Graphics::Geometry::KeystoneRemap keystone;
+    if (DynaRange::EngineConfig::OPTIMIZE_KEYSTONE_CALCULATION) {
         std::lock_guard<std::mutex> lock(log_mutex);
-        m_log_stream <<  _("Using optimized keystone: calculating parameters once for the series...") << std::endl;
-        keystone_params = DynaRange::Graphics::Geometry::CalculateKeystoneParams(m_chart.GetCornerPoints(), m_chart.GetDestinationPoints());
+        m_log_stream <<  _("Using optimized keystone: calculating the crop area mapping once for the series...") << std::endl;
+        keystone = BuildKeystone();
     }
 
-    unsigned int num_threads = std::thread::hardware_concurrency();
-    if (num_threads == 0) {
-        num_threads = 1;
-    }
+    // Results are collected per file index so the output order never depends on thread timing.
+    std::vector<std::vector<SingleFileResult>> per_file_results = (m_params.max_inflight_frames > 0)
+        ? RunStreaming(keystone, log_mutex)
+        : RunBuffered(keystone, log_mutex);
 
-    for (size_t i = 0; i < m_raw_files.size(); i += num_threads) {
+    for (auto& file_results_vec : per_file_results) {
         if (m_cancel_flag) break;
-        std::vector<std::future<std::vector<SingleFileResult>>> batch_futures;
-
-        for (size_t j = i; j < std::min(i + num_threads, m_raw_files.size()); ++j) {
-            const auto& raw_file = m_raw_files[j];
-            if (!raw_file.IsLoaded()) continue;
+        for (auto& file_result : file_results_vec) {
+            if (!file_result.final_debug_image.empty()) {
+                result.debug_patch_image = file_result.final_debug_image;
+            }
 
-            bool generate_debug_image = (j == m_source_image_index && !m_params.print_patch_filename.empty());
-            batch_futures.push_back(std::async(std::launch::async,
-                // Captura m_params por referencia porque AnalysisLoopRunner vive durante la ejecución
-                [&, generate_debug_image, keystone_params, &raw_file = raw_file, camera_model = m_camera_model_name]() {
-                    cv::Mat local_keystone = keystone_params;
-                    if (!optimized) {
-                        local_keystone = DynaRange::Graphics::Geometry::CalculateKeystoneParams(m_chart.GetCornerPoints(), m_chart.GetDestinationPoints());
-                    }
-                    // m_params ya contiene generate_full_debug
-                    return AnalyzeSingleRawFile(raw_file, m_params, m_chart, local_keystone, m_log_stream, generate_debug_image, m_cancel_flag, log_mutex, m_paths, camera_model);
-                }
-            ));
+            if (!file_result.dr_result.filename.empty()) {
+                file_result.curve_data.camera_model = m_camera_model_name;
+                result.dr_results.push_back(file_result.dr_result);
+                result.curve_data.push_back(file_result.curve_data);
+            }
         }
+    }
 
-        for (auto& fut : batch_futures) {
-            if (m_cancel_flag) break;
-            std::vector<SingleFileResult> file_results_vec = fut.get();
-            for (auto& file_result : file_results_vec) {
+    return result;
+}
 
-                if (!file_result.final_debug_image.empty()) {
-                    std::lock_guard<std::mutex> lock(log_mutex);
-                    result.debug_patch_image = file_result.final_debug_image;
-                }
+DynaRange::Graphics::Geometry::KeystoneRemap AnalysisLoopRunner::BuildKeystone() const
+{
+    const cv::Mat keystone_params = DynaRange::Graphics::Geometry::CalculateKeystoneParams(m_chart.GetCornerPoints(), m_chart.GetDestinationPoints());
+    // An invalid crop area yields an empty mapping, reported by each channel's preparation.
+    return DynaRange::Graphics::Geometry::BuildKeystoneRemap(keystone_params, m_chart.GetCropArea().value_or(cv::Rect()));
+}
+
+std::vector<SingleFileResult> AnalysisLoopRunner::AnalyzeFile(size_t index, const DynaRange::Graphics::Geometry::KeystoneRemap& keystone, std::mutex& log_mutex) const
+{
+    DynaRange::Graphics::Geometry::KeystoneRemap local_keystone;
+    if (!DynaRange::EngineConfig::OPTIMIZE_KEYSTONE_CALCULATION) {
+        local_keystone = BuildKeystone();
+    }
+    bool generate_debug_image = (static_cast<int>(index) == m_source_image_index && !m_params.print_patch_filename.empty());
+    // m_params ya contiene generate_full_debug
+    return AnalyzeSingleRawFile(m_raw_files[index], m_params, m_chart, DynaRange::EngineConfig::OPTIMIZE_KEYSTONE_CALCULATION ? keystone : local_keystone, m_log_stream, generate_debug_image, m_cancel_flag, log_mutex, m_paths, m_camera_model_name);
+}
+
+std::vector<std::vector<SingleFileResult>> AnalysisLoopRunner::RunBuffered(const DynaRange::Graphics::Geometry::KeystoneRemap& keystone, std::mutex& log_mutex) const
+{
+    std::vector<std::vector<SingleFileResult>> per_file_results(m_raw_files.size());
+
+    // Files are spread over the shared pool; the channel and patch loops inside each
+    // file borrow idle threads from it instead of starting their own.
+    DynaRange::Utils::ThreadPool::Shared().ParallelFor(m_raw_files.size(), [&](size_t index) {
+        if (m_cancel_flag || !m_raw_files[index].IsLoaded()) return;
+        per_file_results[index] = AnalyzeFile(index, keystone, log_mutex);
+    });
+    return per_file_results;
+}
+
+std::vector<std::vector<SingleFileResult>> AnalysisLoopRunner::RunStreaming(const DynaRange::Graphics::Geometry::KeystoneRemap& keystone, std::mutex& log_mutex) const
+{
+    const size_t file_count = m_raw_files.size();
+    std::vector<std::vector<SingleFileResult>> per_file_results(file_count);
+
+    // Frames still decoded by the initialization go first, so they are analyzed
+    // before anything else is decoded; only frames it evicted are decoded here.
+    std::vector<size_t> order;
+    order.reserve(file_count);
+    for (size_t index = 0; index < file_count; ++index) {
+        if (m_raw_files[index].IsUnpacked()) order.push_back(index);
+    }
+    const size_t resident_count = order.size();
+    for (size_t index = 0; index < file_count; ++index) {
+        if (!m_raw_files[index].IsUnpacked()) order.push_back(index);
+    }
+
+    // The initialization's read-ahead ended with its decode cache: the frames decoded
+    // here are read ahead again, in the order the workers take them.
+    DynaRange::IO::Raw::RawPrefetcher prefetcher;
+    std::vector<std::string> to_decode;
+    to_decode.reserve(file_count - resident_count);
+    for (size_t position = resident_count; position < file_count; ++position) {
+        to_decode.push_back(m_raw_files[order[position]].GetFilename());
+    }
+    prefetcher.Schedule(to_decode);
 
-                if (!file_result.dr_result.filename.empty()) {
-                    file_result.curve_data.camera_model = m_camera_model_name;
-                    result.dr_results.push_back(file_result.dr_result);
-                    result.curve_data.push_back(file_result.curve_data);
+    // Each worker holds at most one frame: it decodes it, analyzes it and releases
+    // its pixel data before taking the next one, so at most max_inflight_frames
+    // frames are in memory. Workers at different stages overlap decoding with
+    // analysis; they run on the shared pool like the channel and patch loops.
+    const size_t max_inflight = static_cast<size_t>(m_params.max_inflight_frames);
+    const size_t num_workers = std::min({max_inflight, DynaRange::Utils::ThreadPool::Shared().GetConcurrency(), std::max<size_t>(file_count, 1)});
+    std::atomic<size_t> next_position{0};
+    std::atomic<size_t> decoded_count{0};
+    DynaRange::Utils::ThreadPool::Shared().ParallelFor(num_workers, [&](size_t) {
+        for (size_t position = next_position++; position < file_count && !m_cancel_flag; position = next_position++) {
+            const size_t index = order[position];
+            const RawFile& raw_file = m_raw_files[index];
+            if (!raw_file.IsLoaded()) continue;
+            if (!raw_file.IsUnpacked()) {
+                if (!raw_file.EnsureUnpacked(&prefetcher)) {
+                    std::lock_guard<std::mutex> lock(log_mutex);
+                    m_log_stream << _("Error: Could not decode RAW data from: ") << raw_file.GetFilename() << std::endl;
+                    continue;
                 }
+                decoded_count++;
             }
+            per_file_results[index] = AnalyzeFile(index, keystone, log_mutex);
+            raw_file.ReleasePixelData();
         }
-    }
+    });
 
-    return result;
+    {
+        std::lock_guard<std::mutex> lock(log_mutex);
+        m_log_stream << _("Streaming analysis: ") << resident_count << _(" frame(s) reused from initialization, ")
+                     << decoded_count.load() << _(" decoded.") << std::endl;
+    }
+    return per_file_results;
 }
-} // namespace DynaRange::Engine::Processing
\ No newline at end of file
+} // namespace DynaRange::Engine::Processing
@@ -5,18 +5,21 @@
  * @details This module adheres to SRP by encapsulating the entire loop execution,
  * including keystone optimization strategy and result aggregation, separating it
  * from the high-level orchestration in ProcessFiles.
- * It supports parallel execution.
+ * It supports parallel execution, either over files that are already decoded
+ * (buffered mode) or decoding them with a bounded number in flight (streaming mode).
  */
 #pragma once
 
 #include "Processing.hpp"
 #include "../../io/raw/RawFile.hpp"
 #include "../../setup/ChartProfile.hpp"
+#include "../../graphics/geometry/KeystoneCorrection.hpp"
 #include "../../utils/PathManager.hpp"
 #include <vector>
 #include <string>
 #include <ostream>
 #include <atomic>
+#include <mutex>
 
 namespace DynaRange::Engine::Processing {
 
@@ -50,11 +53,44 @@ public:
 
     /**
      * @brief Runs the analysis loop in parallel.
+     * @details If AnalysisParameters::max_inflight_frames is positive, at most that
+     * many frames are decoded at once, and each frame's pixel data is released as
+     * soon as it has been analyzed.
      * @return A ProcessingResult struct containing the aggregated results.
      */
     ProcessingResult Run();
 
 private:
+    /**
+     * @brief Builds the keystone mapping of the chart's crop area.
+     * @return The mapping, empty if the chart has no valid crop area.
+     */
+    DynaRange::Graphics::Geometry::KeystoneRemap BuildKeystone() const;
+
+    /**
+     * @brief Analyzes one file of the series.
+     * @param index The index of the file in the series.
+     * @param keystone The precomputed keystone mapping (if optimized).
+     * @param log_mutex The mutex serializing access to the log stream.
+     * @return The results for each analyzed channel of the file.
+     */
+    std::vector<SingleFileResult> AnalyzeFile(size_t index, const DynaRange::Graphics::Geometry::KeystoneRemap& keystone, std::mutex& log_mutex) const;
+
+    /**
+     * @brief Analyzes the already decoded files on the shared ThreadPool.
+     * @return The results of each file, indexed like the input series.
+     */
+    std::vector<std::vector<SingleFileResult>> RunBuffered(const DynaRange::Graphics::Geometry::KeystoneRemap& keystone, std::mutex& log_mutex) const;
+
+    /**
+     * @brief Decodes and analyzes files with a bounded number of frames in memory.
+     * @details At most max_inflight_frames files hold pixel data at any time. Files
+     * still decoded by the initialization are analyzed first and not decoded again;
+     * the others are read ahead by a RawPrefetcher in the order they are decoded.
+     * @return The results of each file, indexed like the input series.
+     */
+    std::vector<std::vector<SingleFileResult>> RunStreaming(const DynaRange::Graphics::Geometry::KeystoneRemap& keystone, std::mutex& log_mutex) const;
+
     const std::vector<RawFile>& m_raw_files;
     const AnalysisParameters& m_params;
     const ChartProfile& m_chart;
@@ -50,40 +50,25 @@ std::optional<std::vector<cv::Point2d>> AttemptAutomaticCornerDetection(
     }
 
     log_stream << _("Manual coordinates not provided, attempting automatic corner detection...") << std::endl;
-    cv::Mat raw_img = source_raw_file.GetActiveRawImage();
-    if (raw_img.empty()) {
+    // Corners are found on the G1 plane, the same site the analysis uses.
+    if (!source_raw_file.GetCfaTable()) {
+        log_stream << _("Error: Unsupported CFA pattern '") << source_raw_file.GetFilterPattern()
+                   << _("'; automatic corner detection needs a Bayer or X-Trans layout.") << std::endl;
+        return std::nullopt;
+    }
+
+    cv::Mat raw_plane = source_raw_file.GetCfaPlane(DynaRange::IO::Raw::CfaSite::G1);
+    if (raw_plane.empty()) {
          log_stream << _("Error: Could not get active raw image for corner detection.") << std::endl;
          return std::nullopt;
     }
 
-    // Normalize the raw image
-    cv::Mat img_float = NormalizeRawImage(raw_img, dark_value, saturation_value);
-    if (img_float.empty()) {
+    // Normalize only the extracted plane
+    cv::Mat g1_bayer = NormalizeRawImage(raw_plane, dark_value, saturation_value);
+    if (g1_bayer.empty()) {
         log_stream << _("Error: Normalization failed during corner detection.") << std::endl;
         return std::nullopt;
     }
-
-    // Extract the G1 Bayer channel (assuming G1 is needed for corner markers)
-    int bayer_rows = img_float.rows / 2;
-    int bayer_cols = img_float.cols / 2;
-    cv::Mat g1_bayer = cv::Mat::zeros(bayer_rows, bayer_cols, CV_32FC1);
-    std::string pattern = source_raw_file.GetFilterPattern();
-    // Calculate offsets based on pattern (simplified example for G1)
-    int r_offset = 0, c_offset = 1;
-    // Default for RGGB
-    if (pattern == "GRBG" || pattern == "GBRG") { r_offset = 0; c_offset = 0; }
-    else if (pattern == "BGGR") { r_offset = 1; c_offset = 1; }
-    // Add other patterns if necessary
-
-    for (int r = 0; r < bayer_rows; ++r) {
-        for (int c = 0; c < bayer_cols; ++c) {
-            int src_r = r * 2 + r_offset;
-            int src_c = c * 2 + c_offset;
-            if (src_r >= 0 && src_r < img_float.rows && src_c >= 0 && src_c < img_float.cols) {
-                 g1_bayer.at<float>(r, c) = img_float.at<float>(src_r, src_c);
-            }
-        }
-    }
     // Apply threshold (needed for corner detection algorithm)
     cv::Mat g1_bayer_thresh = g1_bayer.clone(); // Clone for detection
     cv::threshold(g1_bayer_thresh, g1_bayer_thresh, 0.0, 1.0, cv::THRESH_TOZERO);
@@ -0,0 +1,160 @@
+// File: src/core/engine/processing/MosaicPatchSampler.cpp
+/**
+ * @file src/core/engine/processing/MosaicPatchSampler.cpp
+ * @brief Implements the mosaic-native patch sampler and the engine cross-check.
+ */
+#include "MosaicPatchSampler.hpp"
+#include "../../analysis/Constants.hpp"
+#include "../../analysis/ImageAnalyzer.hpp"
+#include "../../analysis/PatchStatistics.hpp"
+#include "../../utils/Formatters.hpp"
+#include <algorithm>
+#include <cmath>
+#include <libintl.h>
+#include <limits>
+#include <utility>
+
+#define _(string) gettext(string)
+
+namespace DynaRange::Engine::Processing {
+
+namespace {
+
+/**
+ * @brief Compares patch statistics with cv::meanStdDev() of the same patch, shifted by its first pixel.
+ * @param stats The statistics to check.
+ * @param patch The patch they were computed from (CV_32FC1 or CV_16UC1).
+ * @param black_level, range The normalization applied to the statistics.
+ * @return The absolute mean difference and the relative standard deviation difference.
+ */
+std::pair<double, double> CompareWithMeanStdDev(const PatchStatistics& stats, const cv::Mat& patch, double black_level, double range) {
+    const double shift = patch.type() == CV_16UC1 ? patch.at<uint16_t>(0, 0) : patch.at<float>(0, 0);
+    cv::Mat shifted;
+    patch.convertTo(shifted, CV_64F, 1.0, -shift);
+    cv::Scalar mean, stddev;
+    cv::meanStdDev(shifted, mean, stddev);
+    const double reference_mean = (mean[0] + shift - black_level) / range;
+    const double reference_stddev = stddev[0] / range;
+    const double noise_diff = std::abs(stats.stddev - reference_stddev) / std::max(reference_stddev, std::numeric_limits<double>::min());
+    return {std::abs(stats.mean - reference_mean), noise_diff};
+}
+
+} // namespace
+
+MosaicPatchSampler::MosaicPatchSampler(const DynaRange::IO::Raw::BayerPlaneView& plane,
+                                       const DynaRange::Graphics::Geometry::KeystoneRemap& keystone,
+                                       double black_level, double saturation_level)
+    : m_plane(plane)
+    , m_keystone(keystone)
+    , m_levels{black_level, saturation_level}
+{
+    // Same single-precision scale and offset as NormalizeToFloat(). Its SIMD body may fuse
+    // the multiply-add, so the engines agree to within one rounding of it, not bit for bit.
+    const double scale = 1.0 / (saturation_level - black_level);
+    m_scale = static_cast<float>(scale);
+    m_offset = static_cast<float>(-black_level * scale);
+}
+
+MosaicPatchSampler::MosaicPatchSampler(const std::array<DynaRange::IO::Raw::BayerPlaneView, 4>& planes,
+                                       const DynaRange::IO::Raw::CfaTable& table, DynaRange::IO::Raw::CfaSite site,
+                                       const DynaRange::Graphics::Geometry::KeystoneRemap& keystone,
+                                       double black_level, double saturation_level)
+    : MosaicPatchSampler(planes[0], keystone, black_level, saturation_level)
+{
+    // m_plane (the first position plane) gives the block grid; the values come from all four.
+    m_planes = planes;
+    m_table = table;
+    m_site = site;
+}
+
+cv::Size MosaicPatchSampler::GetCropSize() const {
+    return m_keystone.roi.size();
+}
+
+cv::Mat MosaicPatchSampler::SamplePatch(const cv::Rect& patch) const {
+    return Sample<float>(patch, CV_32FC1, [this](uint16_t value) {
+        return static_cast<float>(value) * m_scale + m_offset;
+    }, 0.0f);
+}
+
+cv::Mat MosaicPatchSampler::SampleRawPatch(const cv::Rect& patch) const {
+    // Pixels without a source read as the black level, i.e. normalized 0 as in SamplePatch().
+    const auto black = static_cast<uint16_t>(std::clamp<long>(std::lround(m_levels.black_level), 0, 65535));
+    return Sample<uint16_t>(patch, CV_16UC1, [](uint16_t value) { return value; }, black);
+}
+
+RawPatchLevels MosaicPatchSampler::GetRawLevels() const {
+    return m_levels;
+}
+
+double ValidatePatchSampling(const cv::Mat& rectified_image, const MosaicPatchSampler& sampler, DataSource channel,
+                             const PatchSamplingPlan& plan, std::ostream& log_stream) {
+    const std::string channel_name = Formatters::DataSourceToString(channel);
+    if (rectified_image.size() != sampler.GetCropSize()) {
+        log_stream << _("  - Sampling check [") << channel_name << _("]: chart areas differ (")
+                   << rectified_image.cols << "x" << rectified_image.rows << " vs "
+                   << sampler.GetCropSize().width << "x" << sampler.GetCropSize().height << ")." << std::endl;
+        return std::numeric_limits<double>::infinity();
+    }
+
+    double max_signal_diff = 0.0;
+    double max_noise_diff = 0.0;
+    int compared = 0;
+    int mismatched = 0;
+    for (const PatchSpan& span : plan.spans) {
+        const cv::Rect rect = span.GetRect();
+
+        cv::Scalar rectified_mean, rectified_stddev, mosaic_mean, mosaic_stddev;
+        cv::meanStdDev(rectified_image(rect), rectified_mean, rectified_stddev);
+        cv::meanStdDev(sampler.SamplePatch(rect), mosaic_mean, mosaic_stddev);
+        const double signal_diff = std::abs(rectified_mean[0] - mosaic_mean[0]);
+        const double noise_diff = std::abs(rectified_stddev[0] - mosaic_stddev[0]);
+        max_signal_diff = std::max(max_signal_diff, signal_diff);
+        max_noise_diff = std::max(max_noise_diff, noise_diff);
+        ++compared;
+
+        if (signal_diff > DynaRange::Analysis::Constants::PATCH_SAMPLING_TOLERANCE ||
+            noise_diff > DynaRange::Analysis::Constants::PATCH_SAMPLING_TOLERANCE) {
+            ++mismatched;
+            log_stream << _("  - Sampling check [") << channel_name << _("] patch (")
+                       << span.grid_index / plan.grid_cols << ", " << span.grid_index % plan.grid_cols << _("): signal diff ")
+                       << signal_diff << _(", noise diff ") << noise_diff << std::endl;
+        }
+    }
+
+    log_stream << _("  - Sampling check [") << channel_name << "]: " << compared << _(" patches, ")
+               << mismatched << _(" differ; max signal diff ") << max_signal_diff
+               << _(", max noise diff ") << max_noise_diff << std::endl;
+
+    // The fused statistics kernels against cv::meanStdDev() on the same chart patches.
+    const RawPatchLevels levels = sampler.GetRawLevels();
+    const double raw_range = levels.saturation_level - levels.black_level;
+    double max_stats_mean_diff = 0.0;
+    double max_stats_noise_diff = 0.0;
+    const auto check_statistics = [&](const cv::Mat& patch) {
+        if (patch.empty()) return;
+        const bool is_raw = patch.type() == CV_16UC1;
+        const PatchStatistics stats = is_raw
+            ? ComputeIntegerPatchStatistics(patch, levels.black_level, levels.saturation_level, 1.0f)
+            : ComputePatchStatistics(patch, 1.0f);
+        const auto [mean_diff, noise_diff] = is_raw
+            ? CompareWithMeanStdDev(stats, patch, levels.black_level, raw_range)
+            : CompareWithMeanStdDev(stats, patch, 0.0, 1.0);
+        max_stats_mean_diff = std::max(max_stats_mean_diff, mean_diff);
+        max_stats_noise_diff = std::max(max_stats_noise_diff, noise_diff);
+    };
+    for (const PatchSpan& span : plan.spans) {
+        check_statistics(rectified_image(span.GetRect()));
+        check_statistics(sampler.SampleRawPatch(span.GetRect()));
+    }
+
+    const bool stats_match = max_stats_mean_diff <= DynaRange::Analysis::Constants::PATCH_STATISTICS_TOLERANCE &&
+                             max_stats_noise_diff <= DynaRange::Analysis::Constants::PATCH_STATISTICS_TOLERANCE;
+    log_stream << _("  - Statistics check [") << channel_name << "]: "
+               << (stats_match ? _("match cv::meanStdDev()") : _("DIFFER from cv::meanStdDev()"))
+               << _("; max mean diff ") << max_stats_mean_diff
+               << _(", max relative noise diff ") << max_stats_noise_diff << std::endl;
+    return std::max(max_signal_diff, max_noise_diff);
+}
+
+} // namespace DynaRange::Engine::Processing
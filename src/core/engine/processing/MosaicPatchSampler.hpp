@@ -0,0 +1,191 @@
+// File: src/core/engine/processing/MosaicPatchSampler.hpp
+/**
+ * @file src/core/engine/processing/MosaicPatchSampler.hpp
+ * @brief Declares the mosaic-native patch sampler and the engine cross-check.
+ * @details The rectified engine normalizes a whole Bayer plane, keystone-corrects it
+ * and crops the chart before measuring the patches. The mosaic engine skips all
+ * three images: each pixel of a patch is looked up in the keystone table of the
+ * crop area and read straight from the uint16 mosaic (or stored plane), so only
+ * patch-sized buffers are allocated per file.
+ *
+ * Layouts that are not 2x2 Bayer (X-Trans) have no plane holding each pixel of a color
+ * once, so their patches are read from the site's population instead (see
+ * CfaTable::GetSiteMask()).
+ */
+#pragma once
+
+#include "../../analysis/Analysis.hpp"
+#include "../../analysis/ImageAnalyzer.hpp"
+#include "../../analysis/PatchSamplingPlan.hpp"
+#include "../../graphics/geometry/KeystoneCorrection.hpp"
+#include "../../io/raw/BayerPlanes.hpp"
+#include "../../io/raw/CfaTable.hpp"
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+namespace DynaRange::Engine::Processing {
+
+/**
+ * @class MosaicPatchSampler
+ * @brief Reads the normalized pixels of a chart patch directly from one CFA sub-image.
+ */
+class MosaicPatchSampler {
+public:
+    /**
+     * @param plane The CFA sub-image of the analyzed channel; must outlive the sampler.
+     * @param keystone The keystone mapping of the chart crop area.
+     * @param black_level The black level used for normalization.
+     * @param saturation_level The saturation level used for normalization.
+     */
+    MosaicPatchSampler(const DynaRange::IO::Raw::BayerPlaneView& plane,
+                       const DynaRange::Graphics::Geometry::KeystoneRemap& keystone,
+                       double black_level, double saturation_level);
+
+    /**
+     * @brief Builds a sampler that reads a site's population through a CFA table.
+     * @details Each patch yields every pixel of the population in the blocks it covers,
+     * once, as a single row; the per-pixel layout of a rectified patch is not kept.
+     * @param planes The four position planes of the mosaic, indexed by BayerPlaneIndex();
+     *        must outlive the sampler.
+     * @param table The layout of the mosaic.
+     * @param site The site whose population is read.
+     * @param keystone The keystone mapping of the chart crop area.
+     * @param black_level The black level used for normalization.
+     * @param saturation_level The saturation level used for normalization.
+     */
+    MosaicPatchSampler(const std::array<DynaRange::IO::Raw::BayerPlaneView, 4>& planes,
+                       const DynaRange::IO::Raw::CfaTable& table, DynaRange::IO::Raw::CfaSite site,
+                       const DynaRange::Graphics::Geometry::KeystoneRemap& keystone,
+                       double black_level, double saturation_level);
+
+    /**
+     * @brief Gets the size of the chart area the patch grid is laid over.
+     */
+    cv::Size GetCropSize() const;
+
+    /**
+     * @brief Gets the pixels of a patch, as the rectified engine would see them.
+     * @param patch The patch rectangle in crop coordinates.
+     * @return A CV_32FC1 image of the patch's size, normalized by black and saturation
+     *         level; pixels without a source are 0. With a CFA table, a single row
+     *         holding the population of the covered blocks.
+     */
+    cv::Mat SamplePatch(const cv::Rect& patch) const;
+
+    /**
+     * @brief Gets the raw pixels of a patch, without normalization.
+     * @param patch The patch rectangle in crop coordinates.
+     * @return A CV_16UC1 image of the patch's size; pixels without a source read as the
+     *         black level. With a CFA table, a single row holding the population of the
+     *         covered blocks. Normalize its statistics with GetRawLevels().
+     */
+    cv::Mat SampleRawPatch(const cv::Rect& patch) const;
+
+    /**
+     * @brief Gets the black and saturation levels the sampler normalizes with.
+     */
+    RawPatchLevels GetRawLevels() const;
+
+private:
+    /**
+     * @brief Fills a patch-sized image by looking up each pixel through the keystone table.
+     * @param convert Maps a raw mosaic value to the output pixel type.
+     * @param missing The value of pixels without a source.
+     */
+    template <typename T, typename Convert>
+    cv::Mat Sample(const cv::Rect& patch, int type, Convert convert, T missing) const {
+        const cv::Rect bounds(0, 0, m_keystone.map.cols, m_keystone.map.rows);
+        if (m_plane.empty() || patch.empty() || (patch & bounds) != patch) {
+            return {};
+        }
+        if (m_table) {
+            return SamplePopulation<T>(patch, type, convert);
+        }
+        cv::Mat pixels(patch.size(), type);
+        for (int r = 0; r < patch.height; ++r) {
+            const short* source = m_keystone.map.ptr<short>(patch.y + r) + 2 * patch.x;
+            T* dst = pixels.ptr<T>(r);
+            for (int c = 0; c < patch.width; ++c) {
+                const int x = source[2 * c];
+                const int y = source[2 * c + 1];
+                dst[c] = (x >= 0 && y >= 0 && x < m_plane.cols && y < m_plane.rows)
+                    ? convert(m_plane.at(y, x))
+                    : missing;
+            }
+        }
+        return pixels;
+    }
+
+    /**
+     * @brief Reads the site's population in the blocks a patch maps to, each block once.
+     */
+    template <typename T, typename Convert>
+    cv::Mat SamplePopulation(const cv::Rect& patch, int type, Convert convert) const {
+        // The keystone map may hit a block several times; collect each block once.
+        std::vector<int64_t> blocks;
+        blocks.reserve(patch.area());
+        for (int r = 0; r < patch.height; ++r) {
+            const short* source = m_keystone.map.ptr<short>(patch.y + r) + 2 * patch.x;
+            for (int c = 0; c < patch.width; ++c) {
+                const int x = source[2 * c];
+                const int y = source[2 * c + 1];
+                if (x >= 0 && y >= 0 && x < m_plane.cols && y < m_plane.rows) {
+                    blocks.push_back(static_cast<int64_t>(y) * m_plane.cols + x);
+                }
+            }
+        }
+        std::sort(blocks.begin(), blocks.end());
+        blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+
+        std::vector<T> values;
+        values.reserve(blocks.size() * 2);
+        for (const int64_t block : blocks) {
+            const int y = static_cast<int>(block / m_plane.cols);
+            const int x = static_cast<int>(block % m_plane.cols);
+            const uint8_t mask = m_table->GetSiteMask(y, x, m_site);
+            for (int index = 0; index < 4; ++index) {
+                if (mask & (1 << index)) {
+                    values.push_back(convert(m_planes[index].at(y, x)));
+                }
+            }
+        }
+        if (values.empty()) {
+            return {};
+        }
+        cv::Mat pixels(1, static_cast<int>(values.size()), type);
+        std::copy(values.begin(), values.end(), pixels.ptr<T>(0));
+        return pixels;
+    }
+
+    DynaRange::IO::Raw::BayerPlaneView m_plane;
+    std::array<DynaRange::IO::Raw::BayerPlaneView, 4> m_planes{}; ///< Position planes, with m_table.
+    std::optional<DynaRange::IO::Raw::CfaTable> m_table;
+    DynaRange::IO::Raw::CfaSite m_site = DynaRange::IO::Raw::CfaSite::G1;
+    const DynaRange::Graphics::Geometry::KeystoneRemap& m_keystone;
+    RawPatchLevels m_levels;
+    float m_scale;
+    float m_offset;
+};
+
+/**
+ * @brief Measures every patch with both engines and logs how far they disagree.
+ * @details Compares the raw mean and standard deviation of each patch, before any
+ * patch filtering, so the report covers the whole grid. Also checks the fused
+ * statistics kernels (PatchStatistics.hpp) against cv::meanStdDev() on the same
+ * patches.
+ * @param rectified_image The cropped chart image of the rectified engine.
+ * @param sampler The mosaic sampler of the same channel.
+ * @param channel The channel being compared (for logging).
+ * @param plan The patch rectangles to compare.
+ * @param log_stream The output stream for the report.
+ * @return The largest absolute difference found, in normalized units.
+ */
+double ValidatePatchSampling(const cv::Mat& rectified_image, const MosaicPatchSampler& sampler, DataSource channel,
+                             const PatchSamplingPlan& plan, std::ostream& log_stream);
+
+} // namespace DynaRange::Engine::Processing
@@ -37,6 +37,10 @@ ProcessingResult ProcessFiles(
             paths, // Pass PathManager for debug image path generation inside
             log_stream
         );
+        if (params.max_inflight_frames > 0) {
+            // Streaming mode: the pipeline decodes the source file again when its turn comes.
+            raw_files[params.source_image_index].ReleasePixelData();
+        }
     } else if (!raw_files.empty()) {
         // Log a warning if the index is invalid but files exist? Could default to 0?
         log_stream << _("Warning: Invalid source_image_index provided. Skipping automatic corner detection.") << std::endl;
@@ -48,7 +52,7 @@ ProcessingResult ProcessFiles(
     // AnalysisParameters local_params = params; // Not needed currently
 
     // 3. Define the chart profile using manual, detected, or default corners.
-    ChartProfile chart(params.chart_coords, params.chart_patches_m, params.chart_patches_n, detected_corners_opt, log_stream);
+    ChartProfile chart(params.chart_coords, params.chart_patches_m, params.chart_patches_n, params.patch_ratio, detected_corners_opt, log_stream);
 
     // Get camera model name from the first loaded file (if any).
     std::string camera_model_name;
@@ -65,6 +69,9 @@ ProcessingResult ProcessFiles(
         num_threads = 1; // Fallback to at least one thread
     }
     log_stream << _("Starting parallel processing with ") << num_threads << _(" threads...") << std::endl;
+    if (params.max_inflight_frames > 0) {
+        log_stream << _("Streaming mode: at most ") << params.max_inflight_frames << _(" decoded file(s) in flight.") << std::endl;
+    }
 
     // 4. Delegate the entire analysis loop over all files to the specialized runner.
     // Pass const reference to params as it's not modified here.
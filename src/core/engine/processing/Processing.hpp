@@ -58,6 +58,16 @@ struct AnalysisParameters {
 
     /** @brief If true, generate extended debug images (pre/post keystone, crop). */
     bool generate_full_debug = false;
+
+    /**
+     * @brief Maximum number of decoded files in flight during analysis.
+     * @details 0 analyzes the files already decoded by initialization; a positive
+     * value streams them through a bounded decode/analyze pipeline.
+     */
+    int max_inflight_frames = 0;
+
+    /** @brief How patch pixels are read from the RAW data (see PatchSamplingEngine). */
+    PatchSamplingEngine sampling_engine = PatchSamplingEngine::Rectified;
 };
 /**
  * @struct SingleFileResult
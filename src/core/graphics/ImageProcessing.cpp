@@ -9,61 +9,52 @@
 #include "../artifacts/image/DebugImageWriter.hpp"
 #include "../utils/OutputNamingContext.hpp"   
 #include "../utils/OutputFilenameGenerator.hpp"
+#include "../utils/ThreadPool.hpp"
 #include <libintl.h>
 #include <opencv2/imgproc.hpp>
 #include <opencv2/imgcodecs.hpp>
+#include <optional>
+#include <sstream>
 #include <vector>
 
 #define _(string) gettext(string)
 
 namespace { // Anonymous namespace for internal helpers
 
-void ExtractBayerChannel(const cv::Mat& src, cv::Mat& dst, DataSource channel, const std::string& pattern) {
-    int r_offset = 0, c_offset = 0;
-
-    // Determine the row/column offsets for the top-left (0,0) pixel of the 2x2 Bayer block
-    if (pattern == "RGGB") {
-        if (channel == DataSource::R)  { r_offset = 0; c_offset = 0; }
-        if (channel == DataSource::G1) { r_offset = 0; c_offset = 1; }
-        if (channel == DataSource::G2) { r_offset = 1; c_offset = 0; }
-        if (channel == DataSource::B)  { r_offset = 1; c_offset = 1; }
-    } else if (pattern == "GRBG") {
-        if (channel == DataSource::G1) { r_offset = 0; c_offset = 0; }
-        if (channel == DataSource::R)  { r_offset = 0; c_offset = 1; }
-        if (channel == DataSource::B)  { r_offset = 1; c_offset = 0; }
-        if (channel == DataSource::G2) { r_offset = 1; c_offset = 1; }
-    } else if (pattern == "GBRG") {
-        if (channel == DataSource::G1) { r_offset = 0; c_offset = 0; }
-        if (channel == DataSource::B)  { r_offset = 0; c_offset = 1; }
-        if (channel == DataSource::R)  { r_offset = 1; c_offset = 0; }
-        if (channel == DataSource::G2) { r_offset = 1; c_offset = 1; }
-    } else if (pattern == "BGGR") {
-        if (channel == DataSource::B)  { r_offset = 0; c_offset = 0; }
-        if (channel == DataSource::G1) { r_offset = 0; c_offset = 1; }
-        if (channel == DataSource::G2) { r_offset = 1; c_offset = 0; }
-        if (channel == DataSource::R)  { r_offset = 1; c_offset = 1; }
-    } else { // Fallback to RGGB for unknown patterns
-        if (channel == DataSource::R)  { r_offset = 0; c_offset = 0; }
-        if (channel == DataSource::G1) { r_offset = 0; c_offset = 1; }
-        if (channel == DataSource::G2) { r_offset = 1; c_offset = 0; }
-        if (channel == DataSource::B)  { r_offset = 1; c_offset = 1; }
-    }
-
-    for (int r = 0; r < dst.rows; ++r) {
-        for (int c = 0; c < dst.cols; ++c) {
-            dst.at<float>(r, c) = src.at<float>(r * 2 + r_offset, c * 2 + c_offset);
-        }
+/**
+ * @brief Checks that the CFA layout of a file can be split into channels, reporting files where it cannot.
+ */
+bool HasCfaTableOrLog(const RawFile& raw_file, std::ostream& log_stream) {
+    if (!raw_file.GetCfaTable()) {
+        log_stream << _("Error: Unsupported CFA pattern '") << raw_file.GetFilterPattern() << _("' in file ")
+                   << raw_file.GetFilename() << _(". Only 2x2 Bayer layouts (RGGB, BGGR, GRBG, GBRG) and X-Trans can be analyzed.") << std::endl;
+        return false;
     }
-} 
+    return true;
+}
 
 } // end anonymous namespace/ end anonymous namespace
 
+DynaRange::IO::Raw::CfaSite GetCfaSite(DataSource channel) {
+    switch (channel) {
+        case DataSource::R:  return DynaRange::IO::Raw::CfaSite::R;
+        case DataSource::G2: return DynaRange::IO::Raw::CfaSite::G2;
+        case DataSource::B:  return DynaRange::IO::Raw::CfaSite::B;
+        default:             return DynaRange::IO::Raw::CfaSite::G1;
+    }
+}
+
 cv::Mat NormalizeRawImage(const cv::Mat& raw_image, double black_level, double sat_level)
 {
     if (raw_image.empty()) {
         return {};
     }
     cv::Mat float_img;
+    if (raw_image.type() == CV_16UC1) {
+        // Fused conversion and scaling, without the intermediate float image.
+        DynaRange::IO::Raw::NormalizeToFloat(raw_image, float_img, black_level, sat_level);
+        return float_img;
+    }
     raw_image.convertTo(float_img, CV_32F);
 
     // Normalize the image to a 0.0-1.0 range
@@ -241,48 +232,26 @@ cv::Mat PrepareDebugImageView(const cv::Mat& img_float) {
     return final_bgr_img;
 }
 
+namespace { // Anonymous namespace for internal helpers
+
 /**
- * @brief Prepares a single-channel Bayer image for analysis by extracting the channel,
- * normalizing its values, applying keystone correction, and cropping to the chart area.
- * Also handles saving intermediate debug images using the ApplyMinMaxNormalizationView method.
- * @param raw_file The source RawFile object, containing the image data and metadata.
- * @param dark_value The calibrated black level for normalization.
- * @param saturation_value The calibrated saturation level for normalization.
- * @param keystone_params The pre-calculated keystone transformation matrix.
- * @param chart The chart profile defining the geometry (corner points and grid size).
- * @param log_stream Stream for logging potential errors.
- * @param channel_to_extract The specific Bayer channel to extract (R, G1, G2, or B).
- * @param paths The PathManager for resolving debug output paths.
- * @param camera_model_name The camera model name (for debug filenames).
- * @param generate_full_debug Flag to enable extended debug image generation at runtime.
- * @return A fully prepared cv::Mat (CV_32FC1) for the specified channel, ready for patch analysis.
- * Returns an empty Mat on failure.
+ * @brief Applies keystone correction to a normalized Bayer plane and crops it to the chart area.
+ * @details Only the pixels of the crop area are remapped. Also saves the pre/post keystone
+ * and crop area debug images for the G1 channel when requested; only then is the whole
+ * plane corrected.
+ * @param imgBayer The normalized channel plane (CV_32FC1).
+ * @return The cropped plane (CV_32FC1), or an empty Mat on failure.
  */
-cv::Mat PrepareChartImage(
-    const RawFile& raw_file,
-    double dark_value,
-    double saturation_value,
-    const cv::Mat& keystone_params,
+cv::Mat PrepareNormalizedChannel(
+    const cv::Mat& imgBayer,
+    const DynaRange::Graphics::Geometry::KeystoneRemap& keystone,
     const ChartProfile& chart,
     std::ostream& log_stream,
     DataSource channel_to_extract,
     const PathManager& paths,
     const std::string& camera_model_name,
-    bool generate_full_debug // Flag from AnalysisParameters
-)
+    bool generate_full_debug)
 {
-    // Use the active raw image area, which excludes masked pixels.
-    cv::Mat raw_img = raw_file.GetActiveRawImage();
-    if(raw_img.empty()){
-        return {};
-    }
-    // Normalize based on black/saturation level (Range [0, ~1])
-    cv::Mat img_float = NormalizeRawImage(raw_img, dark_value, saturation_value);
-    // Extract the specific Bayer channel
-    cv::Mat imgBayer(img_float.rows / 2, img_float.cols / 2, CV_32FC1);
-    std::string filter_pattern = raw_file.GetFilterPattern();
-    ExtractBayerChannel(img_float, imgBayer, channel_to_extract, filter_pattern);
-
     // Determine if any debug images need generating for this call
     #if DYNA_RANGE_DEBUG_MODE == 1
     // Generation is enabled if either compile-time OR runtime flag is on, and it's G1 channel
@@ -321,34 +290,21 @@ cv::Mat PrepareChartImage(
         }
     }
 
-    // Apply Keystone correction (geometric transformation)
-    cv::Mat img_corrected = DynaRange::Graphics::Geometry::UndoKeystone(imgBayer, keystone_params);
-
-    // Get destination points and calculate crop area
-    const auto& dst_pts = chart.GetDestinationPoints();
-    double xtl = dst_pts[0].x; double ytl = dst_pts[0].y;
-    double xbr = dst_pts[2].x; double ybr = dst_pts[2].y;
-    double gap_x = 0.0;
-    double gap_y = 0.0;
-    // Apply gap only if corners were auto-detected or default (not manually specified)
-    if (!chart.HasManualCoords()) {
-        gap_x = (xbr - xtl) / (chart.GetGridCols() + 1) / 2.0;
-        gap_y = (ybr - ytl) / (chart.GetGridRows() + 1) / 2.0;
-    }
-    // Ensure crop dimensions are positive before creating Rect
-    double crop_width = round((xbr - gap_x) - (xtl + gap_x));
-    double crop_height = round((ybr - gap_y) - (ytl + gap_y));
-    if (crop_width <= 0 || crop_height <= 0) {
+    // The crop area and its keystone mapping are computed once per chart.
+    const cv::Rect& crop_area = keystone.roi;
+    if (crop_area.width <= 0 || crop_area.height <= 0) {
         log_stream << _("Error: Invalid crop area dimensions calculated after keystone correction (width or height <= 0).") << std::endl;
         return {}; // Return empty matrix
     }
-    cv::Rect crop_area(round(xtl + gap_x), round(ytl + gap_y), crop_width, crop_height);
-
+    const auto& dst_pts = chart.GetDestinationPoints();
+    double xtl = dst_pts[0].x; double ytl = dst_pts[0].y;
+    double xbr = dst_pts[2].x; double ybr = dst_pts[2].y;
 
     // --- DEBUG POST-KEYSTONE AND CROP AREA (using ApplyMinMaxNormalizationView) ---
     if (should_generate_debug) {
         log_stream << "  - [DEBUG] Saving post-keystone and crop area images..." << std::endl;
-        // Prepare the base debug view for the corrected image using the min/max method
+        // Prepare the base debug view for the whole corrected image using the min/max method
+        cv::Mat img_corrected = DynaRange::Graphics::Geometry::UndoKeystone(imgBayer, keystone.params);
         cv::Mat post_keystone_base_bgr = ApplyMinMaxNormalizationView(img_corrected);
         if (!post_keystone_base_bgr.empty()) {
             // Create copies for drawing different overlays
@@ -387,19 +343,121 @@ cv::Mat PrepareChartImage(
         }
     }
 
-    // Validate crop area boundaries against the *corrected* image dimensions
+    // Validate crop area boundaries against the corrected image dimensions (same as the plane's)
     if (crop_area.x < 0 || crop_area.y < 0 ||
-        crop_area.x + crop_area.width > img_corrected.cols ||
-        crop_area.y + crop_area.height > img_corrected.rows) {
+        crop_area.x + crop_area.width > imgBayer.cols ||
+        crop_area.y + crop_area.height > imgBayer.rows) {
         log_stream << _("Error: Invalid crop area calculated after keystone correction.")
                    << " Area: [" << crop_area.x << "," << crop_area.y << " - " << crop_area.width << "x" << crop_area.height << "]"
-                   << " Image: " << img_corrected.cols << "x" << img_corrected.rows << std::endl;
+                   << " Image: " << imgBayer.cols << "x" << imgBayer.rows << std::endl;
         return {}; // Return empty matrix
     }
 
-    // Return the final cropped image (img_corrected, *not* processed for viewing) for analysis
-    // Ensure clone is used if the ROI might be invalidated later
-    return img_corrected(crop_area).clone();
+    // Remap only the crop area (*not* processed for viewing) for analysis
+    return DynaRange::Graphics::Geometry::ApplyKeystoneRemap(imgBayer, keystone);
+}
+
+} // end anonymous namespace
+
+/**
+ * @brief Prepares a single-channel Bayer image for analysis by extracting the channel,
+ * normalizing its values, applying keystone correction, and cropping to the chart area.
+ * Also handles saving intermediate debug images using the ApplyMinMaxNormalizationView method.
+ * @param raw_file The source RawFile object, containing the image data and metadata.
+ * @param dark_value The calibrated black level for normalization.
+ * @param saturation_value The calibrated saturation level for normalization.
+ * @param keystone The keystone mapping of the chart crop area.
+ * @param chart The chart profile defining the geometry (corner points and grid size).
+ * @param log_stream Stream for logging potential errors.
+ * @param channel_to_extract The specific Bayer channel to extract (R, G1, G2, or B).
+ * @param paths The PathManager for resolving debug output paths.
+ * @param camera_model_name The camera model name (for debug filenames).
+ * @param generate_full_debug Flag to enable extended debug image generation at runtime.
+ * @return A fully prepared cv::Mat (CV_32FC1) for the specified channel, ready for patch analysis.
+ * Returns an empty Mat on failure.
+ */
+cv::Mat PrepareChartImage(
+    const RawFile& raw_file,
+    double dark_value,
+    double saturation_value,
+    const DynaRange::Graphics::Geometry::KeystoneRemap& keystone,
+    const ChartProfile& chart,
+    std::ostream& log_stream,
+    DataSource channel_to_extract,
+    const PathManager& paths,
+    const std::string& camera_model_name,
+    bool generate_full_debug // Flag from AnalysisParameters
+)
+{
+    // Fetch the Bayer plane of the requested channel (active area, excludes masked pixels).
+    if (!HasCfaTableOrLog(raw_file, log_stream)) {
+        return {};
+    }
+    cv::Mat raw_plane = raw_file.GetCfaPlane(GetCfaSite(channel_to_extract));
+    if(raw_plane.empty()){
+        return {};
+    }
+    // Normalize based on black/saturation level (Range [0, ~1]); only the quarter-size plane is converted.
+    cv::Mat imgBayer = NormalizeRawImage(raw_plane, dark_value, saturation_value);
+    return PrepareNormalizedChannel(imgBayer, keystone, chart, log_stream, channel_to_extract, paths, camera_model_name, generate_full_debug);
+}
+
+std::map<DataSource, cv::Mat> PrepareAllBayerChannels(
+    const RawFile& raw_file,
+    double dark_value,
+    double saturation_value,
+    const DynaRange::Graphics::Geometry::KeystoneRemap& keystone,
+    const ChartProfile& chart,
+    std::ostream& log_stream,
+    const std::vector<DataSource>& channels,
+    const PathManager& paths,
+    const std::string& camera_model_name,
+    bool generate_full_debug,
+    std::mutex& log_mutex)
+{
+    std::map<DataSource, cv::Mat> prepared_channels;
+    // The layout is resolved once per file.
+    std::ostringstream cfa_log;
+    if (!HasCfaTableOrLog(raw_file, cfa_log)) {
+        std::lock_guard<std::mutex> lock(log_mutex);
+        log_stream << cfa_log.str();
+        return prepared_channels;
+    }
+    // Bayer: one vectorized pass turns the whole mosaic into the four normalized planes.
+    const auto pattern = raw_file.GetCfaPattern();
+    DynaRange::IO::Raw::BayerPlaneSet normalized_planes;
+    if (pattern) {
+        normalized_planes = raw_file.GetNormalizedBayerPlanes(dark_value, saturation_value);
+    }
+
+    // The channels are remapped in parallel; each logs to its own buffer, flushed in channel order.
+    std::vector<cv::Mat> prepared(channels.size());
+    std::vector<std::ostringstream> channel_logs(channels.size());
+    DynaRange::Utils::ThreadPool::Shared().ParallelFor(channels.size(), [&](size_t i) {
+        cv::Mat imgBayer;
+        if (pattern) {
+            const auto offsets = DynaRange::IO::Raw::GetCfaOffsets(*pattern, GetCfaSite(channels[i]));
+            imgBayer = normalized_planes[DynaRange::IO::Raw::BayerPlaneIndex(offsets.row, offsets.col)];
+        } else {
+            // Other layouts (X-Trans) gather each channel through the CFA table, then normalize it.
+            DynaRange::IO::Raw::NormalizeToFloat(raw_file.GetCfaPlane(GetCfaSite(channels[i])), imgBayer, dark_value, saturation_value);
+        }
+        if (imgBayer.empty()) {
+            return;
+        }
+        prepared[i] = PrepareNormalizedChannel(imgBayer, keystone, chart, channel_logs[i], channels[i], paths, camera_model_name, generate_full_debug);
+    });
+    {
+        // Other files may be logging from the pool at the same time.
+        std::lock_guard<std::mutex> lock(log_mutex);
+        for (const auto& channel_log : channel_logs) {
+            log_stream << channel_log.str();
+        }
+    }
+    for (size_t i = 0; i < channels.size(); ++i) {
+        prepared_channels[channels[i]] = std::move(prepared[i]);
+    }
+    return prepared_channels;
 }
 
 /**
@@ -9,9 +9,18 @@
 #include "../setup/ChartProfile.hpp"
 #include "../analysis/Analysis.hpp" // For DataSource
 #include "../utils/PathManager.hpp"
+#include "geometry/KeystoneCorrection.hpp"
 #include <opencv2/core.hpp>
 #include <map>
+#include <mutex>
 #include <string> // Added for camera_model_name
+#include <vector>
+
+/**
+ * @brief Gets the site of an analysis channel inside the 2x2 Bayer block.
+ * @param channel R, G1, G2 or B (G1 is the top-row green).
+ */
+DynaRange::IO::Raw::CfaSite GetCfaSite(DataSource channel);
 
 cv::Mat NormalizeRawImage(const cv::Mat& raw_image, double black_level, double sat_level);
 /**
@@ -28,7 +37,7 @@ cv::Mat CreateFinalDebugImage(const cv::Mat& overlay_image, double max_pixel_val
  * @param raw_file The source RawFile object.
  * @param dark_value The black level for normalization.
  * @param saturation_value The saturation level for normalization.
- * @param keystone_params The pre-calculated keystone transformation parameters.
+ * @param keystone The keystone mapping of the chart crop area (see ChartProfile::GetCropArea()).
  * @param chart The chart profile defining the geometry.
  * @param log_stream Stream for logging messages.
  * @param channel_to_extract The specific Bayer channel to extract.
@@ -41,7 +50,7 @@ cv::Mat PrepareChartImage(
     const RawFile& raw_file,
     double dark_value,
     double saturation_value,
-    const cv::Mat& keystone_params,
+    const DynaRange::Graphics::Geometry::KeystoneRemap& keystone,
     const ChartProfile& chart,
     std::ostream& log_stream,
     DataSource channel_to_extract,
@@ -58,23 +67,37 @@ cv::Mat PrepareChartImage(
 cv::Mat& DrawCornerMarkers(cv::Mat& image, const std::vector<cv::Point2d>& corners); // Modified signature
 
 /**
- * @brief Prepares all four Bayer channels from a single RAW file in one pass.
+ * @brief Prepares several Bayer channels from a single RAW file in one pass.
+ * @details For Bayer files the mosaic is read once and normalized into all four
+ * planes by a vectorized kernel; other layouts (X-Trans) gather each channel
+ * through RawFile::GetCfaPlane(). Each requested plane is then keystone-corrected
+ * and cropped as in PrepareChartImage(), the planes in parallel on the shared ThreadPool.
  * @param raw_file The source RawFile object.
  * @param dark_value The black level for normalization.
  * @param saturation_value The saturation level for normalization.
- * @param keystone_params The pre-calculated keystone transformation parameters.
+ * @param keystone The keystone mapping of the chart crop area (see ChartProfile::GetCropArea()).
  * @param chart The chart profile defining the geometry.
  * @param log_stream Stream for logging messages.
- * @return A map where the key is the DataSource (R, G1, G2, B) and the value
- * is the fully prepared cv::Mat for that channel.
+ * @param channels The channels to prepare (R, G1, G2 and/or B).
+ * @param paths The PathManager for resolving debug output paths.
+ * @param camera_model_name The camera model name (for debug filenames).
+ * @param generate_full_debug Flag to enable extended debug image generation at runtime.
+ * @param log_mutex Mutex guarding @p log_stream, which other files may share.
+ * @return A map where the key is the DataSource and the value is the fully
+ * prepared cv::Mat for that channel (empty on failure).
  */
 std::map<DataSource, cv::Mat> PrepareAllBayerChannels(
     const RawFile& raw_file,
     double dark_value,
     double saturation_value,
-    const cv::Mat& keystone_params,
+    const DynaRange::Graphics::Geometry::KeystoneRemap& keystone,
     const ChartProfile& chart,
-    std::ostream& log_stream
+    std::ostream& log_stream,
+    const std::vector<DataSource>& channels,
+    const PathManager& paths,
+    const std::string& camera_model_name,
+    bool generate_full_debug,
+    std::mutex& log_mutex
 );
 /**
  * @brief Prepares a single-channel float image for visual debugging display using percentile-based stretching.
@@ -4,8 +4,10 @@
  * @brief Implements the geometric keystone correction functions.
  */
 #include "KeystoneCorrection.hpp"
+#include <climits>
 #include <cmath>
 #include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
 
 namespace DynaRange::Graphics::Geometry {
 
@@ -46,22 +48,54 @@ cv::Mat CalculateKeystoneParams(const std::vector<cv::Point2d>& src_points, cons
     return k;
 }
 
-cv::Mat UndoKeystone(const cv::Mat& imgSrc, const cv::Mat& k) {
-    int DIMX = imgSrc.cols;
-    int DIMY = imgSrc.rows;
-    cv::Mat imgCorrected = cv::Mat::zeros(DIMY, DIMX, CV_32FC1);
-    for (int y = 0; y < DIMY; ++y) {
-        for (int x = 0; x < DIMX; ++x) {
-            double denom = k.at<double>(6) * x + k.at<double>(7) * y + 1;
-            if (std::abs(denom) < 1e-9) continue;
-            int xu = static_cast<int>(round((k.at<double>(0) * x + k.at<double>(1) * y + k.at<double>(2)) / denom));
-            int yu = static_cast<int>(round((k.at<double>(3) * x + k.at<double>(4) * y + k.at<double>(5)) / denom));
-            if (xu >= 0 && xu < DIMX && yu >= 0 && yu < DIMY) {
-                imgCorrected.at<float>(y, x) = imgSrc.at<float>(yu, xu);
+KeystoneRemap BuildKeystoneRemap(const cv::Mat& k, const cv::Rect& roi) {
+    KeystoneRemap remap;
+    remap.params = k;
+    remap.roi = roi;
+    if (roi.width <= 0 || roi.height <= 0) {
+        return remap;
+    }
+    remap.map.create(roi.height, roi.width, CV_16SC2);
+
+    const double k0 = k.at<double>(0), k1 = k.at<double>(1), k2 = k.at<double>(2);
+    const double k3 = k.at<double>(3), k4 = k.at<double>(4), k5 = k.at<double>(5);
+    const double k6 = k.at<double>(6), k7 = k.at<double>(7);
+    const auto to_coordinate = [](double value) -> short {
+        // Anything outside the 16-bit range is outside any plane, so it is just "no source".
+        if (!(value > -1.0 && value < static_cast<double>(SHRT_MAX))) return -1;
+        return static_cast<short>(std::lround(value));
+    };
+
+    for (int row = 0; row < roi.height; ++row) {
+        const int y = roi.y + row;
+        short* dst = remap.map.ptr<short>(row);
+        for (int col = 0; col < roi.width; ++col) {
+            const int x = roi.x + col;
+            const double denom = k6 * x + k7 * y + 1;
+            short xu = -1, yu = -1;
+            if (std::abs(denom) >= 1e-9) {
+                xu = to_coordinate((k0 * x + k1 * y + k2) / denom);
+                yu = to_coordinate((k3 * x + k4 * y + k5) / denom);
+                if (xu < 0 || yu < 0) xu = yu = -1;
             }
+            dst[2 * col] = xu;
+            dst[2 * col + 1] = yu;
         }
     }
+    return remap;
+}
+
+cv::Mat ApplyKeystoneRemap(const cv::Mat& imgSrc, const KeystoneRemap& remap) {
+    if (imgSrc.empty() || remap.map.empty()) {
+        return {};
+    }
+    cv::Mat imgCorrected;
+    cv::remap(imgSrc, imgCorrected, remap.map, cv::Mat(), cv::INTER_NEAREST, cv::BORDER_CONSTANT, cv::Scalar(0));
     return imgCorrected;
 }
 
+cv::Mat UndoKeystone(const cv::Mat& imgSrc, const cv::Mat& k) {
+    return ApplyKeystoneRemap(imgSrc, BuildKeystoneRemap(k, cv::Rect(0, 0, imgSrc.cols, imgSrc.rows)));
+}
+
 } // namespace DynaRange::Graphics::Geometry
\ No newline at end of file
@@ -4,6 +4,9 @@
  * @brief Declares functions for geometric keystone correction.
  * @details This module encapsulates the mathematical logic for calculating
  * keystone transformation parameters and applying the correction to an image.
+ * The inverse mapping can be compiled once into a KeystoneRemap table covering
+ * only the destination area that is analyzed, and then applied to any number of
+ * planes of the same geometry.
  */
 #pragma once
 
@@ -20,6 +23,33 @@ namespace DynaRange::Graphics::Geometry {
  */
 cv::Mat CalculateKeystoneParams(const std::vector<cv::Point2d>& src_points, const std::vector<cv::Point2d>& dst_points);
 
+/**
+ * @struct KeystoneRemap
+ * @brief A precomputed inverse keystone mapping for a destination rectangle.
+ */
+struct KeystoneRemap {
+    cv::Mat params; ///< The 8 transformation parameters (k) the table was built from.
+    cv::Rect roi;   ///< The destination rectangle covered by the table.
+    cv::Mat map;    ///< CV_16SC2 source (x, y) of every pixel of roi; (-1, -1) where there is none.
+};
+
+/**
+ * @brief Builds the nearest-neighbour inverse mapping of a destination rectangle.
+ * @param k The 8 transformation parameters from CalculateKeystoneParams().
+ * @param roi The destination rectangle to cover (e.g. the chart crop area).
+ * @return The mapping table.
+ */
+KeystoneRemap BuildKeystoneRemap(const cv::Mat& k, const cv::Rect& roi);
+
+/**
+ * @brief Applies a precomputed keystone mapping to a single-channel float image.
+ * @details Pixels that map outside @p imgSrc are set to 0, as in UndoKeystone().
+ * @param imgSrc The source image (CV_32FC1).
+ * @param remap The mapping from BuildKeystoneRemap().
+ * @return A new cv::Mat of remap.roi's size with the rectified pixels.
+ */
+cv::Mat ApplyKeystoneRemap(const cv::Mat& imgSrc, const KeystoneRemap& remap);
+
 /**
  * @brief Applies an inverse keystone correction to a single-channel float image.
  * @param imgSrc The source image (CV_32FC1) to be corrected.
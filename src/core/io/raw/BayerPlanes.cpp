@@ -0,0 +1,219 @@
+// File: src/core/io/raw/BayerPlanes.cpp
+/**
+ * @file src/core/io/raw/BayerPlanes.cpp
+ * @brief Implements the CFA mosaic to plane (de)interleaving helpers.
+ */
+#include "BayerPlanes.hpp"
+#include <cstdint>
+#include <opencv2/core/hal/intrin.hpp>
+
+namespace DynaRange::IO::Raw {
+
+namespace {
+
+/**
+ * @brief Normalizes one row: dst[i] = src[i] * scale + offset.
+ */
+void NormalizeRow(const uint16_t* src, float* dst, int count, float scale, float offset) {
+    int i = 0;
+#if CV_SIMD128
+    const cv::v_float32x4 v_scale = cv::v_setall_f32(scale);
+    const cv::v_float32x4 v_offset = cv::v_setall_f32(offset);
+    for (; i <= count - cv::v_uint16x8::nlanes; i += cv::v_uint16x8::nlanes) {
+        cv::v_uint32x4 low, high;
+        cv::v_expand(cv::v_load(src + i), low, high);
+        cv::v_store(dst + i, cv::v_fma(cv::v_cvt_f32(cv::v_reinterpret_as_s32(low)), v_scale, v_offset));
+        cv::v_store(dst + i + cv::v_float32x4::nlanes, cv::v_fma(cv::v_cvt_f32(cv::v_reinterpret_as_s32(high)), v_scale, v_offset));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = static_cast<float>(src[i]) * scale + offset;
+    }
+}
+
+/**
+ * @brief Splits one mosaic row into its even and odd columns, normalizing both.
+ */
+void DeinterleaveNormalizeRow(const uint16_t* src, float* even_dst, float* odd_dst, int count, float scale, float offset) {
+    int i = 0;
+#if CV_SIMD128
+    const cv::v_float32x4 v_scale = cv::v_setall_f32(scale);
+    const cv::v_float32x4 v_offset = cv::v_setall_f32(offset);
+    for (; i <= count - cv::v_uint16x8::nlanes; i += cv::v_uint16x8::nlanes) {
+        cv::v_uint16x8 even, odd;
+        cv::v_load_deinterleave(src + 2 * i, even, odd);
+        cv::v_uint32x4 low, high;
+        cv::v_expand(even, low, high);
+        cv::v_store(even_dst + i, cv::v_fma(cv::v_cvt_f32(cv::v_reinterpret_as_s32(low)), v_scale, v_offset));
+        cv::v_store(even_dst + i + cv::v_float32x4::nlanes, cv::v_fma(cv::v_cvt_f32(cv::v_reinterpret_as_s32(high)), v_scale, v_offset));
+        cv::v_expand(odd, low, high);
+        cv::v_store(odd_dst + i, cv::v_fma(cv::v_cvt_f32(cv::v_reinterpret_as_s32(low)), v_scale, v_offset));
+        cv::v_store(odd_dst + i + cv::v_float32x4::nlanes, cv::v_fma(cv::v_cvt_f32(cv::v_reinterpret_as_s32(high)), v_scale, v_offset));
+    }
+#endif
+    for (; i < count; ++i) {
+        even_dst[i] = static_cast<float>(src[2 * i]) * scale + offset;
+        odd_dst[i] = static_cast<float>(src[2 * i + 1]) * scale + offset;
+    }
+}
+
+template <int RowOffset, int ColOffset>
+cv::Mat ExtractBayerPlaneKernel(const cv::Mat& mosaic) {
+    cv::Mat plane(mosaic.rows / 2, mosaic.cols / 2, CV_16UC1);
+    for (int r = 0; r < plane.rows; ++r) {
+        const uint16_t* src = mosaic.ptr<uint16_t>(2 * r + RowOffset) + ColOffset;
+        uint16_t* dst = plane.ptr<uint16_t>(r);
+        for (int c = 0; c < plane.cols; ++c) {
+            dst[c] = src[2 * c];
+        }
+    }
+    return plane;
+}
+
+} // namespace
+
+BayerPlaneView MakeBayerPlaneView(const cv::Mat& mosaic, CfaOffsets offsets) {
+    BayerPlaneView view;
+    if (mosaic.empty() || mosaic.type() != CV_16UC1 || offsets.row < 0 || offsets.row > 1 || offsets.col < 0 || offsets.col > 1) {
+        return view;
+    }
+    view.data = mosaic.ptr<uint16_t>(offsets.row) + offsets.col;
+    view.row_step = 2 * mosaic.step1();
+    view.col_step = 2;
+    view.rows = mosaic.rows / 2;
+    view.cols = mosaic.cols / 2;
+    return view;
+}
+
+BayerPlaneView MakeBayerPlaneView(const cv::Mat& plane) {
+    BayerPlaneView view;
+    if (plane.empty() || plane.type() != CV_16UC1) {
+        return view;
+    }
+    view.data = plane.ptr<uint16_t>(0);
+    view.row_step = plane.step1();
+    view.rows = plane.rows;
+    view.cols = plane.cols;
+    return view;
+}
+
+cv::Mat ExtractBayerPlane(const cv::Mat& mosaic, CfaOffsets offsets) {
+    if (mosaic.empty() || mosaic.type() != CV_16UC1) {
+        return {};
+    }
+    switch (BayerPlaneIndex(offsets.row, offsets.col)) {
+        case BayerPlaneIndex(0, 0): return ExtractBayerPlaneKernel<0, 0>(mosaic);
+        case BayerPlaneIndex(0, 1): return ExtractBayerPlaneKernel<0, 1>(mosaic);
+        case BayerPlaneIndex(1, 0): return ExtractBayerPlaneKernel<1, 0>(mosaic);
+        case BayerPlaneIndex(1, 1): return ExtractBayerPlaneKernel<1, 1>(mosaic);
+        default: return {};
+    }
+}
+
+BayerPlaneSet DeinterleaveBayerPlanes(const cv::Mat& mosaic, RawSummary* summary) {
+    BayerPlaneSet planes;
+    if (mosaic.empty() || mosaic.type() != CV_16UC1) {
+        return planes;
+    }
+    const int rows = mosaic.rows / 2;
+    const int cols = mosaic.cols / 2;
+    for (auto& plane : planes) {
+        plane.create(rows, cols, CV_16UC1);
+    }
+    // One pass over the mosaic: each pair of source rows feeds all four planes.
+    for (int r = 0; r < rows; ++r) {
+        const uint16_t* even_row = mosaic.ptr<uint16_t>(2 * r);
+        const uint16_t* odd_row = mosaic.ptr<uint16_t>(2 * r + 1);
+        uint16_t* p00 = planes[BayerPlaneIndex(0, 0)].ptr<uint16_t>(r);
+        uint16_t* p01 = planes[BayerPlaneIndex(0, 1)].ptr<uint16_t>(r);
+        uint16_t* p10 = planes[BayerPlaneIndex(1, 0)].ptr<uint16_t>(r);
+        uint16_t* p11 = planes[BayerPlaneIndex(1, 1)].ptr<uint16_t>(r);
+        for (int c = 0; c < cols; ++c) {
+            p00[c] = even_row[2 * c];
+            p01[c] = even_row[2 * c + 1];
+            p10[c] = odd_row[2 * c];
+            p11[c] = odd_row[2 * c + 1];
+        }
+        if (summary) {
+            summary->Accumulate(p00, cols, BayerPlaneIndex(0, 0));
+            summary->Accumulate(p01, cols, BayerPlaneIndex(0, 1));
+            summary->Accumulate(p10, cols, BayerPlaneIndex(1, 0));
+            summary->Accumulate(p11, cols, BayerPlaneIndex(1, 1));
+        }
+    }
+    if (summary) {
+        summary->Finalize();
+    }
+    return planes;
+}
+
+cv::Mat InterleaveBayerPlanes(const BayerPlaneSet& planes) {
+    for (const auto& plane : planes) {
+        if (plane.empty() || plane.type() != CV_16UC1 || plane.size() != planes[0].size()) {
+            return {};
+        }
+    }
+    const int rows = planes[0].rows;
+    const int cols = planes[0].cols;
+    cv::Mat mosaic(rows * 2, cols * 2, CV_16UC1);
+    for (int r = 0; r < rows; ++r) {
+        uint16_t* even_row = mosaic.ptr<uint16_t>(2 * r);
+        uint16_t* odd_row = mosaic.ptr<uint16_t>(2 * r + 1);
+        const uint16_t* p00 = planes[BayerPlaneIndex(0, 0)].ptr<uint16_t>(r);
+        const uint16_t* p01 = planes[BayerPlaneIndex(0, 1)].ptr<uint16_t>(r);
+        const uint16_t* p10 = planes[BayerPlaneIndex(1, 0)].ptr<uint16_t>(r);
+        const uint16_t* p11 = planes[BayerPlaneIndex(1, 1)].ptr<uint16_t>(r);
+        for (int c = 0; c < cols; ++c) {
+            even_row[2 * c] = p00[c];
+            even_row[2 * c + 1] = p01[c];
+            odd_row[2 * c] = p10[c];
+            odd_row[2 * c + 1] = p11[c];
+        }
+    }
+    return mosaic;
+}
+
+void NormalizeToFloat(const cv::Mat& src, cv::Mat& dst, double black_level, double saturation_level) {
+    if (src.empty() || src.type() != CV_16UC1) {
+        dst.release();
+        return;
+    }
+    dst.create(src.rows, src.cols, CV_32FC1);
+    const double scale = 1.0 / (saturation_level - black_level);
+    for (int r = 0; r < src.rows; ++r) {
+        NormalizeRow(src.ptr<uint16_t>(r), dst.ptr<float>(r), src.cols,
+                     static_cast<float>(scale), static_cast<float>(-black_level * scale));
+    }
+}
+
+BayerPlaneSet NormalizeBayerPlanes(const BayerPlaneSet& planes, double black_level, double saturation_level) {
+    BayerPlaneSet normalized;
+    for (size_t i = 0; i < planes.size(); ++i) {
+        NormalizeToFloat(planes[i], normalized[i], black_level, saturation_level);
+    }
+    return normalized;
+}
+
+BayerPlaneSet DeinterleaveNormalizedBayerPlanes(const cv::Mat& mosaic, double black_level, double saturation_level) {
+    BayerPlaneSet planes;
+    if (mosaic.empty() || mosaic.type() != CV_16UC1) {
+        return planes;
+    }
+    const int rows = mosaic.rows / 2;
+    const int cols = mosaic.cols / 2;
+    for (auto& plane : planes) {
+        plane.create(rows, cols, CV_32FC1);
+    }
+    const double scale = 1.0 / (saturation_level - black_level);
+    const float scale_f = static_cast<float>(scale);
+    const float offset_f = static_cast<float>(-black_level * scale);
+    for (int r = 0; r < rows; ++r) {
+        DeinterleaveNormalizeRow(mosaic.ptr<uint16_t>(2 * r), planes[BayerPlaneIndex(0, 0)].ptr<float>(r),
+                                 planes[BayerPlaneIndex(0, 1)].ptr<float>(r), cols, scale_f, offset_f);
+        DeinterleaveNormalizeRow(mosaic.ptr<uint16_t>(2 * r + 1), planes[BayerPlaneIndex(1, 0)].ptr<float>(r),
+                                 planes[BayerPlaneIndex(1, 1)].ptr<float>(r), cols, scale_f, offset_f);
+    }
+    return planes;
+}
+
+} // namespace DynaRange::IO::Raw
@@ -0,0 +1,118 @@
+// File: src/core/io/raw/BayerPlanes.hpp
+/**
+ * @file src/core/io/raw/BayerPlanes.hpp
+ * @brief Declares helpers to split a 2x2 CFA mosaic into four half-resolution planes.
+ * @details Planes are indexed by their position inside the 2x2 block of the active
+ * area (index = row_offset * 2 + col_offset), independently of the colors, so the
+ * mapping from a color channel to a plane is resolved later from the filter pattern.
+ */
+#pragma once
+
+#include "CfaPattern.hpp"
+#include "RawSummary.hpp"
+#include <opencv2/core/mat.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace DynaRange::IO::Raw {
+
+/// The four CFA sub-images of a 2x2 mosaic, indexed by BayerPlaneIndex().
+using BayerPlaneSet = std::array<cv::Mat, 4>;
+
+/**
+ * @brief Gets the plane index for a position inside the 2x2 CFA block.
+ * @param row_offset Row inside the block (0 or 1).
+ * @param col_offset Column inside the block (0 or 1).
+ * @return The plane index in [0, 3].
+ */
+constexpr int BayerPlaneIndex(int row_offset, int col_offset) {
+    return row_offset * 2 + col_offset;
+}
+
+/**
+ * @struct BayerPlaneView
+ * @brief A read-only, strided view of one CFA sub-image that copies nothing.
+ * @details Reads either a stored plane or every other sample of a mosaic. The
+ * viewed buffer must outlive the view (for a RawFile: until it is compacted or
+ * its pixel data is released).
+ */
+struct BayerPlaneView {
+    const uint16_t* data = nullptr; ///< First sample of the plane.
+    size_t row_step = 0;            ///< Distance between plane rows, in samples.
+    size_t col_step = 1;            ///< Distance between plane columns, in samples.
+    int rows = 0;
+    int cols = 0;
+
+    bool empty() const { return data == nullptr || rows <= 0 || cols <= 0; }
+    uint16_t at(int row, int col) const { return data[row * row_step + col * col_step]; }
+};
+
+/**
+ * @brief Views one CFA sub-image of a CV_16U mosaic in place.
+ * @return A view of size (rows/2, cols/2), like ExtractBayerPlane(), or an empty view
+ *         if the input is invalid.
+ */
+BayerPlaneView MakeBayerPlaneView(const cv::Mat& mosaic, CfaOffsets offsets);
+
+/**
+ * @brief Views a stored CV_16U plane.
+ */
+BayerPlaneView MakeBayerPlaneView(const cv::Mat& plane);
+
+/**
+ * @brief Copies one CFA sub-image out of a CV_16U mosaic.
+ * @details Dispatches to a kernel instantiated for the given offsets, so the
+ * inner loop has a constant stride and start.
+ * @param mosaic The single-channel CV_16U mosaic (typically the active area).
+ * @param offsets The site inside the 2x2 block (rows and columns 0 or 1).
+ * @return A CV_16U plane of size (rows/2, cols/2), or an empty matrix if the input is invalid.
+ */
+cv::Mat ExtractBayerPlane(const cv::Mat& mosaic, CfaOffsets offsets);
+
+/**
+ * @brief Splits a CV_16U mosaic into four CV_16U planes of size (rows/2, cols/2).
+ * @details A trailing odd row or column is dropped, matching the per-channel
+ * extraction used by the analysis.
+ * @param mosaic The single-channel CV_16U mosaic (typically the active area).
+ * @param summary If not nullptr, receives the histogram summary of the planes,
+ *        built in the same pass while the rows are still in cache.
+ * @return The four planes, or empty matrices if the input is invalid.
+ */
+BayerPlaneSet DeinterleaveBayerPlanes(const cv::Mat& mosaic, RawSummary* summary = nullptr);
+
+/**
+ * @brief Rebuilds a CV_16U mosaic of size (2 * plane rows, 2 * plane cols) from its planes.
+ * @param planes The four planes produced by DeinterleaveBayerPlanes().
+ * @return The interleaved mosaic, or an empty matrix if the planes are invalid.
+ */
+cv::Mat InterleaveBayerPlanes(const BayerPlaneSet& planes);
+
+/**
+ * @brief Converts a CV_16U image to CV_32F normalized by black and saturation level.
+ * @details Computes (value - black_level) / (saturation_level - black_level) in a
+ * single vectorized pass, without intermediate images.
+ * @param src The CV_16UC1 source image.
+ * @param dst Receives the CV_32FC1 result (reallocated if needed).
+ * @param black_level The black level.
+ * @param saturation_level The saturation level.
+ */
+void NormalizeToFloat(const cv::Mat& src, cv::Mat& dst, double black_level, double saturation_level);
+
+/**
+ * @brief Normalizes the four planes of a compacted file to CV_32F.
+ * @return The four normalized planes, indexed like the input.
+ */
+BayerPlaneSet NormalizeBayerPlanes(const BayerPlaneSet& planes, double black_level, double saturation_level);
+
+/**
+ * @brief Splits a CV_16U mosaic and normalizes it to four CV_32F planes in one pass.
+ * @details Each pair of mosaic rows is read once and feeds all four planes; the
+ * even/odd columns are separated with vector deinterleaving loads.
+ * @param mosaic The single-channel CV_16U mosaic (typically the active area).
+ * @return The four normalized planes, indexed by BayerPlaneIndex(), or empty matrices
+ *         if the input is invalid.
+ */
+BayerPlaneSet DeinterleaveNormalizedBayerPlanes(const cv::Mat& mosaic, double black_level, double saturation_level);
+
+} // namespace DynaRange::IO::Raw
@@ -0,0 +1,81 @@
+// File: src/core/io/raw/CfaPattern.hpp
+/**
+ * @file src/core/io/raw/CfaPattern.hpp
+ * @brief Defines the descriptor of the four 2x2 Bayer CFA layouts.
+ * @details The position of each color inside the 2x2 block is resolved once per file
+ * with GetCfaOffsets(); per-pixel kernels then work on the resulting offsets (or on
+ * the deinterleaved planes), so they do not depend on the layout.
+ *
+ * G1 is the green site on the top row of the block and G2 the one on the bottom row.
+ * Tiles that are not 2x2 Bayer (X-Trans) are described by CfaTable (CfaTable.hpp).
+ */
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace DynaRange::IO::Raw {
+
+/// The 2x2 Bayer layouts, named by their top-left block read in raster order.
+enum class CfaPattern { RGGB, BGGR, GRBG, GBRG };
+
+/// The four sites of a 2x2 Bayer block.
+enum class CfaSite { R, G1, G2, B };
+
+/**
+ * @struct CfaOffsets
+ * @brief The row and column of a site inside the 2x2 block.
+ */
+struct CfaOffsets {
+    int row;
+    int col;
+};
+
+/**
+ * @brief Gets the offsets of a site inside the 2x2 block of a layout.
+ */
+constexpr CfaOffsets GetCfaOffsets(CfaPattern pattern, CfaSite site) {
+    // Rows of the table: RGGB, BGGR, GRBG, GBRG; columns: R, G1, G2, B.
+    constexpr CfaOffsets table[4][4] = {
+        {{0, 0}, {0, 1}, {1, 0}, {1, 1}},
+        {{1, 1}, {0, 1}, {1, 0}, {0, 0}},
+        {{0, 1}, {0, 0}, {1, 1}, {1, 0}},
+        {{1, 0}, {0, 0}, {1, 1}, {0, 1}},
+    };
+    return table[static_cast<int>(pattern)][static_cast<int>(site)];
+}
+
+/**
+ * @brief Parses a pattern description such as "RGGB" (case-insensitive).
+ * @return The layout, or std::nullopt if the text is not one of the four Bayer layouts.
+ */
+inline std::optional<CfaPattern> ParseCfaPattern(const std::string& text) {
+    std::string upper = text;
+    for (char& c : upper) {
+        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+    }
+    if (upper == "RGGB") return CfaPattern::RGGB;
+    if (upper == "BGGR") return CfaPattern::BGGR;
+    if (upper == "GRBG") return CfaPattern::GRBG;
+    if (upper == "GBRG") return CfaPattern::GBRG;
+    return std::nullopt;
+}
+
+/**
+ * @brief Gets the canonical name of a layout.
+ */
+constexpr const char* GetCfaPatternName(CfaPattern pattern) {
+    switch (pattern) {
+        case CfaPattern::RGGB: return "RGGB";
+        case CfaPattern::BGGR: return "BGGR";
+        case CfaPattern::GRBG: return "GRBG";
+        case CfaPattern::GBRG: return "GBRG";
+    }
+    return "";
+}
+
+static_assert(GetCfaOffsets(CfaPattern::RGGB, CfaSite::G1).row == 0 && GetCfaOffsets(CfaPattern::BGGR, CfaSite::G1).row == 0 &&
+              GetCfaOffsets(CfaPattern::GRBG, CfaSite::G1).row == 0 && GetCfaOffsets(CfaPattern::GBRG, CfaSite::G1).row == 0,
+              "G1 must be the top-row green of every layout");
+
+} // namespace DynaRange::IO::Raw
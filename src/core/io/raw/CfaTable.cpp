@@ -0,0 +1,145 @@
+// File: src/core/io/raw/CfaTable.cpp
+/**
+ * @file src/core/io/raw/CfaTable.cpp
+ * @brief Implements the CFA gather tables and the generic channel extraction.
+ */
+#include "CfaTable.hpp"
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+namespace DynaRange::IO::Raw {
+
+namespace {
+
+/// Position of each site in an RGGB block, which the sites are named after.
+constexpr CfaOffsets SITE_REFERENCE[4] = {{0, 0}, {0, 1}, {1, 0}, {1, 1}};
+/// Color of each site.
+constexpr char SITE_COLOR[4] = {'R', 'G', 'G', 'B'};
+
+/// Whether the pixel of a tile belongs to a site: greens on even rows are G1, on odd rows G2.
+constexpr bool IsInPopulation(char color, int row, int site) {
+    if (color != SITE_COLOR[site]) return false;
+    if (color != 'G') return true;
+    return (row & 1) == (site == static_cast<int>(CfaSite::G2) ? 1 : 0);
+}
+/// Offsets searched around a block: a 4x4 window holds every color of an X-Trans tile.
+constexpr int SEARCH_MIN = -1;
+constexpr int SEARCH_MAX = 2;
+
+/// Floor division by two, valid for the negative offsets of the search window.
+constexpr int FloorHalf(int value) {
+    return (value - (value & 1)) / 2;
+}
+
+} // end anonymous namespace
+
+std::optional<CfaTable> CfaTable::FromColors(const std::string& colors, int period) {
+    if (period < 2 || period > MAX_CFA_PERIOD || period % 2 != 0 || colors.size() != static_cast<size_t>(period * period)) {
+        return std::nullopt;
+    }
+    std::string tile = colors;
+    for (char& c : tile) {
+        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+        if (c != 'R' && c != 'G' && c != 'B') return std::nullopt;
+    }
+    const auto color_at = [&tile, period](int row, int col) {
+        return tile[((row % period + period) % period) * period + (col % period + period) % period];
+    };
+
+    CfaTable table;
+    table.m_period = period;
+    const int phases = period / 2;
+    for (int phase_row = 0; phase_row < phases; ++phase_row) {
+        for (int phase_col = 0; phase_col < phases; ++phase_col) {
+            CfaOffsets chosen[4] = {};
+            for (int site = 0; site < 4; ++site) {
+                uint8_t mask = 0;
+                for (int dy = 0; dy < 2; ++dy) {
+                    for (int dx = 0; dx < 2; ++dx) {
+                        if (IsInPopulation(color_at(2 * phase_row + dy, 2 * phase_col + dx), 2 * phase_row + dy, site)) {
+                            mask |= static_cast<uint8_t>(1 << BayerPlaneIndex(dy, dx));
+                        }
+                    }
+                }
+                table.m_site_masks[(phase_row * phases + phase_col) * 4 + site] = mask;
+
+                // Ranked by: outside the block, squared distance to the site, row, column.
+                std::tuple<int, int, int, int> best{std::numeric_limits<int>::max(), 0, 0, 0};
+                bool found = false;
+                for (int dy = SEARCH_MIN; dy <= SEARCH_MAX; ++dy) {
+                    for (int dx = SEARCH_MIN; dx <= SEARCH_MAX; ++dx) {
+                        if (!IsInPopulation(color_at(2 * phase_row + dy, 2 * phase_col + dx), dy, site)) continue;
+                        const int outside = (dy < 0 || dy > 1 || dx < 0 || dx > 1) ? 1 : 0;
+                        const int distance = (dy - SITE_REFERENCE[site].row) * (dy - SITE_REFERENCE[site].row) +
+                                             (dx - SITE_REFERENCE[site].col) * (dx - SITE_REFERENCE[site].col);
+                        const std::tuple<int, int, int, int> rank{outside, distance, dy, dx};
+                        if (rank < best) {
+                            best = rank;
+                            chosen[site] = {dy, dx};
+                            found = true;
+                        }
+                    }
+                }
+                if (!found) {
+                    return std::nullopt;
+                }
+                table.m_offsets[(phase_row * phases + phase_col) * 4 + site] = {
+                    static_cast<int8_t>(BayerPlaneIndex(chosen[site].row & 1, chosen[site].col & 1)),
+                    static_cast<int8_t>(FloorHalf(chosen[site].row)),
+                    static_cast<int8_t>(FloorHalf(chosen[site].col))};
+            }
+        }
+    }
+    return table;
+}
+
+CfaTable CfaTable::FromPattern(CfaPattern pattern) {
+    // The four Bayer layouts are always valid tiles.
+    return *FromColors(GetCfaPatternName(pattern), 2);
+}
+
+cv::Mat GatherCfaPlane(const std::array<BayerPlaneView, 4>& planes, const CfaTable& table, CfaSite site) {
+    const int rows = planes[0].rows;
+    const int cols = planes[0].cols;
+    for (const auto& plane : planes) {
+        if (plane.empty() || plane.rows != rows || plane.cols != cols) {
+            return {};
+        }
+    }
+
+    const int phases = table.GetBlockPhases();
+    cv::Mat channel(rows, cols, CV_16UC1);
+    for (int r = 0; r < rows; ++r) {
+        // Source row, column shift and stride of each column phase, resolved once per row.
+        const uint16_t* source[MAX_CFA_PERIOD / 2];
+        int shift[MAX_CFA_PERIOD / 2];
+        size_t step[MAX_CFA_PERIOD / 2];
+        for (int k = 0; k < phases; ++k) {
+            const CfaGatherOffset& offset = table.GetGatherOffset(r, k, site);
+            const BayerPlaneView& plane = planes[offset.plane];
+            source[k] = plane.data + static_cast<size_t>(std::clamp(r + offset.row, 0, rows - 1)) * plane.row_step;
+            shift[k] = offset.col;
+            step[k] = plane.col_step;
+        }
+        const auto read_clamped = [&](int c) {
+            const int k = c % phases;
+            return source[k][static_cast<size_t>(std::clamp(c + shift[k], 0, cols - 1)) * step[k]];
+        };
+
+        uint16_t* dst = channel.ptr<uint16_t>(r);
+        // Offsets reach at most one column away, so only the edge columns need clamping.
+        dst[0] = read_clamped(0);
+        int k = (cols > 1) ? 1 % phases : 0;
+        for (int c = 1; c < cols - 1; ++c) {
+            dst[c] = source[k][static_cast<size_t>(c + shift[k]) * step[k]];
+            if (++k == phases) k = 0;
+        }
+        if (cols > 1) {
+            dst[cols - 1] = read_clamped(cols - 1);
+        }
+    }
+    return channel;
+}
+
+} // namespace DynaRange::IO::Raw
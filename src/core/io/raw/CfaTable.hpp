@@ -0,0 +1,118 @@
+// File: src/core/io/raw/CfaTable.hpp
+/**
+ * @file src/core/io/raw/CfaTable.hpp
+ * @brief Declares the table-driven description of arbitrary CFA tiles (Bayer, X-Trans).
+ * @details The analysis works on half-resolution channel planes with one sample per
+ * 2x2 block and CfaSite. For the Bayer layouts those are the position planes of
+ * BayerPlanes.hpp. Other tiles (the 6x6 Fujifilm X-Trans) do not repeat their
+ * colors every 2x2 block, so the pixel each block contributes to a channel depends
+ * on the block's phase within the tile. CfaTable precomputes that pixel for every
+ * phase and site once, so a channel is still extracted in a single gather pass.
+ *
+ * A 6x6 X-Trans tile holds 8 red, 8 blue and 20 green pixels for 9 blocks, so no
+ * half-resolution plane can hold each pixel of a color exactly once. CfaTable also
+ * keeps the real color populations of every block (GetSiteMask()), which measurements
+ * that do not need a regular grid read instead.
+ */
+#pragma once
+
+#include "BayerPlanes.hpp"
+#include <opencv2/core/mat.hpp>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace DynaRange::IO::Raw {
+
+/// Largest CFA tile side supported (X-Trans).
+constexpr int MAX_CFA_PERIOD = 6;
+
+/**
+ * @struct CfaGatherOffset
+ * @brief Where a 2x2 block reads the sample of one site, on the four position planes.
+ */
+struct CfaGatherOffset {
+    int8_t plane; ///< BayerPlaneIndex() of the position plane holding the pixel.
+    int8_t row;   ///< Row of the pixel in that plane, relative to the block's row.
+    int8_t col;   ///< Column of the pixel in that plane, relative to the block's column.
+};
+
+/**
+ * @class CfaTable
+ * @brief Precomputed gather offsets of every CfaSite for every 2x2 block phase of a tile.
+ * @details Greens on even rows belong to G1 and greens on odd rows to G2, as in a
+ * Bayer block; with R and B this splits every tile into four disjoint site
+ * populations. For the gather, each site takes the pixel of its population closest
+ * to the site's position in an RGGB block, preferring pixels inside the block. For
+ * the four Bayer layouts this is exactly GetCfaOffsets(). For X-Trans, every 4x4
+ * window holds all four populations, so offsets stay within one pixel of the block;
+ * one red and one blue pixel per tile feed two blocks and two greens are left out.
+ */
+class CfaTable {
+public:
+    /**
+     * @brief Builds the table of a tile.
+     * @param colors The colors of the tile in raster order ('R', 'G' or 'B', case-insensitive).
+     * @param period The side of the square tile (2, 4 or 6).
+     * @return The table, or std::nullopt if the tile is invalid or lacks a color.
+     */
+    static std::optional<CfaTable> FromColors(const std::string& colors, int period);
+
+    /**
+     * @brief Builds the table of a 2x2 Bayer layout.
+     */
+    static CfaTable FromPattern(CfaPattern pattern);
+
+    /// @brief Gets the side of the tile, in pixels.
+    int GetPeriod() const { return m_period; }
+
+    /// @brief Gets the number of 2x2 block phases along each axis (period / 2).
+    int GetBlockPhases() const { return m_period / 2; }
+
+    /**
+     * @brief Gets where a block reads the sample of a site.
+     * @param block_row The block's row (i.e. the row in the channel plane).
+     * @param block_col The block's column.
+     * @param site The site.
+     */
+    const CfaGatherOffset& GetGatherOffset(int block_row, int block_col, CfaSite site) const {
+        const int phases = GetBlockPhases();
+        return m_offsets[((block_row % phases) * phases + (block_col % phases)) * 4 + static_cast<int>(site)];
+    }
+
+    /**
+     * @brief Gets which pixels of a block belong to a site's population.
+     * @details Bit BayerPlaneIndex(row, col) is set for each pixel of the block in the
+     * population. The masks of the four sites partition every block, so reading them
+     * visits each pixel of the mosaic exactly once.
+     * @param block_row The block's row (i.e. the row in the position planes).
+     * @param block_col The block's column.
+     * @param site The site.
+     */
+    uint8_t GetSiteMask(int block_row, int block_col, CfaSite site) const {
+        const int phases = GetBlockPhases();
+        return m_site_masks[((block_row % phases) * phases + (block_col % phases)) * 4 + static_cast<int>(site)];
+    }
+
+private:
+    CfaTable() = default;
+
+    int m_period = 2;
+    std::array<CfaGatherOffset, (MAX_CFA_PERIOD / 2) * (MAX_CFA_PERIOD / 2) * 4> m_offsets{};
+    std::array<uint8_t, (MAX_CFA_PERIOD / 2) * (MAX_CFA_PERIOD / 2) * 4> m_site_masks{};
+};
+
+/**
+ * @brief Gathers one channel plane from the four position planes of a mosaic.
+ * @details One pass over the output; the source row of each column phase is resolved
+ * from the table once per row, and only the first and last columns are clamped.
+ * @param planes The position planes, indexed by BayerPlaneIndex() (see MakeBayerPlaneView()).
+ * @param table The layout of the mosaic.
+ * @param site The site to gather.
+ * @return A CV_16U plane of the size of the position planes, or an empty matrix if
+ *         the planes are missing or inconsistent.
+ */
+cv::Mat GatherCfaPlane(const std::array<BayerPlaneView, 4>& planes, const CfaTable& table, CfaSite site);
+
+} // namespace DynaRange::IO::Raw
@@ -0,0 +1,37 @@
+// File: src/core/io/raw/Constants.hpp
+/**
+ * @file src/core/io/raw/Constants.hpp
+ * @brief Centralizes constants related to RAW file ingestion.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace DynaRange::IO::Raw::Constants {
+
+    /**
+     * @brief Maximum number of files the I/O thread reads ahead of the decoder.
+     * @details Bounds the page cache pressure of prefetching while still keeping
+     * the next file resident by the time the decoder asks for it.
+     */
+    constexpr size_t PREFETCH_WINDOW_FILES = 2;
+
+    /**
+     * @brief Extensions (lowercase, without dot) read by the plain mosaic backend
+     * instead of LibRaw. "bin" and "r16" are headerless dumps described by a sidecar.
+     */
+    constexpr std::array<const char*, 7> PLAIN_MOSAIC_EXTENSIONS = { "pgm", "npy", "fits", "fit", "fts", "bin", "r16" };
+
+    /**
+     * @brief Suffix of the key=value sidecar describing a plain mosaic file.
+     * @details Looked up as "<file>.meta" first, then with the extension replaced.
+     */
+    constexpr const char* MOSAIC_SIDECAR_EXTENSION = ".meta";
+
+    /**
+     * @brief Name prefix of in-memory synthetic sources registered with SyntheticRawSource.
+     */
+    constexpr const char* SYNTHETIC_SOURCE_PREFIX = "synthetic://";
+
+} // namespace DynaRange::IO::Raw::Constants
@@ -0,0 +1,62 @@
+// File: src/core/io/raw/LibRawSource.cpp
+/**
+ * @file src/core/io/raw/LibRawSource.cpp
+ * @brief Implements the LibRaw backend for camera RAW files.
+ */
+#include "LibRawSource.hpp"
+#include "RawImageAccessor.hpp"
+#include "RawLoader.hpp"
+#include "RawMetadataExtractor.hpp"
+#include <utility>
+
+namespace DynaRange::IO::Raw {
+
+LibRawSource::LibRawSource(std::string filename) : m_filename(std::move(filename)) {}
+
+LibRawSource::~LibRawSource() = default;
+
+bool LibRawSource::Open(std::shared_ptr<MappedFile> mapped_file) {
+    m_raw_processor = RawLoader::Open(m_filename, std::move(mapped_file));
+    if (!m_raw_processor) {
+        return false;
+    }
+    m_image_accessor = std::make_unique<RawImageAccessor>(m_raw_processor);
+    m_metadata_extractor = std::make_unique<RawMetadataExtractor>(m_raw_processor);
+    return true;
+}
+
+RawMetadata LibRawSource::GetMetadata() const {
+    return m_metadata_extractor ? m_metadata_extractor->GetSnapshot() : RawMetadata{};
+}
+
+bool LibRawSource::Unpack() {
+    // The LibRaw instance was released earlier: reopen the file to decode it again.
+    if (!m_raw_processor && !Open(nullptr)) {
+        return false;
+    }
+    return RawLoader::Unpack(*m_raw_processor);
+}
+
+void LibRawSource::Release() {
+    m_image_accessor.reset();
+    m_metadata_extractor.reset();
+    m_raw_processor.reset();
+}
+
+cv::Mat LibRawSource::GetRawImage() const {
+    return m_image_accessor ? m_image_accessor->GetRawImage() : cv::Mat();
+}
+
+cv::Mat LibRawSource::GetActiveRawView() const {
+    return m_image_accessor ? m_image_accessor->GetActiveRawView() : cv::Mat();
+}
+
+cv::Mat LibRawSource::GetActiveRawImage() const {
+    return m_image_accessor ? m_image_accessor->GetActiveRawImage() : cv::Mat();
+}
+
+cv::Mat LibRawSource::GetProcessedImage() {
+    return m_image_accessor ? m_image_accessor->GetProcessedImage() : cv::Mat();
+}
+
+} // namespace DynaRange::IO::Raw
@@ -0,0 +1,42 @@
+// File: src/core/io/raw/LibRawSource.hpp
+/**
+ * @file src/core/io/raw/LibRawSource.hpp
+ * @brief Declares the LibRaw backend for camera RAW files.
+ */
+#pragma once
+
+#include "RawSource.hpp"
+
+class LibRaw;
+
+namespace DynaRange::IO::Raw {
+
+class RawImageAccessor;
+class RawMetadataExtractor;
+
+/**
+ * @class LibRawSource
+ * @brief Reads camera RAW files through RawLoader, RawImageAccessor and RawMetadataExtractor.
+ */
+class LibRawSource : public RawSource {
+public:
+    explicit LibRawSource(std::string filename);
+    ~LibRawSource() override;
+
+    bool Open(std::shared_ptr<MappedFile> mapped_file) override;
+    RawMetadata GetMetadata() const override;
+    bool Unpack() override;
+    void Release() override;
+    cv::Mat GetRawImage() const override;
+    cv::Mat GetActiveRawView() const override;
+    cv::Mat GetActiveRawImage() const override;
+    cv::Mat GetProcessedImage() override;
+
+private:
+    std::string m_filename;
+    std::shared_ptr<LibRaw> m_raw_processor;
+    std::unique_ptr<RawImageAccessor> m_image_accessor;
+    std::unique_ptr<RawMetadataExtractor> m_metadata_extractor;
+};
+
+} // namespace DynaRange::IO::Raw
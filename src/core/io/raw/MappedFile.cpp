@@ -0,0 +1,118 @@
+// File: src/core/io/raw/MappedFile.cpp
+/**
+ * @file src/core/io/raw/MappedFile.cpp
+ * @brief Implements the read-only memory-mapped file.
+ */
+#include "MappedFile.hpp"
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DynaRange::IO::Raw {
+
+namespace {
+    // Granularity used when touching pages during prefetch.
+    constexpr size_t PREFETCH_PAGE_SIZE = 4096;
+}
+
+MappedFile::MappedFile(std::string filename) : m_filename(std::move(filename)) {}
+
+MappedFile::~MappedFile() {
+    if (!m_is_mapped) return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(static_cast<HANDLE>(m_mapping_handle));
+    CloseHandle(static_cast<HANDLE>(m_file_handle));
+#else
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+}
+
+std::shared_ptr<MappedFile> MappedFile::Open(const std::string& filename) {
+    std::shared_ptr<MappedFile> file(new MappedFile(filename));
+
+#ifdef _WIN32
+    HANDLE file_handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                     OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_handle != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(file_handle, &size) && size.QuadPart > 0) {
+            HANDLE mapping = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) {
+                void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                if (view) {
+                    file->m_data = static_cast<const uint8_t*>(view);
+                    file->m_size = static_cast<size_t>(size.QuadPart);
+                    file->m_file_handle = file_handle;
+                    file->m_mapping_handle = mapping;
+                    file->m_is_mapped = true;
+                    return file;
+                }
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file_handle);
+    }
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                // LibRaw reads mostly front to back; ask the kernel for aggressive readahead.
+                madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+                file->m_data = static_cast<const uint8_t*>(addr);
+                file->m_size = static_cast<size_t>(st.st_size);
+                file->m_is_mapped = true;
+                ::close(fd); // The mapping stays valid after closing the descriptor.
+                return file;
+            }
+        }
+        ::close(fd);
+    }
+#endif
+
+    // Fallback: read the whole file into memory.
+    std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+    if (!stream) {
+        return nullptr;
+    }
+    std::streamsize size = stream.tellg();
+    if (size <= 0) {
+        return nullptr;
+    }
+    stream.seekg(0, std::ios::beg);
+    file->m_fallback_buffer.resize(static_cast<size_t>(size));
+    if (!stream.read(reinterpret_cast<char*>(file->m_fallback_buffer.data()), size)) {
+        return nullptr;
+    }
+    file->m_data = file->m_fallback_buffer.data();
+    file->m_size = file->m_fallback_buffer.size();
+    return file;
+}
+
+size_t MappedFile::Prefetch() const {
+    if (!m_is_mapped) {
+        return 0; // The fallback buffer is already fully resident.
+    }
+#ifndef _WIN32
+    madvise(const_cast<uint8_t*>(m_data), m_size, MADV_WILLNEED);
+#endif
+    // Touch one byte per page so the reads happen on this thread, not the decoder's.
+    volatile uint8_t sink = 0;
+    for (size_t offset = 0; offset < m_size; offset += PREFETCH_PAGE_SIZE) {
+        sink ^= m_data[offset];
+    }
+    (void)sink;
+    return m_size;
+}
+
+} // namespace DynaRange::IO::Raw
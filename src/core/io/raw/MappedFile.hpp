@@ -0,0 +1,77 @@
+// File: src/core/io/raw/MappedFile.hpp
+/**
+ * @file src/core/io/raw/MappedFile.hpp
+ * @brief Declares a read-only memory-mapped view of a file on disk.
+ * @details Used to hand RAW files to LibRaw through open_buffer(), so the data is
+ * read by the kernel's paging/readahead machinery instead of buffered reads
+ * issued synchronously from the decoding thread.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace DynaRange::IO::Raw {
+
+/**
+ * @struct IngestionStats
+ * @brief Per-file I/O accounting for the RAW ingestion layer.
+ */
+struct IngestionStats {
+    size_t bytes_read = 0;   ///< Bytes of the file brought into memory.
+    double stall_ms = 0.0;   ///< Time the opening thread waited for the file data.
+    double unpack_ms = 0.0;  ///< Time spent decoding the pixel data.
+    int unpack_count = 0;    ///< Number of times the pixel data was decoded.
+    bool was_prefetched = false; ///< True if the data was read ahead by the I/O thread.
+};
+
+/**
+ * @class MappedFile
+ * @brief Owns a read-only mapping (or, as a fallback, an in-memory copy) of a file.
+ */
+class MappedFile {
+public:
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Maps a file into memory for sequential reading.
+     * @details Falls back to reading the whole file into memory if the platform
+     * cannot map it (e.g. some network filesystems).
+     * @param filename The path to the file.
+     * @return The mapped file, or nullptr if the file could not be opened.
+     */
+    static std::shared_ptr<MappedFile> Open(const std::string& filename);
+
+    const uint8_t* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+    const std::string& GetFilename() const { return m_filename; }
+
+    /**
+     * @brief Forces the whole file into the page cache by touching every page.
+     * @details Intended to be called from a dedicated I/O thread so that the
+     * decoding thread does not block on disk reads later.
+     * @return The number of bytes read from the file.
+     */
+    size_t Prefetch() const;
+
+private:
+    explicit MappedFile(std::string filename);
+
+    std::string m_filename;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_is_mapped = false;
+    std::vector<uint8_t> m_fallback_buffer;
+#ifdef _WIN32
+    void* m_file_handle = nullptr;
+    void* m_mapping_handle = nullptr;
+#endif
+};
+
+} // namespace DynaRange::IO::Raw
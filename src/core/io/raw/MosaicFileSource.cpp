@@ -0,0 +1,330 @@
+// File: src/core/io/raw/MosaicFileSource.cpp
+/**
+ * @file src/core/io/raw/MosaicFileSource.cpp
+ * @brief Implements the backend for plain, undecoded CFA mosaics.
+ */
+#include "MosaicFileSource.hpp"
+#include "CfaPattern.hpp"
+#include "Constants.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+namespace DynaRange::IO::Raw {
+
+namespace {
+
+    bool IsLittleEndianHost() {
+        const uint16_t probe = 1;
+        uint8_t first_byte;
+        std::memcpy(&first_byte, &probe, 1);
+        return first_byte == 1;
+    }
+
+    std::string ToLower(std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return text;
+    }
+
+    std::string ToUpper(std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        return text;
+    }
+
+    std::string Trim(const std::string& text, const char* characters = " \t\r\n") {
+        const size_t first = text.find_first_not_of(characters);
+        if (first == std::string::npos) return "";
+        return text.substr(first, text.find_last_not_of(characters) - first + 1);
+    }
+
+    /**
+     * @brief Reads the next unsigned integer of a PGM header, skipping whitespace and comments.
+     * @return The value, or -1 if the header is malformed.
+     */
+    long ReadPgmNumber(const uint8_t* data, size_t size, size_t& pos) {
+        while (pos < size) {
+            if (data[pos] == '#') {
+                while (pos < size && data[pos] != '\n') ++pos;
+            } else if (std::isspace(data[pos])) {
+                ++pos;
+            } else {
+                break;
+            }
+        }
+        if (pos >= size || !std::isdigit(data[pos])) return -1;
+        long value = 0;
+        while (pos < size && std::isdigit(data[pos]) && value < 1000000000L) {
+            value = value * 10 + (data[pos++] - '0');
+        }
+        return value;
+    }
+
+    /**
+     * @brief Gets the value of a key in the Python dict literal of an .npy header.
+     */
+    std::string GetNpyHeaderValue(const std::string& header, const std::string& key) {
+        const size_t key_pos = header.find("'" + key + "'");
+        if (key_pos == std::string::npos) return "";
+        const size_t colon = header.find(':', key_pos);
+        const size_t start = colon == std::string::npos ? colon : header.find_first_not_of(' ', colon + 1);
+        if (start == std::string::npos) return "";
+        if (header[start] == '(') {
+            const size_t end = header.find(')', start);
+            return end == std::string::npos ? "" : Trim(header.substr(start + 1, end - start - 1));
+        }
+        const size_t end = header.find_first_of(",}", start);
+        return end == std::string::npos ? "" : Trim(header.substr(start, end - start), " '\"");
+    }
+
+    uint32_t ReadLittleEndian(const uint8_t* data, int bytes) {
+        uint32_t value = 0;
+        for (int i = bytes - 1; i >= 0; --i) {
+            value = (value << 8) | data[i];
+        }
+        return value;
+    }
+
+} // namespace
+
+MosaicFileSource::MosaicFileSource(std::string filename) : m_filename(std::move(filename)) {}
+
+bool MosaicFileSource::Open(std::shared_ptr<MappedFile> mapped_file) {
+    m_mapped_file = mapped_file ? std::move(mapped_file) : MappedFile::Open(m_filename);
+    m_image.release();
+    m_layout = Layout{};
+    m_metadata = RawMetadata{};
+    if (!m_mapped_file || !ParseContainer()) {
+        m_mapped_file.reset();
+        return false;
+    }
+    ApplySidecar();
+
+    const size_t sample_count = static_cast<size_t>(std::max(0, m_layout.width)) * static_cast<size_t>(std::max(0, m_layout.height));
+    const bool is_complete = sample_count > 0 &&
+        m_layout.data_offset + sample_count * static_cast<size_t>(m_layout.bytes_per_sample) <= m_mapped_file->GetSize();
+    if (!is_complete) {
+        m_mapped_file.reset();
+        return false;
+    }
+
+    m_metadata.raw_width = m_metadata.active_width = m_layout.width;
+    m_metadata.raw_height = m_metadata.active_height = m_layout.height;
+    m_metadata.sensor_resolution_mpx = static_cast<double>(sample_count) / 1000000.0;
+    if (!m_metadata.bit_depth) {
+        m_metadata.bit_depth = m_layout.bytes_per_sample * 8;
+    }
+    m_metadata.has_raw_mosaic = ParseCfaPattern(m_metadata.filter_pattern).has_value();
+    return true;
+}
+
+bool MosaicFileSource::ParseContainer() {
+    const uint8_t* data = m_mapped_file->GetData();
+    const size_t size = m_mapped_file->GetSize();
+    std::string extension = ToLower(std::filesystem::path(m_filename).extension().string());
+
+    if (extension == ".pgm") {
+        if (size < 2 || data[0] != 'P' || data[1] != '5') return false;
+        size_t pos = 2;
+        const long width = ReadPgmNumber(data, size, pos);
+        const long height = ReadPgmNumber(data, size, pos);
+        const long max_value = ReadPgmNumber(data, size, pos);
+        if (width <= 0 || height <= 0 || max_value <= 0 || max_value > 65535 || pos >= size) return false;
+        m_layout.width = static_cast<int>(width);
+        m_layout.height = static_cast<int>(height);
+        m_layout.data_offset = pos + 1; // A single whitespace character ends the header.
+        m_layout.bytes_per_sample = max_value > 255 ? 2 : 1;
+        m_layout.is_big_endian = true;
+        m_metadata.bit_depth = static_cast<int>(std::ceil(std::log2(static_cast<double>(max_value))));
+        return true;
+    }
+
+    if (extension == ".npy") {
+        if (size < 12 || std::memcmp(data, "\x93NUMPY", 6) != 0) return false;
+        const int major_version = data[6];
+        const size_t header_start = major_version == 1 ? 10 : 12;
+        const size_t header_length = ReadLittleEndian(data + 8, major_version == 1 ? 2 : 4);
+        if (header_start + header_length > size) return false;
+        const std::string header(reinterpret_cast<const char*>(data + header_start), header_length);
+
+        const std::string descr = GetNpyHeaderValue(header, "descr");
+        if (descr == "<u2") m_layout.bytes_per_sample = 2;
+        else if (descr == ">u2") { m_layout.bytes_per_sample = 2; m_layout.is_big_endian = true; }
+        else if (descr == "|u1" || descr == "<u1") m_layout.bytes_per_sample = 1;
+        else return false;
+        if (GetNpyHeaderValue(header, "fortran_order") != "False") return false;
+
+        const std::string shape_text = GetNpyHeaderValue(header, "shape");
+        if (std::count(shape_text.begin(), shape_text.end(), ',') != 1 || shape_text.back() == ',') return false; // 2-D only.
+        std::istringstream shape(shape_text);
+        char separator = 0;
+        int height = 0, width = 0;
+        if (!(shape >> height >> separator >> width) || separator != ',') return false;
+        m_layout.width = width;
+        m_layout.height = height;
+        m_layout.data_offset = header_start + header_length;
+        return true;
+    }
+
+    if (extension == ".fits" || extension == ".fit" || extension == ".fts") {
+        constexpr size_t CARD_SIZE = 80;
+        constexpr size_t BLOCK_SIZE = 2880;
+        int bit_pix = 0, axes = 0;
+        for (size_t pos = 0; pos + CARD_SIZE <= size; pos += CARD_SIZE) {
+            const std::string card(reinterpret_cast<const char*>(data + pos), CARD_SIZE);
+            const std::string key = Trim(card.substr(0, 8));
+            if (key == "END") {
+                m_layout.data_offset = (pos / BLOCK_SIZE + 1) * BLOCK_SIZE;
+                break;
+            }
+            if (card.compare(8, 2, "= ") != 0) continue;
+            std::string value = Trim(card.substr(10));
+            if (!value.empty() && value[0] == '\'') {
+                value = Trim(value.substr(1, value.find('\'', 1) - 1)); // Quoted string.
+            } else {
+                value = Trim(value.substr(0, value.find('/')));
+            }
+            if (key == "BITPIX") bit_pix = std::atoi(value.c_str());
+            else if (key == "NAXIS") axes = std::atoi(value.c_str());
+            else if (key == "NAXIS1") m_layout.width = std::atoi(value.c_str());
+            else if (key == "NAXIS2") m_layout.height = std::atoi(value.c_str());
+            else if (key == "BZERO") m_layout.value_offset = static_cast<int>(std::lround(std::atof(value.c_str())));
+            else if (key == "BAYERPAT") m_metadata.filter_pattern = ToUpper(value);
+            else if (key == "ISOSPEED") m_metadata.iso_speed = static_cast<float>(std::atof(value.c_str()));
+            else if (key == "INSTRUME") m_metadata.camera_model = value;
+        }
+        if (m_layout.data_offset == 0 || axes != 2 || (bit_pix != 8 && bit_pix != 16)) return false;
+        m_layout.bytes_per_sample = bit_pix / 8;
+        m_layout.is_big_endian = true;
+        m_layout.is_signed = bit_pix == 16; // FITS stores 16-bit data signed, unsigned via BZERO.
+        return true;
+    }
+
+    // Headerless dump: the geometry comes from the sidecar alone.
+    return true;
+}
+
+void MosaicFileSource::ApplySidecar() {
+    std::ifstream sidecar(m_filename + Constants::MOSAIC_SIDECAR_EXTENSION);
+    if (!sidecar) {
+        sidecar.open(std::filesystem::path(m_filename).replace_extension(Constants::MOSAIC_SIDECAR_EXTENSION));
+    }
+    if (!sidecar) return;
+
+    std::string line;
+    while (std::getline(sidecar, line)) {
+        line = Trim(line);
+        const size_t separator = line.find('=');
+        if (line.empty() || line[0] == '#' || separator == std::string::npos) continue;
+        const std::string key = ToLower(Trim(line.substr(0, separator)));
+        const std::string value = Trim(line.substr(separator + 1));
+        if (key == "width") m_layout.width = std::atoi(value.c_str());
+        else if (key == "height") m_layout.height = std::atoi(value.c_str());
+        else if (key == "header_bytes") m_layout.data_offset = static_cast<size_t>(std::max(0L, std::atol(value.c_str())));
+        else if (key == "byte_order") m_layout.is_big_endian = ToLower(value) == "big";
+        else if (key == "cfa") m_metadata.filter_pattern = ToUpper(value);
+        else if (key == "black_level") m_metadata.black_level = std::atoi(value.c_str());
+        else if (key == "iso") m_metadata.iso_speed = static_cast<float>(std::atof(value.c_str()));
+        else if (key == "camera") m_metadata.camera_model = value;
+        else if (key == "white_level") {
+            const double white_level = std::atof(value.c_str());
+            if (white_level > 0) {
+                m_metadata.bit_depth = static_cast<int>(std::ceil(std::log2(white_level)));
+            }
+        }
+    }
+}
+
+RawMetadata MosaicFileSource::GetMetadata() const {
+    return m_metadata;
+}
+
+bool MosaicFileSource::Unpack() {
+    if (!m_mapped_file && !Open(nullptr)) return false;
+    if (!m_image.empty()) return true;
+
+    const uint8_t* samples = m_mapped_file->GetData() + m_layout.data_offset;
+    const bool is_native = m_layout.bytes_per_sample == 2 && !m_layout.is_signed && m_layout.value_offset == 0 &&
+        m_layout.is_big_endian != IsLittleEndianHost() && reinterpret_cast<uintptr_t>(samples) % alignof(uint16_t) == 0;
+    if (is_native) {
+        // Used in place: the mapping is read-only and never written through this view.
+        m_image = cv::Mat(m_layout.height, m_layout.width, CV_16UC1, const_cast<uint8_t*>(samples));
+        return true;
+    }
+
+    m_image.create(m_layout.height, m_layout.width, CV_16UC1);
+    for (int r = 0; r < m_layout.height; ++r) {
+        const size_t row_start = static_cast<size_t>(r) * m_layout.width;
+        uint16_t* dst = m_image.ptr<uint16_t>(r);
+        for (int c = 0; c < m_layout.width; ++c) {
+            dst[c] = ReadSample(samples, row_start + c);
+        }
+    }
+    return true;
+}
+
+uint16_t MosaicFileSource::ReadSample(const uint8_t* samples, size_t index) const {
+    int value;
+    if (m_layout.bytes_per_sample == 1) {
+        value = samples[index];
+    } else {
+        const uint8_t* src = samples + 2 * index;
+        const uint16_t stored = m_layout.is_big_endian
+            ? static_cast<uint16_t>((src[0] << 8) | src[1])
+            : static_cast<uint16_t>(src[0] | (src[1] << 8));
+        value = m_layout.is_signed ? static_cast<int16_t>(stored) : stored;
+    }
+    return static_cast<uint16_t>(std::clamp(value + m_layout.value_offset, 0, 65535));
+}
+
+bool MosaicFileSource::SampleSummary(int block_stride, RawSummary& summary) const {
+    if (!m_mapped_file || block_stride <= 1) return false;
+
+    // Only the sampled blocks are read (and converted) from the mapping.
+    const uint8_t* samples = m_mapped_file->GetData() + m_layout.data_offset;
+    const int block_rows = m_layout.height / 2;
+    const int block_cols = m_layout.width / 2;
+    const int sampled_rows = (block_rows + block_stride - 1) / block_stride;
+    const int sampled_cols = (block_cols + block_stride - 1) / block_stride;
+    cv::Mat blocks(sampled_rows * 2, sampled_cols * 2, CV_16UC1);
+    for (int sr = 0; sr < sampled_rows; ++sr) {
+        const size_t even_row = static_cast<size_t>(2 * sr * block_stride) * m_layout.width;
+        const size_t odd_row = even_row + m_layout.width;
+        uint16_t* even_dst = blocks.ptr<uint16_t>(2 * sr);
+        uint16_t* odd_dst = blocks.ptr<uint16_t>(2 * sr + 1);
+        for (int sc = 0; sc < sampled_cols; ++sc) {
+            const size_t col = static_cast<size_t>(2 * sc * block_stride);
+            even_dst[2 * sc] = ReadSample(samples, even_row + col);
+            even_dst[2 * sc + 1] = ReadSample(samples, even_row + col + 1);
+            odd_dst[2 * sc] = ReadSample(samples, odd_row + col);
+            odd_dst[2 * sc + 1] = ReadSample(samples, odd_row + col + 1);
+        }
+    }
+    summary = RawSummary::FromSampledBlocks(blocks);
+    return summary.IsValid();
+}
+
+void MosaicFileSource::Release() {
+    m_image.release();
+    m_mapped_file.reset();
+}
+
+cv::Mat MosaicFileSource::GetRawImage() const {
+    return m_image;
+}
+
+cv::Mat MosaicFileSource::GetActiveRawView() const {
+    return m_image;
+}
+
+cv::Mat MosaicFileSource::GetProcessedImage() {
+    return RenderMosaicPreview(m_image, m_metadata);
+}
+
+} // namespace DynaRange::IO::Raw
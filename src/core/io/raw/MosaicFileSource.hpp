@@ -0,0 +1,68 @@
+// File: src/core/io/raw/MosaicFileSource.hpp
+/**
+ * @file src/core/io/raw/MosaicFileSource.hpp
+ * @brief Declares the backend for plain, undecoded CFA mosaics (e.g. machine-vision dumps).
+ * @details Supported containers: binary PGM (P5), NumPy .npy (2-D, uint8/uint16,
+ * C order), FITS (BITPIX 8/16) and headerless dumps (.bin, .r16). The file is
+ * memory-mapped; native-endian 16-bit data is used in place with no decoding at
+ * all, other layouts are converted in a single pass.
+ *
+ * Fields the container lacks come from a key=value sidecar (see
+ * Constants::MOSAIC_SIDECAR_EXTENSION). Recognized keys: width, height,
+ * header_bytes, byte_order (little|big), cfa (RGGB, BGGR, GRBG, GBRG),
+ * black_level, white_level, iso, camera. Lines starting with '#' are ignored.
+ * A file without a CFA pattern is reported as having no raw mosaic.
+ */
+#pragma once
+
+#include "RawSource.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace DynaRange::IO::Raw {
+
+/**
+ * @class MosaicFileSource
+ * @brief Reads a plain mosaic file through a memory mapping.
+ */
+class MosaicFileSource : public RawSource {
+public:
+    explicit MosaicFileSource(std::string filename);
+
+    bool Open(std::shared_ptr<MappedFile> mapped_file) override;
+    RawMetadata GetMetadata() const override;
+    bool Unpack() override;
+    void Release() override;
+    cv::Mat GetRawImage() const override;
+    cv::Mat GetActiveRawView() const override;
+    cv::Mat GetProcessedImage() override;
+    bool SampleSummary(int block_stride, RawSummary& summary) const override;
+
+private:
+    /**
+     * @struct Layout
+     * @brief Where and how the samples are stored in the file.
+     */
+    struct Layout {
+        int width = 0;
+        int height = 0;
+        size_t data_offset = 0;
+        int bytes_per_sample = 2;
+        bool is_big_endian = false;
+        bool is_signed = false;
+        int value_offset = 0; ///< Added to each stored sample (FITS BZERO).
+    };
+
+    bool ParseContainer();
+    /// @brief Converts the stored sample at @p index (in samples from the data start) to uint16.
+    uint16_t ReadSample(const uint8_t* samples, size_t index) const;
+    void ApplySidecar();
+
+    std::string m_filename;
+    std::shared_ptr<MappedFile> m_mapped_file;
+    Layout m_layout;
+    RawMetadata m_metadata;
+    cv::Mat m_image;
+};
+
+} // namespace DynaRange::IO::Raw
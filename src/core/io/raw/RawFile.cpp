@@ -4,12 +4,44 @@
  * @brief Implements the RawFile facade class.
  */
 #include "RawFile.hpp"
-#include "RawLoader.hpp"
-#include "RawImageAccessor.hpp"
-#include "RawMetadataExtractor.hpp"
+#include "RawPrefetcher.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <utility>
 
-RawFile::RawFile(std::string filename) : m_filename(std::move(filename)) {}
+namespace {
+
+/**
+ * @brief Maps a file, from the read-ahead thread when one is given.
+ * @param stats Receives the bytes read and the time spent waiting for them.
+ */
+std::shared_ptr<DynaRange::IO::Raw::MappedFile> MapFile(const std::string& filename, DynaRange::IO::Raw::RawPrefetcher* prefetcher,
+                                                        DynaRange::IO::Raw::IngestionStats& stats) {
+    if (prefetcher) {
+        return prefetcher->Acquire(filename, stats);
+    }
+    auto start = std::chrono::steady_clock::now();
+    auto mapped_file = DynaRange::IO::Raw::MappedFile::Open(filename);
+    stats.bytes_read = mapped_file ? mapped_file->GetSize() : 0;
+    stats.stall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return mapped_file;
+}
+
+} // namespace
+
+RawFile::RawFile(std::string filename)
+    : m_filename(std::move(filename))
+    , m_unpack_mutex(std::make_unique<std::mutex>())
+{
+}
+
+RawFile::RawFile(std::string filename, std::unique_ptr<DynaRange::IO::Raw::RawSource> source)
+    : m_filename(std::move(filename))
+    , m_unpack_mutex(std::make_unique<std::mutex>())
+    , m_source(std::move(source))
+{
+}
 
 RawFile::~RawFile() = default;
 
@@ -17,46 +49,230 @@ RawFile::RawFile(RawFile&& other) noexcept = default;
 RawFile& RawFile::operator=(RawFile&& other) noexcept = default;
 
 bool RawFile::Load() {
+    if (!LoadMetadata()) {
+        return false;
+    }
+    return EnsureUnpacked();
+}
+
+bool RawFile::LoadMetadata(DynaRange::IO::Raw::RawPrefetcher* prefetcher) {
     if (m_is_loaded) return true;
 
-    m_raw_processor = DynaRange::IO::Raw::RawLoader::Load(m_filename);
-    if (!m_raw_processor) {
+    std::shared_ptr<DynaRange::IO::Raw::MappedFile> mapped_file = MapFile(m_filename, prefetcher, m_ingestion_stats);
+
+    if (!m_source) {
+        m_source = DynaRange::IO::Raw::CreateRawSource(m_filename);
+    }
+    if (!m_source->Open(mapped_file)) {
         return false;
     }
+    m_metadata = std::make_shared<const DynaRange::IO::Raw::RawMetadata>(m_source->GetMetadata());
 
-    m_image_accessor = std::make_unique<DynaRange::IO::Raw::RawImageAccessor>(m_raw_processor);
-    m_metadata_extractor = std::make_unique<DynaRange::IO::Raw::RawMetadataExtractor>(m_raw_processor);
-    
     m_is_loaded = true;
     return true;
 }
 
+bool RawFile::EnsureUnpacked(DynaRange::IO::Raw::RawPrefetcher* prefetcher) const {
+    if (!m_is_loaded || !m_unpack_mutex) return false;
+    std::lock_guard<std::mutex> lock(*m_unpack_mutex);
+    return EnsureUnpackedUnlocked(prefetcher);
+}
+
+bool RawFile::EnsureUnpackedUnlocked(DynaRange::IO::Raw::RawPrefetcher* prefetcher) const {
+    if (m_is_compact || m_is_unpacked) return true;
+    if (m_unpack_failed) return false;
+
+    if (m_source_released) {
+        // The pixel data was released earlier: reopen the backend on a fresh mapping,
+        // read ahead by the prefetcher when there is one.
+        DynaRange::IO::Raw::IngestionStats reread;
+        auto mapped_file = MapFile(m_filename, prefetcher, reread);
+        m_ingestion_stats.bytes_read += reread.bytes_read;
+        m_ingestion_stats.stall_ms += reread.stall_ms;
+        m_ingestion_stats.was_prefetched = m_ingestion_stats.was_prefetched || reread.was_prefetched;
+        if (!mapped_file || !m_source->Open(std::move(mapped_file))) {
+            m_unpack_failed = true;
+            return false;
+        }
+        m_source_released = false;
+    }
+    auto start = std::chrono::steady_clock::now();
+    m_is_unpacked = m_source->Unpack();
+    m_ingestion_stats.unpack_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    m_ingestion_stats.unpack_count++;
+    m_unpack_failed = !m_is_unpacked;
+    if (m_is_unpacked) {
+        // Some formats only finalize levels while unpacking; publish a new snapshot.
+        // Getters may run concurrently on other threads, so the old one is never modified.
+        std::atomic_store(&m_metadata, std::make_shared<const DynaRange::IO::Raw::RawMetadata>(m_source->GetMetadata()));
+        if (m_compact_on_unpack) {
+            CompactUnlocked();
+        }
+    }
+    return m_is_unpacked || m_is_compact;
+}
+
+bool RawFile::Compact() {
+    if (!m_is_loaded || !m_unpack_mutex) return false;
+    std::lock_guard<std::mutex> lock(*m_unpack_mutex);
+    if (m_is_compact) return true;
+    if (m_unpack_failed) return false;
+    if (!m_is_unpacked) {
+        // Nothing decoded yet: compact right after the lazy unpack.
+        m_compact_on_unpack = true;
+        return true;
+    }
+    CompactUnlocked();
+    return m_is_compact;
+}
+
+void RawFile::CompactUnlocked() const {
+    // Deinterleave straight from the backend's buffer, without the cloned active image,
+    // building the histogram summary in the same pass (only on the first decode).
+    DynaRange::IO::Raw::RawSummary summary;
+    m_bayer_planes = DynaRange::IO::Raw::DeinterleaveBayerPlanes(m_source->GetActiveRawView(), m_summary ? nullptr : &summary);
+    if (m_bayer_planes[0].empty()) {
+        return; // Keep the full representation if the planes could not be built.
+    }
+    if (!m_summary) {
+        m_summary = std::make_shared<const DynaRange::IO::Raw::RawSummary>(std::move(summary));
+    }
+    m_source->Release();
+    m_source_released = true;
+    m_is_unpacked = false;
+    m_is_compact = true;
+}
+
+bool RawFile::ReleasePixelData() const {
+    if (!m_is_loaded || !m_unpack_mutex) return false;
+    std::lock_guard<std::mutex> lock(*m_unpack_mutex);
+    if (!m_is_compact) {
+        return false; // Only compacted files can be rebuilt from the metadata snapshot alone.
+    }
+    // Matrices already handed out keep their own reference to the plane data.
+    m_bayer_planes = DynaRange::IO::Raw::BayerPlaneSet{};
+    m_is_compact = false;
+    m_compact_on_unpack = true;
+    return true;
+}
+
+bool RawFile::IsCompact() const {
+    return m_is_compact;
+}
+
 cv::Mat RawFile::GetRawImage() const {
-    return m_is_loaded ? m_image_accessor->GetRawImage() : cv::Mat{};
+    if (!m_is_loaded || !m_unpack_mutex) return {};
+    std::lock_guard<std::mutex> lock(*m_unpack_mutex);
+    if (!EnsureUnpackedUnlocked() || m_is_compact) return {};
+    return m_source->GetRawImage();
 }
 
 cv::Mat RawFile::GetActiveRawImage() const {
-    return m_is_loaded ? m_image_accessor->GetActiveRawImage() : cv::Mat{};
+    if (!m_is_loaded || !m_unpack_mutex) return {};
+    std::lock_guard<std::mutex> lock(*m_unpack_mutex);
+    if (!EnsureUnpackedUnlocked()) return {};
+    if (m_is_compact) {
+        return DynaRange::IO::Raw::InterleaveBayerPlanes(m_bayer_planes);
+    }
+    return m_source->GetActiveRawImage();
+}
+
+cv::Mat RawFile::GetBayerPlane(int row_offset, int col_offset) const {
+    if (row_offset < 0 || row_offset > 1 || col_offset < 0 || col_offset > 1 || !m_is_loaded || !m_unpack_mutex) {
+        return {};
+    }
+    std::lock_guard<std::mutex> lock(*m_unpack_mutex);
+    if (!EnsureUnpackedUnlocked()) return {};
+    if (m_is_compact) {
+        return m_bayer_planes[DynaRange::IO::Raw::BayerPlaneIndex(row_offset, col_offset)];
+    }
+    return DynaRange::IO::Raw::ExtractBayerPlane(m_source->GetActiveRawView(), {row_offset, col_offset});
+}
+
+DynaRange::IO::Raw::BayerPlaneView RawFile::GetBayerPlaneView(DynaRange::IO::Raw::CfaOffsets offsets) const {
+    if (!m_is_loaded || !m_unpack_mutex) return {};
+    std::lock_guard<std::mutex> lock(*m_unpack_mutex);
+    if (!EnsureUnpackedUnlocked()) return {};
+    if (m_is_compact) {
+        return DynaRange::IO::Raw::MakeBayerPlaneView(m_bayer_planes[DynaRange::IO::Raw::BayerPlaneIndex(offsets.row, offsets.col)]);
+    }
+    return DynaRange::IO::Raw::MakeBayerPlaneView(m_source->GetActiveRawView(), offsets);
+}
+
+DynaRange::IO::Raw::BayerPlaneSet RawFile::GetNormalizedBayerPlanes(double black_level, double saturation_level) const {
+    if (!m_is_loaded || !m_unpack_mutex) return {};
+    std::lock_guard<std::mutex> lock(*m_unpack_mutex);
+    if (!EnsureUnpackedUnlocked()) return {};
+    if (m_is_compact) {
+        return DynaRange::IO::Raw::NormalizeBayerPlanes(m_bayer_planes, black_level, saturation_level);
+    }
+    return DynaRange::IO::Raw::DeinterleaveNormalizedBayerPlanes(m_source->GetActiveRawView(), black_level, saturation_level);
+}
+
+std::shared_ptr<const DynaRange::IO::Raw::RawSummary> RawFile::GetSummary() const {
+    if (!m_is_loaded || !m_unpack_mutex) return nullptr;
+    std::lock_guard<std::mutex> lock(*m_unpack_mutex);
+    if (m_summary) return m_summary;
+    if (!EnsureUnpackedUnlocked()) return nullptr;
+    if (!m_summary && !m_is_compact) {
+        // Not compacted (e.g. opened with Load()): summarize the active area directly.
+        m_summary = std::make_shared<const DynaRange::IO::Raw::RawSummary>(
+            DynaRange::IO::Raw::RawSummary::FromMosaic(m_source->GetActiveRawView()));
+    }
+    return m_summary;
+}
+
+std::shared_ptr<const DynaRange::IO::Raw::RawSummary> RawFile::GetSampledSummary(int block_stride) const {
+    if (!m_is_loaded || !m_unpack_mutex) return nullptr;
+    {
+        std::lock_guard<std::mutex> lock(*m_unpack_mutex);
+        if (m_summary) return m_summary;
+        if (!m_is_unpacked && !m_is_compact) {
+            // Only backends that read the samples in place are sampled.
+            DynaRange::IO::Raw::RawSummary sampled;
+            if (m_source->SampleSummary(block_stride, sampled)) {
+                return std::make_shared<const DynaRange::IO::Raw::RawSummary>(std::move(sampled));
+            }
+        }
+    }
+    // A file that has to be decoded anyway gets the exact summary, built in the same
+    // pass as the compaction; sampling the decoded data would only add a pass.
+    return GetSummary();
+}
+
+void RawFile::PrimeSummary(std::shared_ptr<const DynaRange::IO::Raw::RawSummary> summary) const {
+    if (!summary || !m_unpack_mutex) return;
+    std::lock_guard<std::mutex> lock(*m_unpack_mutex);
+    if (!m_summary) {
+        m_summary = std::move(summary);
+    }
 }
 
 cv::Mat RawFile::GetProcessedImage() {
-    return m_is_loaded ? m_image_accessor->GetProcessedImage() : cv::Mat{};
+    if (!m_is_loaded || !m_unpack_mutex) return {};
+    std::lock_guard<std::mutex> lock(*m_unpack_mutex);
+    if (!EnsureUnpackedUnlocked() || m_is_compact) return {};
+    return m_source->GetProcessedImage();
 }
 
 std::string RawFile::GetCameraModel() const {
-    return m_is_loaded ? m_metadata_extractor->GetCameraModel() : "";
+    return m_is_loaded ? GetMetadata()->camera_model : "";
+}
+
+std::string RawFile::GetSerialNumber() const {
+    return m_is_loaded ? GetMetadata()->serial_number : "";
 }
 
 float RawFile::GetIsoSpeed() const {
-    return m_is_loaded ? m_metadata_extractor->GetIsoSpeed() : 0.0f;
+    return m_is_loaded ? GetMetadata()->iso_speed : 0.0f;
 }
 
 int RawFile::GetWidth() const {
-    return m_is_loaded ? m_metadata_extractor->GetWidth() : 0;
+    return m_is_loaded ? GetMetadata()->raw_width : 0;
 }
 
 int RawFile::GetHeight() const {
-    return m_is_loaded ? m_metadata_extractor->GetHeight() : 0;
+    return m_is_loaded ? GetMetadata()->raw_height : 0;
 }
 
 const std::string& RawFile::GetFilename() const {
@@ -67,41 +283,100 @@ bool RawFile::IsLoaded() const {
     return m_is_loaded;
 }
 
+bool RawFile::IsUnpacked() const {
+    return m_is_unpacked || m_is_compact;
+}
+
+bool RawFile::HasRawMosaicData() const {
+    return m_is_loaded && GetMetadata()->has_raw_mosaic;
+}
+
 double RawFile::GetSensorResolutionMPx() const {
-    return m_is_loaded ? m_metadata_extractor->GetSensorResolutionMPx() : 0.0;
+    return m_is_loaded ? GetMetadata()->sensor_resolution_mpx : 0.0;
 }
 
 int RawFile::GetBlackLevelFromMetadata() const {
-    return m_is_loaded ? m_metadata_extractor->GetBlackLevelFromMetadata() : 0;
+    return m_is_loaded ? GetMetadata()->black_level : 0;
 }
 
 int RawFile::GetActiveWidth() const {
-    return m_is_loaded ? m_metadata_extractor->GetActiveWidth() : 0;
+    return m_is_loaded ? GetMetadata()->active_width : 0;
 }
 
 int RawFile::GetActiveHeight() const {
-    return m_is_loaded ? m_metadata_extractor->GetActiveHeight() : 0;
+    return m_is_loaded ? GetMetadata()->active_height : 0;
 }
 
 int RawFile::GetTopMargin() const {
-    return m_is_loaded ? m_metadata_extractor->GetTopMargin() : 0;
+    return m_is_loaded ? GetMetadata()->top_margin : 0;
 }
 
 int RawFile::GetLeftMargin() const {
-    return m_is_loaded ? m_metadata_extractor->GetLeftMargin() : 0;
+    return m_is_loaded ? GetMetadata()->left_margin : 0;
 }
 
 std::optional<int> RawFile::GetBitDepth() const {
-    return m_is_loaded ? m_metadata_extractor->GetBitDepth() : std::nullopt;
+    return m_is_loaded ? GetMetadata()->bit_depth : std::nullopt;
 }
 
 /**
  * @brief Implementación de GetOrientation.
  */
 int RawFile::GetOrientation() const {
-    return m_is_loaded ? m_metadata_extractor->GetOrientation() : 0;
+    return m_is_loaded ? GetMetadata()->orientation : 0;
 }
 
 std::string RawFile::GetFilterPattern() const {
-    return m_is_loaded ? m_metadata_extractor->GetFilterPattern() : "";
-}
\ No newline at end of file
+    return m_is_loaded ? GetMetadata()->filter_pattern : "";
+}
+
+std::string RawFile::GetCfaLayout() const {
+    return m_is_loaded ? GetMetadata()->cfa_layout : "";
+}
+
+std::optional<DynaRange::IO::Raw::CfaPattern> RawFile::GetCfaPattern() const {
+    return m_is_loaded ? DynaRange::IO::Raw::ParseCfaPattern(GetMetadata()->filter_pattern) : std::nullopt;
+}
+
+std::optional<DynaRange::IO::Raw::CfaTable> RawFile::GetCfaTable() const {
+    if (!m_is_loaded) return std::nullopt;
+    if (const auto pattern = GetCfaPattern()) {
+        return DynaRange::IO::Raw::CfaTable::FromPattern(*pattern);
+    }
+    const auto metadata = GetMetadata();
+    if (metadata->cfa_layout.size() == static_cast<size_t>(DynaRange::IO::Raw::MAX_CFA_PERIOD * DynaRange::IO::Raw::MAX_CFA_PERIOD)) {
+        return DynaRange::IO::Raw::CfaTable::FromColors(metadata->cfa_layout, DynaRange::IO::Raw::MAX_CFA_PERIOD);
+    }
+    return std::nullopt;
+}
+
+cv::Mat RawFile::GetCfaPlane(DynaRange::IO::Raw::CfaSite site) const {
+    if (const auto pattern = GetCfaPattern()) {
+        const auto offsets = DynaRange::IO::Raw::GetCfaOffsets(*pattern, site);
+        return GetBayerPlane(offsets.row, offsets.col);
+    }
+    const auto table = GetCfaTable();
+    if (!table || !m_unpack_mutex) return {};
+
+    std::lock_guard<std::mutex> lock(*m_unpack_mutex);
+    if (!EnsureUnpackedUnlocked()) return {};
+    // The gather reads the four position planes, stored or viewed in the mosaic.
+    std::array<DynaRange::IO::Raw::BayerPlaneView, 4> planes;
+    for (int row = 0; row < 2; ++row) {
+        for (int col = 0; col < 2; ++col) {
+            const int index = DynaRange::IO::Raw::BayerPlaneIndex(row, col);
+            planes[index] = m_is_compact
+                ? DynaRange::IO::Raw::MakeBayerPlaneView(m_bayer_planes[index])
+                : DynaRange::IO::Raw::MakeBayerPlaneView(m_source->GetActiveRawView(), {row, col});
+        }
+    }
+    return DynaRange::IO::Raw::GatherCfaPlane(planes, *table, site);
+}
+
+std::shared_ptr<const DynaRange::IO::Raw::RawMetadata> RawFile::GetMetadata() const {
+    return std::atomic_load(&m_metadata);
+}
+
+const DynaRange::IO::Raw::IngestionStats& RawFile::GetIngestionStats() const {
+    return m_ingestion_stats;
+}
@@ -7,14 +7,19 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <opencv2/core/mat.hpp>
+#include "MappedFile.hpp"
+#include "RawMetadata.hpp"
+#include "BayerPlanes.hpp"
+#include "CfaTable.hpp"
+#include "RawSummary.hpp"
+#include "RawSource.hpp"
 
 // Forward declarations
-class LibRaw;
 namespace DynaRange::IO::Raw {
-    class RawImageAccessor;
-    class RawMetadataExtractor;
+    class RawPrefetcher;
 }
 
 /**
@@ -24,10 +29,31 @@ namespace DynaRange::IO::Raw {
  * to the more complex underlying system of loading, data access, and metadata
  * extraction, which are handled by specialized helper classes.
  * It is a move-only type due to its ownership of unique resources.
+ *
+ * The file itself is read by a RawSource backend chosen from the file name
+ * (LibRaw for camera RAW files, a memory-mapped reader for plain mosaics, or a
+ * registered in-memory image), so the engine works the same on all of them.
+ *
+ * A file can be opened in metadata-only mode with LoadMetadata(). In that case
+ * the pixel data is decoded lazily, the first time an image accessor is called.
+ *
+ * Once decoded, a file can be compacted with Compact(): the active area is kept
+ * as four deinterleaved uint16 Bayer planes plus a RawMetadata snapshot, and the
+ * backend's buffers (e.g. the LibRaw instance) are released. The planes of a
+ * compacted file can in turn be dropped with ReleasePixelData(); the next pixel
+ * access then decodes the file again from disk.
  */
 class RawFile {
 public:
     explicit RawFile(std::string filename);
+
+    /**
+     * @brief Constructs a file read through an explicit backend instead of the one
+     * CreateRawSource() would pick for @p filename.
+     * @param filename The name reported by GetFilename().
+     * @param source The backend; must not be nullptr.
+     */
+    RawFile(std::string filename, std::unique_ptr<DynaRange::IO::Raw::RawSource> source);
     ~RawFile();
 
     // --- Rule of Five: Make the class move-only ---
@@ -36,19 +62,154 @@ public:
     RawFile(RawFile&&) noexcept;
     RawFile& operator=(RawFile&&) noexcept;
     
+    /**
+     * @brief Opens the file and decodes its pixel data immediately.
+     * @return true if both the headers and the pixel data could be read.
+     */
     bool Load();
 
+    /**
+     * @brief Opens the file and parses its headers only, deferring the pixel decode.
+     * @details All metadata getters work after this call. The expensive unpack
+     * step runs on first use of an image accessor.
+     * @param prefetcher Optional I/O thread that has read the file ahead; if nullptr
+     *        the file is memory-mapped on the calling thread.
+     * @return true if the file headers could be read.
+     */
+    bool LoadMetadata(DynaRange::IO::Raw::RawPrefetcher* prefetcher = nullptr);
+
+    /**
+     * @brief Gets the I/O accounting (bytes read, stall and unpack time) for this file.
+     */
+    const DynaRange::IO::Raw::IngestionStats& GetIngestionStats() const;
+
+    /**
+     * @brief Switches the file to its compact representation.
+     * @details Extracts the active area into four uint16 Bayer planes and releases
+     * the backend's buffers. If the pixels have not been decoded yet, compaction is
+     * deferred and happens right after the lazy unpack.
+     * @return true if the file is (or will be) compacted.
+     */
+    bool Compact();
+
+    /**
+     * @brief Checks whether the file currently holds only its compact representation.
+     */
+    bool IsCompact() const;
+
+    /**
+     * @brief Decodes the pixel data now instead of on first use.
+     * @details Lets a decoding thread prepare a file before handing it over to
+     * the thread that analyzes it.
+     * @param prefetcher Read-ahead thread to take the file data from if the backend
+     *        has to reopen the file (after ReleasePixelData()); nullptr maps it on
+     *        the calling thread.
+     * @return true if the pixel data is available.
+     */
+    bool EnsureUnpacked(DynaRange::IO::Raw::RawPrefetcher* prefetcher = nullptr) const;
+
+    /**
+     * @brief Drops the Bayer planes of a compacted file, keeping only its metadata.
+     * @details Matrices already returned by GetBayerPlane() stay valid. The file is
+     * decoded and compacted again on the next pixel access.
+     * @return true if pixel data was released.
+     */
+    bool ReleasePixelData() const;
+
     // --- Image Data Accessors (delegated) ---
+    /**
+     * @brief Gets the full sensor image including masked areas.
+     * @return The raw image, or an empty matrix once the file has been compacted.
+     */
     cv::Mat GetRawImage() const;
+
+    /**
+     * @brief Gets the active sensor area as a CV_16U mosaic.
+     * @details For a compacted file the mosaic is rebuilt from the planes on each
+     * call (an odd trailing row/column is not preserved); prefer GetBayerPlane().
+     */
     cv::Mat GetActiveRawImage() const;
+
+    /**
+     * @brief Gets one CFA sub-image of the active area at half resolution.
+     * @param row_offset Row of the site inside the 2x2 CFA block (0 or 1).
+     * @param col_offset Column of the site inside the 2x2 CFA block (0 or 1).
+     * @return A CV_16U plane of size (active_height/2, active_width/2). For a
+     *         compacted file this is the stored plane and must not be modified.
+     */
+    cv::Mat GetBayerPlane(int row_offset, int col_offset) const;
+
+    /**
+     * @brief Views one CFA sub-image of the active area without copying it.
+     * @details Same samples as GetBayerPlane(), read in place from the stored plane
+     * or the backend's mosaic. The view is valid until the file is compacted or
+     * its pixel data is released.
+     * @param offsets The site inside the 2x2 CFA block.
+     * @return The view, or an empty view if the pixel data is not available.
+     */
+    DynaRange::IO::Raw::BayerPlaneView GetBayerPlaneView(DynaRange::IO::Raw::CfaOffsets offsets) const;
+
+    /**
+     * @brief Gets all four CFA sub-images normalized to CV_32F in a single pass.
+     * @details Each value becomes (value - black_level) / (saturation_level - black_level).
+     * A compacted file normalizes its stored planes; otherwise the mosaic is split
+     * and normalized in one pass over the active area.
+     * @param black_level The black level.
+     * @param saturation_level The saturation level.
+     * @return The four CV_32F planes indexed by BayerPlaneIndex(), or empty
+     *         matrices if the pixel data is not available.
+     */
+    DynaRange::IO::Raw::BayerPlaneSet GetNormalizedBayerPlanes(double black_level, double saturation_level) const;
+
+    /**
+     * @brief Gets the histogram summary of the active area, decoding the file if needed.
+     * @details Built once, in the same pass as the compaction, and kept after
+     * ReleasePixelData(), so global statistics never need another full-frame pass.
+     * @return The summary, or nullptr if the pixel data could not be decoded.
+     */
+    std::shared_ptr<const DynaRange::IO::Raw::RawSummary> GetSummary() const;
+
+    /**
+     * @brief Gets a summary cheaply, sampling the active area if no full summary exists.
+     * @details Returns the full summary when it is already available (e.g. primed
+     * from the disk cache). Backends that read samples in place (RawSource::SampleSummary())
+     * are sampled, one 2x2 block every @p block_stride blocks, without decoding; a
+     * sampled summary is not stored. Other files are decoded and get the exact
+     * summary, as from GetSummary().
+     * @param block_stride Distance between sampled blocks.
+     * @return The summary, or nullptr if the pixel data could not be decoded.
+     */
+    std::shared_ptr<const DynaRange::IO::Raw::RawSummary> GetSampledSummary(int block_stride) const;
+
+    /**
+     * @brief Seeds the histogram summary from a persisted copy.
+     * @details GetSummary() then answers without decoding the file. Ignored if a
+     * summary is already present.
+     * @param summary The summary previously computed for this very file.
+     */
+    void PrimeSummary(std::shared_ptr<const DynaRange::IO::Raw::RawSummary> summary) const;
+
+    /**
+     * @brief Gets the demosaiced RGB (BGR) image.
+     * @return The processed image, or an empty matrix once the file has been compacted.
+     */
     cv::Mat GetProcessedImage();
 
     // --- Metadata Getters (delegated) ---
     std::string GetCameraModel() const;
+    /// @brief Gets the camera body serial number, or an empty string if unknown.
+    std::string GetSerialNumber() const;
     int GetWidth() const;
     int GetHeight() const;
     const std::string& GetFilename() const;
     bool IsLoaded() const;
+    bool IsUnpacked() const;
+
+    /**
+     * @brief Checks, without decoding pixels, whether the file contains raw CFA data.
+     * @return false for formats that cannot be analyzed (e.g. sRAW, linear DNG).
+     */
+    bool HasRawMosaicData() const;
     float GetIsoSpeed() const;
     double GetSensorResolutionMPx() const;
     int GetBlackLevelFromMetadata() const;
@@ -70,13 +231,74 @@ public:
      */
     std::string GetFilterPattern() const;
 
+    /**
+     * @brief Gets the colors of the file's CFA tile for non-Bayer layouts.
+     * @return The colors in raster order (36 letters for X-Trans), or an empty string
+     *         for Bayer or unknown layouts.
+     */
+    std::string GetCfaLayout() const;
+
+    /**
+     * @brief Gets the Bayer layout of the file.
+     * @return The layout, or std::nullopt if the file does not use one of the four
+     *         2x2 Bayer layouts (e.g. X-Trans or CMYG sensors; see GetCfaTable()).
+     */
+    std::optional<DynaRange::IO::Raw::CfaPattern> GetCfaPattern() const;
+
+    /**
+     * @brief Gets the gather table of the file's CFA, Bayer or not.
+     * @return The table, or std::nullopt if the layout is unknown or unsupported.
+     */
+    std::optional<DynaRange::IO::Raw::CfaTable> GetCfaTable() const;
+
+    /**
+     * @brief Gets the half-resolution plane of one CFA site, for any supported layout.
+     * @details Bayer files return GetBayerPlane() of the site; other layouts (X-Trans)
+     * gather the plane through GetCfaTable() in one pass.
+     * @param site The site to extract.
+     * @return A CV_16U plane of size (active_height/2, active_width/2), or an empty matrix
+     *         if the layout is unsupported or the pixel data is not available. For a
+     *         compacted Bayer file this is the stored plane and must not be modified.
+     */
+    cv::Mat GetCfaPlane(DynaRange::IO::Raw::CfaSite site) const;
+
 private:
+    /**
+     * @brief Decodes (or re-decodes) the pixel data on first use. Caller holds m_unpack_mutex.
+     * @param prefetcher Read-ahead source for reopening a released backend, or nullptr.
+     * @return true if the pixel data is available.
+     */
+    bool EnsureUnpackedUnlocked(DynaRange::IO::Raw::RawPrefetcher* prefetcher = nullptr) const;
+
+    /**
+     * @brief Extracts the Bayer planes and releases the backend. Caller holds m_unpack_mutex.
+     */
+    void CompactUnlocked() const;
+
+    /**
+     * @brief Gets the current metadata snapshot. Only valid once the file is loaded.
+     */
+    std::shared_ptr<const DynaRange::IO::Raw::RawMetadata> GetMetadata() const;
+
     std::string m_filename;
     bool m_is_loaded = false;
-    // LibRaw instance shared between helpers
-    std::shared_ptr<LibRaw> m_raw_processor;
+    mutable bool m_is_unpacked = false;
+    mutable bool m_unpack_failed = false;
+    mutable bool m_is_compact = false;
+    mutable bool m_compact_on_unpack = false;
+    mutable bool m_source_released = false; // The backend let go of the file on compaction.
+    mutable DynaRange::IO::Raw::IngestionStats m_ingestion_stats;
+    // Guards the lazy unpack/compaction; held by pointer so the class stays movable.
+    std::unique_ptr<std::mutex> m_unpack_mutex;
+    // Immutable metadata snapshot; stays valid after LibRaw is released. The lazy
+    // unpack replaces it atomically (std::atomic_load/atomic_store), so the getters
+    // need no lock.
+    mutable std::shared_ptr<const DynaRange::IO::Raw::RawMetadata> m_metadata;
+    // Compact pixel storage (active area), filled by Compact().
+    mutable DynaRange::IO::Raw::BayerPlaneSet m_bayer_planes;
+    // Histogram summary of the active area; survives ReleasePixelData().
+    mutable std::shared_ptr<const DynaRange::IO::Raw::RawSummary> m_summary;
 
-    // Specialized helper components
-    std::unique_ptr<DynaRange::IO::Raw::RawImageAccessor> m_image_accessor;
-    std::unique_ptr<DynaRange::IO::Raw::RawMetadataExtractor> m_metadata_extractor;
+    // Backend reading the file; its pixel buffers are released on compaction.
+    mutable std::unique_ptr<DynaRange::IO::Raw::RawSource> m_source;
 };
\ No newline at end of file
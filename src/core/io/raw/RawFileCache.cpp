@@ -0,0 +1,153 @@
+// File: src/core/io/raw/RawFileCache.cpp
+/**
+ * @file src/core/io/raw/RawFileCache.cpp
+ * @brief Implements the run-scoped RAW decode cache.
+ */
+#include "RawFileCache.hpp"
+#include "RawLoader.hpp"
+#include <filesystem>
+#include <iomanip>
+#include <libintl.h>
+
+#define _(string) gettext(string)
+
+namespace fs = std::filesystem;
+
+namespace DynaRange::IO::Raw {
+
+namespace {
+
+void LogIngestionLine(const std::string& filename, const IngestionStats& io, std::ostream& log_stream)
+{
+    log_stream << "  - " << fs::path(filename).filename().string() << ": "
+               << std::fixed << std::setprecision(1) << (static_cast<double>(io.bytes_read) / (1024.0 * 1024.0)) << _(" MB read")
+               << (io.was_prefetched ? _(" (prefetched)") : "")
+               << _(", I/O stall ") << io.stall_ms << " ms"
+               << _(", unpack ") << io.unpack_ms << " ms";
+    if (io.unpack_count > 1) {
+        log_stream << " (" << io.unpack_count << _(" decodes)");
+    }
+    log_stream << std::endl;
+}
+
+} // namespace
+
+RawFileCache::RawFileCache(size_t max_resident_files)
+    : m_max_resident_files(max_resident_files)
+    , m_base_open_count(RawLoader::GetOpenCount())
+    , m_base_unpack_count(RawLoader::GetUnpackCount())
+{
+}
+
+void RawFileCache::Prefetch(const std::vector<std::string>& filenames)
+{
+    m_prefetcher.Schedule(filenames);
+}
+
+const RawFile* RawFileCache::Acquire(const std::string& filename)
+{
+    Entry* entry = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.requests++;
+        auto& slot = m_entries[filename];
+        if (!slot) {
+            slot = std::make_unique<Entry>(filename);
+        }
+        entry = slot.get();
+    }
+
+    // Opening runs outside the map lock so different files can load in parallel.
+    bool decoded_here = false;
+    std::call_once(entry->load_once, [&]() {
+        entry->is_loaded = entry->file && entry->file->LoadMetadata(&m_prefetcher);
+        if (entry->is_loaded) {
+            entry->file->Compact(); // Deferred until the first pixel access unpacks it.
+        }
+        decoded_here = true;
+    });
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (decoded_here) {
+        m_stats.opens++;
+        if (!entry->is_loaded) {
+            m_stats.failures++;
+        }
+    } else if (entry->is_loaded && entry->file) {
+        m_stats.reuses++;
+    }
+    if (m_max_resident_files > 0 && entry->is_loaded) {
+        m_recent_files.remove(filename);
+        m_recent_files.push_front(filename);
+        EnforceResidencyLimit();
+    }
+    return (entry->is_loaded && entry->file) ? entry->file.get() : nullptr;
+}
+
+std::optional<RawFile> RawFileCache::Release(const std::string& filename)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(filename);
+    if (it == m_entries.end() || !it->second->is_loaded || !it->second->file) {
+        return std::nullopt;
+    }
+    std::optional<RawFile> released(std::move(*it->second->file));
+    it->second->file.reset();
+    m_recent_files.remove(filename);
+    return released;
+}
+
+void RawFileCache::EnforceResidencyLimit()
+{
+    while (m_recent_files.size() > m_max_resident_files) {
+        auto it = m_entries.find(m_recent_files.back());
+        m_recent_files.pop_back();
+        if (it != m_entries.end() && it->second->file && it->second->file->ReleasePixelData()) {
+            m_stats.evictions++;
+        }
+    }
+}
+
+RawFileCache::Statistics RawFileCache::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Statistics stats = m_stats;
+    stats.libraw_opens = RawLoader::GetOpenCount() - m_base_open_count;
+    stats.libraw_unpacks = RawLoader::GetUnpackCount() - m_base_unpack_count;
+    return stats;
+}
+
+void RawFileCache::LogStatistics(std::ostream& log_stream) const
+{
+    Statistics stats = GetStatistics();
+    log_stream << _("RAW decode cache: ") << stats.opens << _(" file(s) opened, ")
+               << stats.reuses << _(" reuse(s), ") << stats.failures << _(" failure(s)")
+               << (stats.evictions > 0 ? ", " + std::to_string(stats.evictions) + _(" eviction(s)") : std::string())
+               << " (LibRaw open: " << stats.libraw_opens << ", unpack: " << stats.libraw_unpacks << ")" << std::endl;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [filename, entry] : m_entries) {
+        if (!entry->is_loaded || !entry->file) continue;
+        LogIngestionLine(filename, entry->file->GetIngestionStats(), log_stream);
+    }
+}
+
+void LogIngestionStatistics(const std::vector<RawFile>& files, std::ostream& log_stream)
+{
+    log_stream << _("RAW file I/O:") << std::endl;
+    for (const auto& file : files) {
+        if (!file.IsLoaded()) continue;
+        LogIngestionLine(file.GetFilename(), file.GetIngestionStats(), log_stream);
+    }
+}
+
+const RawFile* AcquireRawFile(RawFileCache* raw_cache, const std::string& filename, std::optional<RawFile>& local_file)
+{
+    if (raw_cache) {
+        return raw_cache->Acquire(filename);
+    }
+    local_file.emplace(filename);
+    return local_file->LoadMetadata() ? &*local_file : nullptr;
+}
+
+} // namespace DynaRange::IO::Raw
@@ -0,0 +1,147 @@
+// File: src/core/io/raw/RawFileCache.hpp
+/**
+ * @file src/core/io/raw/RawFileCache.hpp
+ * @brief Declares a run-scoped cache that guarantees each RAW file is decoded only once.
+ * @details During initialization several independent stages (pre-analysis, calibration
+ * estimation, sensor resolution detection, final analysis) need the same RAW files.
+ * Instead of each stage constructing and loading its own RawFile, they borrow a
+ * handle from this cache, so every file is opened and unpacked exactly once per run.
+ */
+#pragma once
+
+#include "RawFile.hpp"
+#include "RawPrefetcher.hpp"
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace DynaRange::IO::Raw {
+
+/**
+ * @class RawFileCache
+ * @brief Owns the RawFile objects loaded during a single analysis run.
+ * @details Files are opened in metadata-only mode; their pixel data is unpacked
+ * lazily by RawFile the first time a stage asks for it, and only once. Files are
+ * compacted right after that unpack (Bayer planes kept, LibRaw released), so at
+ * most one full LibRaw decode is alive per decoding thread.
+ * Acquire() is thread-safe. Concurrent requests for the same file block
+ * until the first request has finished opening it.
+ *
+ * An optional residency limit bounds memory for long series: only the most
+ * recently acquired files keep their pixel data, older ones are reduced to their
+ * metadata and decoded again if a later stage needs their pixels.
+ */
+class RawFileCache {
+public:
+    /**
+     * @struct Statistics
+     * @brief Counters proving how often files were decoded versus reused.
+     */
+    struct Statistics {
+        size_t requests = 0;   ///< Total number of Acquire() calls.
+        size_t opens = 0;      ///< Number of files opened by the cache.
+        size_t reuses = 0;     ///< Number of requests served from an already opened file.
+        size_t failures = 0;   ///< Number of files that could not be opened.
+        size_t evictions = 0;  ///< Number of times a file's pixel data was dropped to honor the residency limit.
+        size_t libraw_opens = 0;   ///< LibRaw open calls observed while this cache was alive.
+        size_t libraw_unpacks = 0; ///< LibRaw unpack calls observed while this cache was alive.
+    };
+
+    /**
+     * @brief Constructs the cache.
+     * @param max_resident_files Maximum number of files whose pixel data is kept
+     *        in memory at once; 0 keeps every file resident.
+     */
+    explicit RawFileCache(size_t max_resident_files = 0);
+
+    /**
+     * @brief Starts reading the given files ahead on the cache's I/O thread.
+     * @details Files should be listed in the order they will be acquired, so disk
+     * reads overlap with decoding of the preceding files.
+     * @param filenames The files that will be acquired during this run.
+     */
+    void Prefetch(const std::vector<std::string>& filenames);
+
+    /**
+     * @brief Returns a borrowed handle to a RAW file, opening it on first use.
+     * @param filename The path to the RAW file.
+     * @return A pointer owned by the cache, or nullptr if the file could not be
+     *         loaded or has already been released.
+     */
+    const RawFile* Acquire(const std::string& filename);
+
+    /**
+     * @brief Transfers ownership of a loaded file out of the cache.
+     * @details Used at the end of initialization to hand the decoded files to the
+     * analysis stage without reloading them. After release, Acquire() returns nullptr
+     * for this file.
+     * @param filename The path to the RAW file.
+     * @return The RawFile, or std::nullopt if it was never loaded successfully.
+     */
+    std::optional<RawFile> Release(const std::string& filename);
+
+    /**
+     * @brief Gets the current decode/reuse counters.
+     * @return A snapshot of the cache statistics.
+     */
+    Statistics GetStatistics() const;
+
+    /**
+     * @brief Writes a summary of the cache counters to a log stream.
+     * @details Files still owned by the cache also get their I/O accounting; files
+     * handed over with Release() are reported with LogIngestionStatistics().
+     * @param log_stream The output stream for logging.
+     */
+    void LogStatistics(std::ostream& log_stream) const;
+
+private:
+    struct Entry {
+        explicit Entry(const std::string& filename) : file(std::make_unique<RawFile>(filename)) {}
+        std::once_flag load_once;
+        std::unique_ptr<RawFile> file;
+        bool is_loaded = false;
+    };
+
+    /**
+     * @brief Drops the pixels of the least recently used files beyond the limit. Caller holds m_mutex.
+     */
+    void EnforceResidencyLimit();
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, std::unique_ptr<Entry>> m_entries;
+    size_t m_max_resident_files;
+    std::list<std::string> m_recent_files; // Most recently acquired first.
+    RawPrefetcher m_prefetcher;
+    Statistics m_stats;
+    size_t m_base_open_count = 0;
+    size_t m_base_unpack_count = 0;
+};
+
+/**
+ * @brief Writes the I/O accounting (bytes read, stall and unpack time) of each file to a log stream.
+ * @details Called once the files are no longer in use, so decodes made after they left
+ * the cache (e.g. by the streaming analysis) are included.
+ * @param files The files to report; files that never loaded are skipped.
+ * @param log_stream The output stream for logging.
+ */
+void LogIngestionStatistics(const std::vector<RawFile>& files, std::ostream& log_stream);
+
+/**
+ * @brief Borrows a file from an optional cache, or loads a private copy when no cache is given.
+ * @details Lets stages that are also used outside a full analysis run (e.g. from the GUI)
+ * share the same code path with and without a run cache.
+ * @param raw_cache The run cache, or nullptr to load a private copy.
+ * @param filename The path to the RAW file.
+ * @param local_file Storage for the private copy; must outlive the returned pointer.
+ * @return A pointer to the opened file (pixels are unpacked on first access),
+ *         or nullptr if it could not be opened.
+ */
+const RawFile* AcquireRawFile(RawFileCache* raw_cache, const std::string& filename, std::optional<RawFile>& local_file);
+
+} // namespace DynaRange::IO::Raw
@@ -32,6 +32,16 @@ cv::Mat RawImageAccessor::GetActiveRawImage() const {
     if (!m_raw_processor) return {};
     if (!m_active_raw_image_cache.empty()) return m_active_raw_image_cache;
 
+    cv::Mat active_view = GetActiveRawView();
+    if (active_view.empty()) return {};
+
+    m_active_raw_image_cache = active_view.clone();
+    return m_active_raw_image_cache;
+}
+
+cv::Mat RawImageAccessor::GetActiveRawView() const {
+    if (!m_raw_processor) return {};
+
     cv::Mat full_raw_image = GetRawImage();
     if (full_raw_image.empty()) return {};
 
@@ -45,12 +55,10 @@ cv::Mat RawImageAccessor::GetActiveRawImage() const {
     if (active_area.width <= 0 || active_area.height <= 0 ||
         (active_area.x + active_area.width) > full_raw_image.cols ||
         (active_area.y + active_area.height) > full_raw_image.rows) {
-        m_active_raw_image_cache = full_raw_image.clone();
-        return m_active_raw_image_cache;
+        return full_raw_image;
     }
 
-    m_active_raw_image_cache = full_raw_image(active_area).clone();
-    return m_active_raw_image_cache;
+    return full_raw_image(active_area);
 }
 
 cv::Mat RawImageAccessor::GetProcessedImage() {
@@ -23,6 +23,13 @@ public:
 
     cv::Mat GetRawImage() const;
     cv::Mat GetActiveRawImage() const;
+
+    /**
+     * @brief Gets the active area as a view into LibRaw's buffer, without copying.
+     * @details The view is only valid while the LibRaw instance is alive.
+     * @return A CV_16U ROI of the raw image, or an empty matrix if not unpacked.
+     */
+    cv::Mat GetActiveRawView() const;
     cv::Mat GetProcessedImage();
 
 private:
@@ -4,18 +4,57 @@
  * @brief Implements the RAW file loading component.
  */
 #include "RawLoader.hpp"
+#include <atomic>
 
 namespace DynaRange::IO::Raw {
 
+namespace {
+    std::atomic<size_t> g_open_count{0};
+    std::atomic<size_t> g_unpack_count{0};
+}
+
 std::shared_ptr<LibRaw> RawLoader::Load(const std::string& filename) {
-    auto raw_processor = std::make_shared<LibRaw>();
-    if (raw_processor->open_file(filename.c_str()) != LIBRAW_SUCCESS) {
+    auto raw_processor = Open(filename);
+    if (!raw_processor || !Unpack(*raw_processor)) {
         return nullptr;
     }
-    if (raw_processor->unpack() != LIBRAW_SUCCESS) {
+    return raw_processor;
+}
+
+std::shared_ptr<LibRaw> RawLoader::Open(const std::string& filename, std::shared_ptr<MappedFile> mapped_file) {
+    g_open_count++;
+    if (!mapped_file) {
+        mapped_file = MappedFile::Open(filename);
+    }
+    if (!mapped_file) {
+        // Could not map or read the file ourselves; let LibRaw try its own file I/O.
+        auto raw_processor = std::make_shared<LibRaw>();
+        if (raw_processor->open_file(filename.c_str()) != LIBRAW_SUCCESS) {
+            return nullptr;
+        }
+        return raw_processor;
+    }
+
+    // LibRaw reads from the buffer lazily (also during unpack), so the deleter
+    // keeps the mapping alive for the lifetime of the LibRaw object.
+    std::shared_ptr<LibRaw> raw_processor(new LibRaw(), [mapped_file](LibRaw* processor) { delete processor; });
+    if (raw_processor->open_buffer(mapped_file->GetData(), mapped_file->GetSize()) != LIBRAW_SUCCESS) {
         return nullptr;
     }
     return raw_processor;
 }
 
+bool RawLoader::Unpack(LibRaw& raw_processor) {
+    g_unpack_count++;
+    return raw_processor.unpack() == LIBRAW_SUCCESS;
+}
+
+size_t RawLoader::GetOpenCount() {
+    return g_open_count.load();
+}
+
+size_t RawLoader::GetUnpackCount() {
+    return g_unpack_count.load();
+}
+
 } // namespace DynaRange::IO::Raw
\ No newline at end of file
@@ -8,9 +8,11 @@
  */
 #pragma once
 
+#include "MappedFile.hpp"
 #include <libraw/libraw.h>
 #include <string>
 #include <memory>
+#include <cstddef>
 
 namespace DynaRange::IO::Raw {
 
@@ -26,6 +28,40 @@ public:
      * @return A shared pointer to an initialized LibRaw object on success, or nullptr on failure.
      */
     static std::shared_ptr<LibRaw> Load(const std::string& filename);
+
+    /**
+     * @brief Opens a RAW file and parses its headers without decoding pixel data.
+     * @details After this call all metadata (ISO, model, dimensions, black/white
+     * levels, CFA description) is available, but rawdata.raw_image is still empty.
+     * The file is handed to LibRaw as a memory-mapped buffer (open_buffer); the
+     * mapping is kept alive for as long as the returned LibRaw object.
+     * @param filename The path to the RAW file.
+     * @param mapped_file An already mapped (e.g. prefetched) view of the file. If
+     *        nullptr, the file is mapped here.
+     * @return A shared pointer to an opened LibRaw object on success, or nullptr on failure.
+     */
+    static std::shared_ptr<LibRaw> Open(const std::string& filename, std::shared_ptr<MappedFile> mapped_file = nullptr);
+
+    /**
+     * @brief Decodes the pixel data of a LibRaw object previously returned by Open().
+     * @param raw_processor The opened LibRaw object.
+     * @return true on success, false if unpacking failed.
+     */
+    static bool Unpack(LibRaw& raw_processor);
+
+    /**
+     * @brief Gets the number of LibRaw open calls issued by this process.
+     * @details Used together with GetUnpackCount() to verify that each file is
+     * decoded only once per analysis run.
+     * @return The process-wide open counter.
+     */
+    static size_t GetOpenCount();
+
+    /**
+     * @brief Gets the number of LibRaw unpack calls issued by this process.
+     * @return The process-wide unpack counter.
+     */
+    static size_t GetUnpackCount();
 };
 
 } // namespace DynaRange::IO::Raw
\ No newline at end of file
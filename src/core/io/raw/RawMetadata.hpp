@@ -0,0 +1,41 @@
+// File: src/core/io/raw/RawMetadata.hpp
+/**
+ * @file src/core/io/raw/RawMetadata.hpp
+ * @brief Defines a small, self-contained snapshot of the metadata of a RAW file.
+ * @details Keeping the metadata in a plain struct lets a RawFile release its
+ * LibRaw instance once the pixel data has been extracted, while all metadata
+ * getters keep working.
+ */
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace DynaRange::IO::Raw {
+
+/**
+ * @struct RawMetadata
+ * @brief The metadata fields of a RAW file used by the analysis.
+ */
+struct RawMetadata {
+    std::string camera_model;
+    /// Body serial number, when the file records one; empty otherwise.
+    std::string serial_number;
+    float iso_speed = 0.0f;
+    int raw_width = 0;       ///< Full sensor width, including masked areas.
+    int raw_height = 0;      ///< Full sensor height, including masked areas.
+    int active_width = 0;
+    int active_height = 0;
+    int top_margin = 0;
+    int left_margin = 0;
+    std::optional<int> bit_depth;
+    int black_level = 0;
+    int orientation = 0;
+    double sensor_resolution_mpx = 0.0;
+    std::string filter_pattern;
+    /// Colors of one CFA tile in raster order for non-Bayer layouts (36 letters for X-Trans); empty otherwise.
+    std::string cfa_layout;
+    bool has_raw_mosaic = false;
+};
+
+} // namespace DynaRange::IO::Raw
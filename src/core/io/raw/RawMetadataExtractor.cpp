@@ -5,7 +5,9 @@
  */
 #include "RawMetadataExtractor.hpp"
 #include <algorithm>
+#include <cctype>
 #include <cmath>
+#include <cstring>
 
 namespace DynaRange::IO::Raw {
 
@@ -19,6 +21,14 @@ std::string RawMetadataExtractor::GetCameraModel() const {
     return m_camera_model_cache;
 }
 
+std::string RawMetadataExtractor::GetSerialNumber() const {
+    if (!m_raw_processor) return "";
+    const auto& shooting = m_raw_processor->imgdata.shootinginfo;
+    std::string serial(shooting.BodySerial);
+    if (serial.empty()) serial = std::string(shooting.InternalBodySerial);
+    return serial;
+}
+
 float RawMetadataExtractor::GetIsoSpeed() const {
     if (!m_raw_processor) return 0.0f;
     if (m_iso_speed_cache > 0.0f) {
@@ -113,15 +123,76 @@ std::string RawMetadataExtractor::GetFilterPattern() const {
     if (!m_raw_processor) return "";
     if (!m_filter_pattern_cache.empty()) return m_filter_pattern_cache;
 
-    // The cdesc field contains the pattern description (e.g., "RGGB").
-    // We convert it to a string and cache it.
-    m_filter_pattern_cache = std::string(m_raw_processor->imgdata.idata.cdesc);
-    
-    // Convert to uppercase for consistent, case-insensitive comparisons later.
-    std::transform(m_filter_pattern_cache.begin(), m_filter_pattern_cache.end(), m_filter_pattern_cache.begin(),
-                   [](unsigned char c){ return std::toupper(c); });
+    // cdesc only lists the color names (e.g. "RGBG"); the layout of the active area
+    // comes from COLOR(), whose indices point into cdesc and account for the margins.
+    const unsigned filters = m_raw_processor->imgdata.idata.filters;
+    if (filters == 0) return "";
+    if (filters == LIBRAW_XTRANS) {
+        m_filter_pattern_cache = "X-TRANS";
+        return m_filter_pattern_cache;
+    }
+    const char* color_names = m_raw_processor->imgdata.idata.cdesc;
+    const size_t color_count = std::strlen(color_names);
+    std::string pattern;
+    for (int row = 0; row < 2; ++row) {
+        for (int col = 0; col < 2; ++col) {
+            const int color = m_raw_processor->COLOR(row, col);
+            pattern += (color >= 0 && static_cast<size_t>(color) < color_count) ? color_names[color] : '?';
+        }
+    }
 
+    // Convert to uppercase for consistent, case-insensitive comparisons later.
+    std::transform(pattern.begin(), pattern.end(), pattern.begin(),
+                   [](unsigned char c){ return static_cast<char>(std::toupper(c)); });
+    m_filter_pattern_cache = pattern;
     return m_filter_pattern_cache;
 }
 
-} // namespace DynaRange::IO::Raw
\ No newline at end of file
+std::string RawMetadataExtractor::GetCfaLayout() const {
+    if (!m_raw_processor || m_raw_processor->imgdata.idata.filters != LIBRAW_XTRANS) return "";
+    // COLOR() reads LibRaw's xtrans table, already shifted to the active area's origin.
+    const char* color_names = m_raw_processor->imgdata.idata.cdesc;
+    const size_t color_count = std::strlen(color_names);
+    std::string layout;
+    for (int row = 0; row < 6; ++row) {
+        for (int col = 0; col < 6; ++col) {
+            const int color = m_raw_processor->COLOR(row, col);
+            layout += (color >= 0 && static_cast<size_t>(color) < color_count)
+                ? static_cast<char>(std::toupper(static_cast<unsigned char>(color_names[color])))
+                : '?';
+        }
+    }
+    return layout;
+}
+
+bool RawMetadataExtractor::HasRawMosaicData() const {
+    if (!m_raw_processor) return false;
+    // A zero 'filters' mask means the data is not a color filter array mosaic.
+    if (m_raw_processor->imgdata.idata.filters == 0) return false;
+    // Small/medium RAW variants are already demosaiced YCbCr data.
+    return m_raw_processor->is_sraw() == 0;
+}
+
+RawMetadata RawMetadataExtractor::GetSnapshot() const {
+    RawMetadata metadata;
+    if (!m_raw_processor) return metadata;
+    metadata.camera_model = GetCameraModel();
+    metadata.serial_number = GetSerialNumber();
+    metadata.iso_speed = GetIsoSpeed();
+    metadata.raw_width = GetWidth();
+    metadata.raw_height = GetHeight();
+    metadata.active_width = GetActiveWidth();
+    metadata.active_height = GetActiveHeight();
+    metadata.top_margin = GetTopMargin();
+    metadata.left_margin = GetLeftMargin();
+    metadata.bit_depth = GetBitDepth();
+    metadata.black_level = GetBlackLevelFromMetadata();
+    metadata.orientation = GetOrientation();
+    metadata.sensor_resolution_mpx = GetSensorResolutionMPx();
+    metadata.filter_pattern = GetFilterPattern();
+    metadata.cfa_layout = GetCfaLayout();
+    metadata.has_raw_mosaic = HasRawMosaicData();
+    return metadata;
+}
+
+} // namespace DynaRange::IO::Raw
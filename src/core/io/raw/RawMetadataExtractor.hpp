@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include "RawMetadata.hpp"
 #include <libraw/libraw.h>
 #include <string>
 #include <memory>
@@ -23,6 +24,12 @@ public:
     explicit RawMetadataExtractor(std::shared_ptr<LibRaw> raw_processor);
 
     std::string GetCameraModel() const;
+
+    /**
+     * @brief Gets the camera body serial number from the RAW file's metadata.
+     * @return The serial number, or an empty string if the file does not record one.
+     */
+    std::string GetSerialNumber() const;
     int GetWidth() const;
     int GetHeight() const;
     float GetIsoSpeed() const;
@@ -47,6 +54,29 @@ public:
      */
     std::string GetFilterPattern() const;
 
+    /**
+     * @brief Gets the colors of the 6x6 X-Trans tile of the active area.
+     * @return 36 letters ('R', 'G' or 'B') in raster order, or an empty string for
+     *         files that are not X-Trans.
+     */
+    std::string GetCfaLayout() const;
+
+    /**
+     * @brief Checks, from header data only, whether the file stores a CFA mosaic.
+     * @details Formats without a mosaic (linear/lossy DNG, Canon sRAW/mRAW, ...)
+     * leave rawdata.raw_image empty after unpacking, so they cannot be analyzed.
+     * This check lets callers reject them before any pixel data is decoded.
+     * @return true if the file contains raw CFA sensor data.
+     */
+    bool HasRawMosaicData() const;
+
+    /**
+     * @brief Copies all metadata fields into a standalone struct.
+     * @details The snapshot stays valid after the LibRaw instance is released.
+     * @return The metadata snapshot.
+     */
+    RawMetadata GetSnapshot() const;
+
 private:
     std::shared_ptr<LibRaw> m_raw_processor;
     mutable std::string m_camera_model_cache;
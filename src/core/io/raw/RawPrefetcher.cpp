@@ -0,0 +1,113 @@
+// File: src/core/io/raw/RawPrefetcher.cpp
+/**
+ * @file src/core/io/raw/RawPrefetcher.cpp
+ * @brief Implements the read-ahead I/O thread for RAW files.
+ */
+#include "RawPrefetcher.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace DynaRange::IO::Raw {
+
+RawPrefetcher::RawPrefetcher(size_t window) : m_window(std::max<size_t>(1, window)) {}
+
+RawPrefetcher::~RawPrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void RawPrefetcher::Schedule(const std::vector<std::string>& filenames) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& filename : filenames) {
+            if (m_slots.emplace(filename, Slot{}).second) {
+                m_pending.push_back(filename);
+            }
+        }
+        if (!m_thread.joinable() && !m_pending.empty()) {
+            m_thread = std::thread(&RawPrefetcher::WorkerLoop, this);
+        }
+    }
+    m_cv.notify_all();
+}
+
+void RawPrefetcher::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        // Stay within the read-ahead window unless a consumer is waiting on the next file.
+        m_cv.wait(lock, [this]() {
+            return m_stop || (!m_pending.empty() &&
+                (m_ready_unconsumed < m_window || m_slots[m_pending.front()].is_requested));
+        });
+        if (m_stop) break;
+
+        std::string filename = m_pending.front();
+        m_pending.pop_front();
+        lock.unlock();
+
+        std::shared_ptr<MappedFile> file = MappedFile::Open(filename);
+        size_t bytes_read = file ? file->Prefetch() : 0;
+        if (file && bytes_read == 0) {
+            bytes_read = file->GetSize(); // Fallback buffer: read fully during Open().
+        }
+
+        lock.lock();
+        Slot& slot = m_slots[filename];
+        slot.file = std::move(file);
+        slot.bytes_read = bytes_read;
+        slot.is_ready = true;
+        m_ready_unconsumed++;
+        m_cv.notify_all();
+    }
+}
+
+std::shared_ptr<MappedFile> RawPrefetcher::Acquire(const std::string& filename, IngestionStats& stats) {
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed_ms = [&start]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_slots.find(filename);
+    if (it == m_slots.end() || it->second.is_consumed) {
+        lock.unlock();
+        std::shared_ptr<MappedFile> file = MappedFile::Open(filename);
+        stats.bytes_read = file ? file->GetSize() : 0;
+        stats.stall_ms = elapsed_ms();
+        stats.was_prefetched = false;
+        return file;
+    }
+
+    Slot& slot = it->second;
+    if (!slot.is_ready) {
+        // Jump the queue so the I/O thread works on what the decoder needs right now.
+        slot.is_requested = true;
+        auto pending_it = std::find(m_pending.begin(), m_pending.end(), filename);
+        if (pending_it != m_pending.end() && pending_it != m_pending.begin()) {
+            m_pending.erase(pending_it);
+            m_pending.push_front(filename);
+        }
+        m_cv.notify_all();
+        m_cv.wait(lock, [&slot, this]() { return slot.is_ready || m_stop; });
+    }
+
+    std::shared_ptr<MappedFile> file = std::move(slot.file);
+    if (slot.is_ready) {
+        m_ready_unconsumed--;
+    }
+    slot.is_consumed = true;
+    stats.bytes_read = slot.bytes_read;
+    stats.stall_ms = elapsed_ms();
+    stats.was_prefetched = true;
+    lock.unlock();
+    m_cv.notify_all();
+    return file;
+}
+
+} // namespace DynaRange::IO::Raw
@@ -0,0 +1,76 @@
+// File: src/core/io/raw/RawPrefetcher.hpp
+/**
+ * @file src/core/io/raw/RawPrefetcher.hpp
+ * @brief Declares a dedicated I/O thread that reads RAW files ahead of the decoder.
+ * @details Files are memory-mapped and their pages touched on the I/O thread, so
+ * that when a decoding thread opens a file through LibRaw::open_buffer the data is
+ * already resident. Disk reads for the next files overlap with the decoding and
+ * analysis of the current one.
+ */
+#pragma once
+
+#include "MappedFile.hpp"
+#include "Constants.hpp"
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace DynaRange::IO::Raw {
+
+/**
+ * @class RawPrefetcher
+ * @brief Maps and reads files in schedule order on a background thread.
+ * @details At most @c window files are kept read ahead but not yet consumed.
+ * A file requested out of order jumps the queue.
+ */
+class RawPrefetcher {
+public:
+    explicit RawPrefetcher(size_t window = Constants::PREFETCH_WINDOW_FILES);
+    ~RawPrefetcher();
+
+    RawPrefetcher(const RawPrefetcher&) = delete;
+    RawPrefetcher& operator=(const RawPrefetcher&) = delete;
+
+    /**
+     * @brief Queues files for read-ahead, in the order they will be consumed.
+     * @param filenames The files to prefetch. Already scheduled files are ignored.
+     */
+    void Schedule(const std::vector<std::string>& filenames);
+
+    /**
+     * @brief Gets the mapped data for a file, waiting for the I/O thread if needed.
+     * @details Files that were never scheduled (or were already consumed) are
+     * mapped synchronously on the calling thread.
+     * @param filename The path to the file.
+     * @param stats Receives the bytes read and the time spent waiting.
+     * @return The mapped file, or nullptr if it could not be opened.
+     */
+    std::shared_ptr<MappedFile> Acquire(const std::string& filename, IngestionStats& stats);
+
+private:
+    struct Slot {
+        std::shared_ptr<MappedFile> file;
+        size_t bytes_read = 0;
+        bool is_ready = false;
+        bool is_requested = false;
+        bool is_consumed = false;
+    };
+
+    void WorkerLoop();
+
+    size_t m_window;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::string> m_pending;
+    std::map<std::string, Slot> m_slots;
+    size_t m_ready_unconsumed = 0;
+    bool m_stop = false;
+    std::thread m_thread;
+};
+
+} // namespace DynaRange::IO::Raw
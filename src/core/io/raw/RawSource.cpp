@@ -0,0 +1,62 @@
+// File: src/core/io/raw/RawSource.cpp
+/**
+ * @file src/core/io/raw/RawSource.cpp
+ * @brief Implements the backend factory and the shared mosaic preview.
+ */
+#include "RawSource.hpp"
+#include "CfaPattern.hpp"
+#include "Constants.hpp"
+#include "LibRawSource.hpp"
+#include "MosaicFileSource.hpp"
+#include "SyntheticRawSource.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <opencv2/imgproc.hpp>
+
+namespace DynaRange::IO::Raw {
+
+std::unique_ptr<RawSource> CreateRawSource(const std::string& filename) {
+    if (auto synthetic = SyntheticRawSource::Find(filename)) {
+        return synthetic;
+    }
+
+    std::string extension = std::filesystem::path(filename).extension().string();
+    if (!extension.empty() && extension[0] == '.') {
+        extension.erase(0, 1);
+    }
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (const char* mosaic_extension : Constants::PLAIN_MOSAIC_EXTENSIONS) {
+        if (extension == mosaic_extension) {
+            return std::make_unique<MosaicFileSource>(filename);
+        }
+    }
+    return std::make_unique<LibRawSource>(filename);
+}
+
+cv::Mat RenderMosaicPreview(const cv::Mat& mosaic, const RawMetadata& metadata) {
+    if (mosaic.empty()) return {};
+
+    const auto pattern = ParseCfaPattern(metadata.filter_pattern);
+    if (!pattern) return {};
+    // OpenCV names Bayer codes after the second row's second and third pixels.
+    int conversion_code = cv::COLOR_BayerBG2BGR;
+    switch (*pattern) {
+        case CfaPattern::RGGB: conversion_code = cv::COLOR_BayerBG2BGR; break;
+        case CfaPattern::BGGR: conversion_code = cv::COLOR_BayerRG2BGR; break;
+        case CfaPattern::GRBG: conversion_code = cv::COLOR_BayerGB2BGR; break;
+        case CfaPattern::GBRG: conversion_code = cv::COLOR_BayerGR2BGR; break;
+    }
+
+    const int bit_depth = metadata.bit_depth.value_or(16);
+    const double white_level = static_cast<double>((1 << bit_depth) - 1);
+    const double range = std::max(1.0, white_level - metadata.black_level);
+    cv::Mat mosaic_8u;
+    mosaic.convertTo(mosaic_8u, CV_8U, 255.0 / range, -metadata.black_level * 255.0 / range);
+    cv::Mat bgr_image;
+    cv::cvtColor(mosaic_8u, bgr_image, conversion_code);
+    return bgr_image;
+}
+
+} // namespace DynaRange::IO::Raw
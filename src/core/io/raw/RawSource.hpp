@@ -0,0 +1,107 @@
+// File: src/core/io/raw/RawSource.hpp
+/**
+ * @file src/core/io/raw/RawSource.hpp
+ * @brief Declares the interface of the pixel/metadata backends behind RawFile.
+ * @details RawFile handles lazy decoding, compaction and summaries; a RawSource
+ * only knows how to read one kind of file. Backends: LibRaw (camera RAW files),
+ * plain mosaics (PGM/NPY/FITS/headerless dumps, memory-mapped) and in-memory
+ * synthetic mosaics.
+ */
+#pragma once
+
+#include "MappedFile.hpp"
+#include "RawMetadata.hpp"
+#include "RawSummary.hpp"
+#include <memory>
+#include <string>
+#include <opencv2/core/mat.hpp>
+
+namespace DynaRange::IO::Raw {
+
+/**
+ * @class RawSource
+ * @brief Reads the metadata and the CFA mosaic of one file.
+ * @details Calls are serialized by the owning RawFile.
+ */
+class RawSource {
+public:
+    virtual ~RawSource() = default;
+
+    /**
+     * @brief Opens the source and parses its headers, without decoding pixels.
+     * @param mapped_file An already mapped (e.g. prefetched) view of the file, or
+     *        nullptr to let the backend open it.
+     * @return true if the headers could be read.
+     */
+    virtual bool Open(std::shared_ptr<MappedFile> mapped_file) = 0;
+
+    /**
+     * @brief Gets a snapshot of the metadata parsed so far.
+     */
+    virtual RawMetadata GetMetadata() const = 0;
+
+    /**
+     * @brief Makes the pixel data available, reopening the source if Release() was called.
+     * @return true on success.
+     */
+    virtual bool Unpack() = 0;
+
+    /**
+     * @brief Frees the decoded pixel data and any resources held for it.
+     * @details A later Unpack() brings the data back.
+     */
+    virtual void Release() = 0;
+
+    /**
+     * @brief Gets the full sensor image including masked areas, without copying.
+     */
+    virtual cv::Mat GetRawImage() const = 0;
+
+    /**
+     * @brief Gets the active area as a view into the source's buffer, without copying.
+     * @details Only valid until Release(); must not be modified.
+     */
+    virtual cv::Mat GetActiveRawView() const = 0;
+
+    /**
+     * @brief Gets a private copy of the active area.
+     */
+    virtual cv::Mat GetActiveRawImage() const { return GetActiveRawView().clone(); }
+
+    /**
+     * @brief Gets a demosaiced 8-bit BGR rendering of the image, for previews.
+     */
+    virtual cv::Mat GetProcessedImage() = 0;
+
+    /**
+     * @brief Samples the active area straight from the opened file, without Unpack().
+     * @details Backends whose samples can be read in place (e.g. a memory-mapped
+     * mosaic) take one 2x2 block every @p block_stride blocks; others decline and
+     * RawFile samples the decoded mosaic instead.
+     * @param block_stride Distance between sampled blocks.
+     * @param summary Receives the sampled summary.
+     * @return true if the summary was filled.
+     */
+    virtual bool SampleSummary(int block_stride, RawSummary& summary) const { return false; }
+};
+
+/**
+ * @brief Creates the backend for a file.
+ * @details Synthetic sources are matched by their registered name, plain mosaic
+ * formats by extension (see Constants::PLAIN_MOSAIC_EXTENSIONS); everything else
+ * is handed to LibRaw.
+ * @param filename The path (or synthetic source name) of the file.
+ * @return The backend; never nullptr.
+ */
+std::unique_ptr<RawSource> CreateRawSource(const std::string& filename);
+
+/**
+ * @brief Renders a CFA mosaic as an 8-bit BGR image with a simple demosaic.
+ * @details Used by the backends that have no raw converter of their own.
+ * @param mosaic The CV_16U mosaic.
+ * @param metadata Supplies the CFA pattern, black level and bit depth.
+ * @return The BGR image, or an empty matrix if the CFA pattern is not a 2x2 Bayer pattern.
+ */
+cv::Mat RenderMosaicPreview(const cv::Mat& mosaic, const RawMetadata& metadata);
+
+} // namespace DynaRange::IO::Raw
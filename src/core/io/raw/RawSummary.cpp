@@ -0,0 +1,141 @@
+// File: src/core/io/raw/RawSummary.cpp
+/**
+ * @file src/core/io/raw/RawSummary.cpp
+ * @brief Implements the per-file RAW histogram summary.
+ */
+#include "RawSummary.hpp"
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace DynaRange::IO::Raw {
+
+namespace {
+    // One bin per possible 16-bit value while accumulating.
+    constexpr size_t FULL_HISTOGRAM_BINS = 65536;
+}
+
+RawSummary RawSummary::FromMosaic(const cv::Mat& mosaic) {
+    RawSummary summary;
+    if (mosaic.empty() || mosaic.type() != CV_16UC1) {
+        return summary;
+    }
+    const int rows = mosaic.rows & ~1;
+    const int cols = mosaic.cols & ~1;
+    std::vector<uint16_t> even_sites(cols / 2);
+    std::vector<uint16_t> odd_sites(cols / 2);
+    for (int r = 0; r < rows; ++r) {
+        const uint16_t* row = mosaic.ptr<uint16_t>(r);
+        for (int c = 0; c < cols / 2; ++c) {
+            even_sites[c] = row[2 * c];
+            odd_sites[c] = row[2 * c + 1];
+        }
+        summary.Accumulate(even_sites.data(), cols / 2, (r & 1) * 2);
+        summary.Accumulate(odd_sites.data(), cols / 2, (r & 1) * 2 + 1);
+    }
+    summary.Finalize();
+    return summary;
+}
+
+RawSummary RawSummary::FromSampledBlocks(const cv::Mat& blocks) {
+    RawSummary summary = FromMosaic(blocks);
+    summary.m_is_sampled = summary.IsValid();
+    return summary;
+}
+
+RawSummary RawSummary::FromParts(std::vector<uint32_t> histogram,
+                                 const std::array<uint64_t, 4>& channel_sums,
+                                 const std::array<uint64_t, 4>& channel_counts) {
+    RawSummary summary;
+    uint64_t histogram_total = 0;
+    for (uint32_t count : histogram) histogram_total += count;
+    uint64_t channel_total = 0;
+    for (uint64_t count : channel_counts) channel_total += count;
+    if (histogram.size() > FULL_HISTOGRAM_BINS || histogram_total == 0 || histogram_total != channel_total) {
+        return summary;
+    }
+    summary.m_histogram = std::move(histogram);
+    summary.m_channel_sums = channel_sums;
+    summary.m_channel_counts = channel_counts;
+    summary.m_pixel_count = histogram_total;
+    summary.Finalize();
+    return summary;
+}
+
+void RawSummary::Accumulate(const uint16_t* values, int count, int position) {
+    if (m_histogram.size() < FULL_HISTOGRAM_BINS) {
+        m_histogram.resize(FULL_HISTOGRAM_BINS, 0);
+    }
+    uint32_t* histogram = m_histogram.data();
+    uint64_t sum = 0;
+    for (int i = 0; i < count; ++i) {
+        sum += values[i];
+        histogram[values[i]]++;
+    }
+    m_channel_sums[position] += sum;
+    m_channel_counts[position] += static_cast<uint64_t>(count);
+    m_pixel_count += static_cast<uint64_t>(count);
+}
+
+void RawSummary::Finalize() {
+    if (m_pixel_count == 0) {
+        m_histogram.clear();
+        return;
+    }
+    size_t first = 0;
+    while (first < m_histogram.size() && m_histogram[first] == 0) ++first;
+    size_t last = m_histogram.size() - 1;
+    while (last > first && m_histogram[last] == 0) --last;
+    m_min = static_cast<int>(first);
+    m_max = static_cast<int>(last);
+    m_histogram.resize(last + 1);
+    m_histogram.shrink_to_fit();
+}
+
+double RawSummary::GetMean() const {
+    if (m_pixel_count == 0) return 0.0;
+    uint64_t total = 0;
+    for (uint64_t sum : m_channel_sums) total += sum;
+    return static_cast<double>(total) / static_cast<double>(m_pixel_count);
+}
+
+double RawSummary::GetVariance() const {
+    if (m_pixel_count == 0) return 0.0;
+    const double mean = GetMean();
+    double sum_sq_dev = 0.0;
+    for (size_t value = 0; value < m_histogram.size(); ++value) {
+        if (m_histogram[value] == 0) continue;
+        const double deviation = static_cast<double>(value) - mean;
+        sum_sq_dev += static_cast<double>(m_histogram[value]) * deviation * deviation;
+    }
+    return sum_sq_dev / static_cast<double>(m_pixel_count);
+}
+
+double RawSummary::GetMeanStandardError() const {
+    if (!m_is_sampled || m_pixel_count == 0) return 0.0;
+    return std::sqrt(GetVariance() / static_cast<double>(m_pixel_count));
+}
+
+double RawSummary::GetChannelMean(int position) const {
+    if (position < 0 || position > 3 || m_channel_counts[position] == 0) return 0.0;
+    return static_cast<double>(m_channel_sums[position]) / static_cast<double>(m_channel_counts[position]);
+}
+
+uint64_t RawSummary::CountAtOrAbove(double threshold) const {
+    // Integer pixels satisfy value >= threshold exactly when value >= ceil(threshold).
+    double first_bin = std::ceil(threshold);
+    if (first_bin <= 0.0) return m_pixel_count;
+    if (first_bin >= static_cast<double>(m_histogram.size())) return 0;
+    uint64_t count = 0;
+    for (size_t bin = static_cast<size_t>(first_bin); bin < m_histogram.size(); ++bin) {
+        count += m_histogram[bin];
+    }
+    return count;
+}
+
+double RawSummary::GetRatioAtOrAbove(double threshold) const {
+    if (m_pixel_count == 0) return 0.0;
+    return static_cast<double>(CountAtOrAbove(threshold)) / static_cast<double>(m_pixel_count);
+}
+
+} // namespace DynaRange::IO::Raw
@@ -0,0 +1,140 @@
+// File: src/core/io/raw/RawSummary.hpp
+/**
+ * @file src/core/io/raw/RawSummary.hpp
+ * @brief Declares a compact per-file statistical summary of the RAW pixel data.
+ * @details The summary is built once, in the same pass that splits the decoded
+ * mosaic into Bayer planes. Global statistics that used to need their own
+ * full-frame pass (mean, min/max, saturated-pixel ratio for any threshold) are
+ * then answered from the histogram in O(bins), even after the pixel data of the
+ * file has been released.
+ */
+#pragma once
+
+#include <opencv2/core/mat.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace DynaRange::IO::Raw {
+
+/**
+ * @class RawSummary
+ * @brief A 16-bit value histogram plus per-CFA-position sums of the active area.
+ * @details Covers the 2x2-aligned part of the active area (a trailing odd row or
+ * column is ignored, as in the Bayer planes). CFA positions are indexed like
+ * the planes, i.e. BayerPlaneIndex(row_offset, col_offset).
+ */
+class RawSummary {
+public:
+    /**
+     * @brief Builds the summary of a CV_16U mosaic in a single pass.
+     * @param mosaic The active area mosaic.
+     * @return The summary, or an invalid one if the input is not CV_16UC1.
+     */
+    static RawSummary FromMosaic(const cv::Mat& mosaic);
+
+    /**
+     * @brief Builds an approximate summary from a mosaic made of sampled 2x2 blocks only.
+     * @details For sources that gather the blocks themselves (e.g. straight from a
+     * memory mapping), taking one block every few blocks in each direction so every
+     * CFA position is sampled equally. The result is marked as sampled;
+     * GetMeanStandardError() then quantifies the sampling error of the mean.
+     * @param blocks The sampled blocks, laid out as a (smaller) CV_16U mosaic.
+     */
+    static RawSummary FromSampledBlocks(const cv::Mat& blocks);
+
+    /**
+     * @brief Rebuilds a summary from its stored parts (e.g. a persisted copy).
+     * @param histogram The value histogram (bin i counts pixels of value i).
+     * @param channel_sums Sum of the pixel values of each CFA position.
+     * @param channel_counts Number of pixels of each CFA position.
+     * @return The summary, or an invalid one if the parts are inconsistent.
+     */
+    static RawSummary FromParts(std::vector<uint32_t> histogram,
+                                const std::array<uint64_t, 4>& channel_sums,
+                                const std::array<uint64_t, 4>& channel_counts);
+
+    /**
+     * @brief Adds a run of samples that belong to one CFA position.
+     * @details Used to fold the summary into other per-pixel passes (e.g. the
+     * plane deinterleaving); call Finalize() once all samples have been added.
+     * @param values Pointer to the samples.
+     * @param count Number of samples.
+     * @param position CFA position index in [0, 3].
+     */
+    void Accumulate(const uint16_t* values, int count, int position);
+
+    /**
+     * @brief Completes an accumulated summary (computes min/max, trims the histogram).
+     */
+    void Finalize();
+
+    /** @brief Checks whether the summary holds any pixel. */
+    bool IsValid() const { return m_pixel_count > 0; }
+
+    /** @brief Checks whether the summary was built from a subset of the pixels. */
+    bool IsSampled() const { return m_is_sampled; }
+
+    /** @brief Gets the number of summarized pixels. */
+    uint64_t GetPixelCount() const { return m_pixel_count; }
+
+    /** @brief Gets the mean value of all summarized pixels. */
+    double GetMean() const;
+
+    /** @brief Gets the (population) variance of the summarized pixel values. */
+    double GetVariance() const;
+
+    /**
+     * @brief Gets the standard error of GetMean() as an estimate of the full-frame mean.
+     * @return 0 for a full summary; sqrt(variance / samples) for a sampled one.
+     */
+    double GetMeanStandardError() const;
+
+    /**
+     * @brief Gets the mean value of one CFA position.
+     * @param position CFA position index in [0, 3].
+     */
+    double GetChannelMean(int position) const;
+
+    /** @brief Gets the smallest pixel value. */
+    int GetMin() const { return m_min; }
+
+    /** @brief Gets the largest pixel value. */
+    int GetMax() const { return m_max; }
+
+    /**
+     * @brief Counts the pixels whose value is greater than or equal to a threshold.
+     * @param threshold The (possibly fractional) threshold.
+     */
+    uint64_t CountAtOrAbove(double threshold) const;
+
+    /**
+     * @brief Gets the fraction of pixels at or above a threshold.
+     * @param threshold The (possibly fractional) threshold.
+     * @return A ratio in [0, 1]; 0 for an invalid summary.
+     */
+    double GetRatioAtOrAbove(double threshold) const;
+
+    /**
+     * @brief Gets the value histogram (bin i counts pixels of value i).
+     * @details Trimmed after the largest value, so its size is GetMax() + 1.
+     */
+    const std::vector<uint32_t>& GetHistogram() const { return m_histogram; }
+
+    /** @brief Gets the sum of the pixel values of one CFA position. */
+    uint64_t GetChannelSum(int position) const { return m_channel_sums[position]; }
+
+    /** @brief Gets the number of pixels of one CFA position. */
+    uint64_t GetChannelCount(int position) const { return m_channel_counts[position]; }
+
+private:
+    std::vector<uint32_t> m_histogram;
+    std::array<uint64_t, 4> m_channel_sums{};
+    std::array<uint64_t, 4> m_channel_counts{};
+    uint64_t m_pixel_count = 0;
+    int m_min = 0;
+    int m_max = 0;
+    bool m_is_sampled = false;
+};
+
+} // namespace DynaRange::IO::Raw
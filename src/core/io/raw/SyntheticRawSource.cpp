@@ -0,0 +1,96 @@
+// File: src/core/io/raw/SyntheticRawSource.cpp
+/**
+ * @file src/core/io/raw/SyntheticRawSource.cpp
+ * @brief Implements the in-memory synthetic backend.
+ */
+#include "SyntheticRawSource.hpp"
+#include "Constants.hpp"
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace DynaRange::IO::Raw {
+
+namespace {
+    struct Registry {
+        std::mutex mutex;
+        std::map<std::string, std::pair<RawMetadata, cv::Mat>> images;
+    };
+
+    Registry& GetRegistry() {
+        static Registry registry;
+        return registry;
+    }
+}
+
+SyntheticRawSource::SyntheticRawSource(RawMetadata metadata, cv::Mat sensor_image)
+    : m_metadata(std::move(metadata))
+    , m_sensor_image(std::move(sensor_image))
+{
+    m_metadata.raw_width = m_sensor_image.cols;
+    m_metadata.raw_height = m_sensor_image.rows;
+    if (m_metadata.active_width <= 0 || m_metadata.active_height <= 0) {
+        m_metadata.active_width = m_sensor_image.cols - m_metadata.left_margin;
+        m_metadata.active_height = m_sensor_image.rows - m_metadata.top_margin;
+    }
+    m_metadata.sensor_resolution_mpx = static_cast<double>(m_sensor_image.cols) * m_sensor_image.rows / 1000000.0;
+    m_metadata.has_raw_mosaic = !m_sensor_image.empty() && m_sensor_image.type() == CV_16UC1;
+}
+
+std::string SyntheticRawSource::Register(const std::string& name, RawMetadata metadata, cv::Mat sensor_image) {
+    std::string filename = std::string(Constants::SYNTHETIC_SOURCE_PREFIX) + name;
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.images[filename] = { std::move(metadata), std::move(sensor_image) };
+    return filename;
+}
+
+void SyntheticRawSource::Unregister(const std::string& filename) {
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.images.erase(filename);
+}
+
+std::unique_ptr<RawSource> SyntheticRawSource::Find(const std::string& filename) {
+    if (filename.rfind(Constants::SYNTHETIC_SOURCE_PREFIX, 0) != 0) return nullptr;
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.images.find(filename);
+    if (it == registry.images.end()) return nullptr;
+    return std::make_unique<SyntheticRawSource>(it->second.first, it->second.second);
+}
+
+bool SyntheticRawSource::Open(std::shared_ptr<MappedFile>) {
+    return !m_sensor_image.empty();
+}
+
+RawMetadata SyntheticRawSource::GetMetadata() const {
+    return m_metadata;
+}
+
+bool SyntheticRawSource::Unpack() {
+    return !m_sensor_image.empty();
+}
+
+void SyntheticRawSource::Release() {
+    // The image is the source itself: there is nothing to reload it from.
+}
+
+cv::Mat SyntheticRawSource::GetRawImage() const {
+    return m_sensor_image;
+}
+
+cv::Mat SyntheticRawSource::GetActiveRawView() const {
+    cv::Rect active_area(m_metadata.left_margin, m_metadata.top_margin, m_metadata.active_width, m_metadata.active_height);
+    if (m_sensor_image.empty() || active_area.x < 0 || active_area.y < 0 || active_area.width <= 0 || active_area.height <= 0 ||
+        active_area.x + active_area.width > m_sensor_image.cols || active_area.y + active_area.height > m_sensor_image.rows) {
+        return m_sensor_image;
+    }
+    return m_sensor_image(active_area);
+}
+
+cv::Mat SyntheticRawSource::GetProcessedImage() {
+    return RenderMosaicPreview(GetActiveRawView(), m_metadata);
+}
+
+} // namespace DynaRange::IO::Raw
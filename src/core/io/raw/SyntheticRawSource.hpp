@@ -0,0 +1,63 @@
+// File: src/core/io/raw/SyntheticRawSource.hpp
+/**
+ * @file src/core/io/raw/SyntheticRawSource.hpp
+ * @brief Declares an in-memory backend serving a mosaic generated by the program.
+ * @details Registered sources are addressed by name like files, so the whole
+ * engine (cache, pre-analysis, analysis) can run on them unchanged, e.g. for
+ * benchmarks or to validate the estimators against a known ground truth.
+ */
+#pragma once
+
+#include "RawSource.hpp"
+
+namespace DynaRange::IO::Raw {
+
+/**
+ * @class SyntheticRawSource
+ * @brief Serves a CV_16U sensor image held in memory.
+ */
+class SyntheticRawSource : public RawSource {
+public:
+    /**
+     * @brief Constructs the source.
+     * @param metadata The metadata to report. Sensor dimensions are taken from the
+     *        image; an unset active area defaults to the whole image.
+     * @param sensor_image The full sensor image (CV_16U). It is shared, not copied.
+     */
+    SyntheticRawSource(RawMetadata metadata, cv::Mat sensor_image);
+
+    /**
+     * @brief Makes a synthetic image available under a file-like name.
+     * @param name A unique name for the image.
+     * @param metadata The metadata to report (see the constructor).
+     * @param sensor_image The full sensor image (CV_16U).
+     * @return The name to pass as a filename (Constants::SYNTHETIC_SOURCE_PREFIX + name).
+     */
+    static std::string Register(const std::string& name, RawMetadata metadata, cv::Mat sensor_image);
+
+    /**
+     * @brief Removes a registered image.
+     * @param filename The name returned by Register().
+     */
+    static void Unregister(const std::string& filename);
+
+    /**
+     * @brief Creates a source for a registered name.
+     * @return The source, or nullptr if no image is registered under @p filename.
+     */
+    static std::unique_ptr<RawSource> Find(const std::string& filename);
+
+    bool Open(std::shared_ptr<MappedFile> mapped_file) override;
+    RawMetadata GetMetadata() const override;
+    bool Unpack() override;
+    void Release() override;
+    cv::Mat GetRawImage() const override;
+    cv::Mat GetActiveRawView() const override;
+    cv::Mat GetProcessedImage() override;
+
+private:
+    RawMetadata m_metadata;
+    cv::Mat m_sensor_image;
+};
+
+} // namespace DynaRange::IO::Raw
@@ -7,6 +7,22 @@
 
 namespace DynaRange::Math::Estimation {
 
+    /**
+     * @brief Selects the sufficient-statistics Newton estimator for truncated normal estimation.
+     * @details When true, samples are reduced to their sufficient statistics and solved
+     * with analytic Newton steps; USE_LBFGSPP_ESTIMATOR is then ignored.
+     */
+    constexpr bool USE_NEWTON_ESTIMATOR = true;
+
+    /// Maximum number of Newton iterations.
+    constexpr int NEWTON_MAX_ITERATIONS = 50;
+
+    /// Relative parameter change below which the Newton iterations stop.
+    constexpr double NEWTON_TOLERANCE = 1e-10;
+
+    /// Maximum number of step halvings in the Newton line search.
+    constexpr int NEWTON_MAX_STEP_HALVINGS = 40;
+
     /**
      * @brief Selects the algorithm for truncated normal estimation.
      * @details
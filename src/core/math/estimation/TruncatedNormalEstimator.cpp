@@ -7,6 +7,7 @@
 #include "Constants.hpp"                 
 #include "../../math/Math.hpp"          // Para CalculateMean
 #include <numeric>                      // Para std::accumulate
+#include <algorithm>                    // Para std::max
 #include <cmath>                        // Para std::sqrt
 #include <vector>                       // Para std::vector
 
@@ -28,6 +29,41 @@ std::optional<NormalParameters> EstimateWithGradientDescent(
     double mu_init,
     double sigma_init);
 
+// Declaración de la función que usará pasos de Newton analíticos (definida en newton_optimizer.cpp)
+std::optional<NormalParameters> EstimateWithNewton(
+    const CensoredSample& sample,
+    double truncation_point,
+    double mu_init,
+    double sigma_init);
+
+// Declaración de la versión por lotes (definida en newton_optimizer.cpp). Parte de las
+// estimaciones iniciales en result.mu/sigma de las muestras con result.valid = 1.
+void EstimateBatchWithNewton(
+    const CensoredSampleBatch& batch,
+    double truncation_point,
+    BatchEstimate& result);
+
+// Estimación inicial a partir de los momentos de los valores no censurados
+// (o de todos si hay menos de dos sin censurar).
+void ComputeInitialGuess(const CensoredSample& sample, double truncation_point, double& mu_init, double& sigma_init) {
+    const size_t total = sample.censored_count + sample.count;
+    double n = static_cast<double>(sample.count);
+    double sum = sample.sum;
+    double sum_sq = sample.sum_sq;
+    if (sample.count < 2) {
+        n = static_cast<double>(total);
+        sum += sample.censored_count * truncation_point;
+        sum_sq += sample.censored_count * truncation_point * truncation_point;
+    }
+    mu_init = sum / n;
+    sigma_init = std::sqrt(std::max(sum_sq / n - mu_init * mu_init, 0.0));
+
+    if (sigma_init <= 1e-9) {
+         if (mu_init > 1e-9) sigma_init = mu_init * 0.01;
+         else sigma_init = 1e-6;
+    }
+}
+
 // Función auxiliar para calcular stddev (si no existe en Math.cpp)
 double CalculateStdDev(const std::vector<double>& data, double mean) {
     if (data.size() < 2) return 0.0;
@@ -44,6 +80,59 @@ double CalculateStdDev(const std::vector<double>& data, double mean) {
 
 namespace DynaRange::Math::Estimation {
 
+void CensoredSampleBatch::Reserve(size_t size) {
+    censored_count.reserve(size);
+    count.reserve(size);
+    sum.reserve(size);
+    sum_sq.reserve(size);
+}
+
+void CensoredSampleBatch::Add(const CensoredSample& sample) {
+    censored_count.push_back(sample.censored_count);
+    count.push_back(sample.count);
+    sum.push_back(sample.sum);
+    sum_sq.push_back(sample.sum_sq);
+}
+
+CensoredSample CensoredSampleBatch::Get(size_t index) const {
+    return CensoredSample{censored_count[index], count[index], sum[index], sum_sq[index]};
+}
+
+CensoredSample SummarizeCensoredSample(const std::vector<double>& truncated_data, double truncation_point) {
+    CensoredSample sample;
+    for (double val : truncated_data) {
+        if (val <= truncation_point) {
+            ++sample.censored_count;
+        } else {
+            ++sample.count;
+            sample.sum += val;
+            sample.sum_sq += val * val;
+        }
+    }
+    return sample;
+}
+
+std::optional<NormalParameters> EstimateTruncatedNormal(
+    const CensoredSample& sample,
+    double truncation_point,
+    double initial_mu,
+    double initial_sigma)
+{
+    const size_t total = sample.censored_count + sample.count;
+    if (total < 3 || sample.count == 0) {
+        return std::nullopt;
+    }
+
+    double mu_init = initial_mu;
+    double sigma_init = initial_sigma;
+
+    if (mu_init < 0.0 || sigma_init < 0.0) {
+        Internal::ComputeInitialGuess(sample, truncation_point, mu_init, sigma_init);
+    }
+
+    return Internal::EstimateWithNewton(sample, truncation_point, mu_init, sigma_init);
+}
+
 std::optional<NormalParameters> EstimateTruncatedNormal(
     const std::vector<double>& truncated_data,
     double truncation_point,
@@ -54,6 +143,10 @@ std::optional<NormalParameters> EstimateTruncatedNormal(
         return std::nullopt;
     }
 
+    if constexpr (USE_NEWTON_ESTIMATOR) {
+        return EstimateTruncatedNormal(SummarizeCensoredSample(truncated_data, truncation_point), truncation_point, initial_mu, initial_sigma);
+    }
+
     double mu_init = initial_mu;
     double sigma_init = initial_sigma;
 
@@ -90,4 +183,23 @@ std::optional<NormalParameters> EstimateTruncatedNormal(
     }
 }
 
+BatchEstimate EstimateTruncatedNormalBatch(const CensoredSampleBatch& batch, double truncation_point) {
+    const size_t size = batch.Size();
+    BatchEstimate result;
+    result.mu.assign(size, 0.0);
+    result.sigma.assign(size, 0.0);
+    result.valid.assign(size, 0);
+    result.converged.assign(size, 0);
+    result.iterations.assign(size, 0);
+
+    for (size_t i = 0; i < size; ++i) {
+        const CensoredSample sample = batch.Get(i);
+        if (sample.censored_count + sample.count < 3 || sample.count == 0) continue;
+        Internal::ComputeInitialGuess(sample, truncation_point, result.mu[i], result.sigma[i]);
+        result.valid[i] = 1;
+    }
+    Internal::EstimateBatchWithNewton(batch, truncation_point, result);
+    return result;
+}
+
 } // namespace DynaRange::Math::Estimation
\ No newline at end of file
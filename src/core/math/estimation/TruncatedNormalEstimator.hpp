@@ -5,6 +5,8 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <optional>
 
@@ -19,6 +21,60 @@ struct NormalParameters {
     double sigma;  ///< Estimated standard deviation (σ).
 };
 
+/**
+ * @struct CensoredSample
+ * @brief The sufficient statistics of a left-censored normal sample.
+ * @details The censored log-likelihood only depends on how many observations were
+ * censored and on the count, sum and sum of squares of the others, so a sample is
+ * reduced to these once and every iteration of the estimator costs O(1).
+ */
+struct CensoredSample {
+    size_t censored_count = 0; ///< Observations at or below the truncation point.
+    size_t count = 0;          ///< Observations above the truncation point.
+    double sum = 0.0;          ///< Sum of the observations above the truncation point.
+    double sum_sq = 0.0;       ///< Sum of their squares.
+};
+
+/**
+ * @struct CensoredSampleBatch
+ * @brief The sufficient statistics of many samples, one contiguous array per field.
+ */
+struct CensoredSampleBatch {
+    std::vector<size_t> censored_count; ///< See CensoredSample::censored_count.
+    std::vector<size_t> count;          ///< See CensoredSample::count.
+    std::vector<double> sum;            ///< See CensoredSample::sum.
+    std::vector<double> sum_sq;         ///< See CensoredSample::sum_sq.
+
+    /// @brief Gets the number of samples.
+    size_t Size() const { return count.size(); }
+    /// @brief Reserves room for a number of samples.
+    void Reserve(size_t size);
+    /// @brief Appends a sample.
+    void Add(const CensoredSample& sample);
+    /// @brief Gets the statistics of one sample.
+    CensoredSample Get(size_t index) const;
+};
+
+/**
+ * @struct BatchEstimate
+ * @brief The per-sample results of a batched estimation, indexed like the batch.
+ */
+struct BatchEstimate {
+    std::vector<double> mu;         ///< Estimated means.
+    std::vector<double> sigma;      ///< Estimated standard deviations.
+    std::vector<uint8_t> valid;     ///< 1 where mu and sigma are usable (what the scalar API returns as a value).
+    std::vector<uint8_t> converged; ///< 1 where the iterations met the tolerance before the iteration limit.
+    std::vector<int> iterations;    ///< Newton iterations performed (0 for closed-form and invalid samples).
+};
+
+/**
+ * @brief Reduces a left-censored sample to its sufficient statistics.
+ * @param truncated_data The observed data points.
+ * @param truncation_point The value at or below which data points are censored.
+ * @return The sufficient statistics of the sample.
+ */
+CensoredSample SummarizeCensoredSample(const std::vector<double>& truncated_data, double truncation_point);
+
 /**
  * @brief Estimates the original mean (mu) and standard deviation (sigma)
  * of a normal distribution given data that has been left-truncated.
@@ -37,4 +93,36 @@ std::optional<NormalParameters> EstimateTruncatedNormal(
     double initial_sigma = -1.0
 );
 
+/**
+ * @brief Estimates the parameters of a left-censored normal from its sufficient statistics.
+ * @details Maximizes the censored log-likelihood with Newton steps on the analytic
+ * gradient and Hessian, falling back to a Fisher scoring step where the Hessian is
+ * not negative definite, with step halving to guarantee ascent.
+ * @param sample The sufficient statistics of the data.
+ * @param truncation_point The value below which the original data was truncated (e.g., 0.0).
+ * @param initial_mu An initial guess for the mean. If negative, calculated from data mean.
+ * @param initial_sigma An initial guess for the standard deviation. If negative, calculated from data stddev.
+ * @return The estimated NormalParameters, or std::nullopt if the sample is too small
+ * or the estimation fails.
+ */
+std::optional<NormalParameters> EstimateTruncatedNormal(
+    const CensoredSample& sample,
+    double truncation_point,
+    double initial_mu = -1.0,
+    double initial_sigma = -1.0
+);
+
+/**
+ * @brief Estimates the parameters of many left-censored normals in one call.
+ * @details Samples are iterated one after another with the scalar Newton step (it
+ * needs erfc() and a step-halving search per sample, so it is not SIMD-vectorized);
+ * batching saves the per-patch dispatch. They share the scalar API's initial guess
+ * and failure rules: valid[i] is 1 exactly where EstimateTruncatedNormal(batch.Get(i), ...)
+ * returns a value.
+ * @param batch The sufficient statistics of the samples.
+ * @param truncation_point The value below which the original data was truncated (e.g., 0.0).
+ * @return The estimates, with per-sample convergence flags and iteration counts.
+ */
+BatchEstimate EstimateTruncatedNormalBatch(const CensoredSampleBatch& batch, double truncation_point);
+
 } // namespace DynaRange::Math::Estimation
\ No newline at end of file
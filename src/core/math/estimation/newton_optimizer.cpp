@@ -0,0 +1,215 @@
+// File: src/core/math/estimation/newton_optimizer.cpp
+/**
+ * @file src/core/math/estimation/newton_optimizer.cpp
+ * @brief Implements censored normal estimation with analytic Newton steps on sufficient statistics.
+ * @details With m censored observations at c and n observations x_i above it, the
+ * log-likelihood is, up to a constant,
+ *   LL(mu, sigma) = m log Phi(z) - n log sigma - Q / (2 sigma^2),
+ * where z = (c - mu) / sigma and Q = sum (x_i - mu)^2 = M2 + n (mean - mu)^2.
+ * Its gradient and Hessian are closed-form in (m, n, mean, M2), so each iteration
+ * is O(1) regardless of the number of pixels.
+ */
+#include "TruncatedNormalEstimator.hpp"
+#include "Constants.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+namespace DynaRange::Math::Estimation::Internal {
+
+namespace {
+
+constexpr double LOG_SQRT_2PI = 0.91893853320467274178;
+
+/**
+ * @brief Computes log Phi(z) and the inverse Mills ratio phi(z) / Phi(z).
+ * @details Uses the asymptotic expansion of the lower tail where Phi(z) underflows.
+ */
+void LogCdfAndMillsRatio(double z, double& log_cdf, double& mills) {
+    if (z < -30.0) {
+        const double inv_z2 = 1.0 / (z * z);
+        const double series = 1.0 - inv_z2 + 3.0 * inv_z2 * inv_z2;
+        log_cdf = -0.5 * z * z - std::log(-z) - LOG_SQRT_2PI + std::log(series);
+        mills = -z / series;
+        return;
+    }
+    const double cdf = 0.5 * std::erfc(-z * M_SQRT1_2);
+    log_cdf = std::log(cdf);
+    mills = std::exp(-0.5 * z * z - LOG_SQRT_2PI) / cdf;
+}
+
+/// The reduced sample the likelihood is evaluated on.
+struct Moments {
+    double censored; ///< m
+    double count;    ///< n
+    double mean;     ///< Mean of the uncensored observations.
+    double m2;       ///< Sum of their squared deviations from the mean.
+};
+
+double LogLikelihood(const Moments& s, double c, double mu, double sigma) {
+    double log_cdf = 0.0, mills = 0.0;
+    LogCdfAndMillsRatio((c - mu) / sigma, log_cdf, mills);
+    const double d = s.mean - mu;
+    const double q = s.m2 + s.count * d * d;
+    return s.censored * log_cdf - s.count * std::log(sigma) - q / (2.0 * sigma * sigma);
+}
+
+/// The iteration state of one sample.
+struct NewtonState {
+    Moments s;
+    double mu;
+    double sigma;
+    double ll;
+    int iterations = 0;
+    bool converged = false;
+};
+
+/**
+ * @brief Reduces a sample to the moments the likelihood is evaluated on.
+ * @return false if no observation is above the truncation point.
+ */
+bool ToMoments(const CensoredSample& sample, Moments& s) {
+    if (sample.count == 0) return false;
+    const double n = static_cast<double>(sample.count);
+    s.censored = static_cast<double>(sample.censored_count);
+    s.count = n;
+    s.mean = sample.sum / n;
+    s.m2 = std::max(sample.sum_sq - sample.sum * s.mean, 0.0);
+    return true;
+}
+
+/**
+ * @brief Performs one Newton iteration with step halving.
+ * @return true if the state can still move, false once it converged or no ascent is left.
+ */
+bool NewtonIterate(NewtonState& state, double c) {
+    const Moments& s = state.s;
+    const double mu = state.mu;
+    const double sigma = state.sigma;
+    const double z = (c - mu) / sigma;
+    double log_cdf = 0.0, lambda = 0.0;
+    LogCdfAndMillsRatio(z, log_cdf, lambda);
+    const double dlambda = -lambda * (z + lambda);
+    const double n = s.count;
+    const double d = s.mean - mu;
+    const double q = s.m2 + n * d * d;
+    const double sigma2 = sigma * sigma;
+    const double m = s.censored;
+
+    const double g_mu = -m * lambda / sigma + n * d / sigma2;
+    const double g_sigma = -m * lambda * z / sigma - n / sigma + q / (sigma2 * sigma);
+    const double h_mm = (m * dlambda - n) / sigma2;
+    const double h_ms = (m * dlambda * z + m * lambda) / sigma2 - 2.0 * n * d / (sigma2 * sigma);
+    const double h_ss = (m * (dlambda * z * z + 2.0 * lambda * z) + n) / sigma2 - 3.0 * q / (sigma2 * sigma2);
+
+    double step_mu = 0.0, step_sigma = 0.0;
+    const double det = h_mm * h_ss - h_ms * h_ms;
+    if (h_mm < 0.0 && det > 0.0) {
+        // Newton step: -H^-1 g.
+        step_mu = -(h_ss * g_mu - h_ms * g_sigma) / det;
+        step_sigma = -(h_mm * g_sigma - h_ms * g_mu) / det;
+    } else {
+        // Fisher scoring with the information of an uncensored sample of the same size.
+        const double total = m + n;
+        step_mu = g_mu * sigma2 / total;
+        step_sigma = g_sigma * sigma2 / (2.0 * total);
+    }
+
+    ++state.iterations;
+
+    // Step halving: keep sigma positive and the likelihood non-decreasing.
+    double t = 1.0;
+    for (int halving = 0; halving < NEWTON_MAX_STEP_HALVINGS; ++halving, t *= 0.5) {
+        const double next_mu = mu + t * step_mu;
+        const double next_sigma = sigma + t * step_sigma;
+        if (next_sigma <= 0.0) continue;
+        const double next_ll = LogLikelihood(s, c, next_mu, next_sigma);
+        if (std::isfinite(next_ll) && next_ll >= state.ll) {
+            state.converged = std::abs(next_mu - mu) <= NEWTON_TOLERANCE * (sigma + std::abs(mu)) &&
+                              std::abs(next_sigma - sigma) <= NEWTON_TOLERANCE * sigma;
+            state.mu = next_mu;
+            state.sigma = next_sigma;
+            state.ll = next_ll;
+            return !state.converged;
+        }
+    }
+    // No ascent left at double precision: the current point is the maximum.
+    state.converged = true;
+    return false;
+}
+
+bool IsValidEstimate(double mu, double sigma) {
+    return std::isfinite(mu) && std::isfinite(sigma) && sigma > 0;
+}
+
+/**
+ * @brief Maximizes the likelihood of one sample from an initial guess.
+ * @param state Receives the iteration count and whether the tolerance was met.
+ */
+std::optional<NormalParameters> SolveWithNewton(
+    const CensoredSample& sample,
+    double truncation_point,
+    double mu_init,
+    double sigma_init,
+    NewtonState& state)
+{
+    if (!ToMoments(sample, state.s)) {
+        return std::nullopt;
+    }
+
+    // Without censoring the maximum is the sample mean and (biased) stddev.
+    if (sample.censored_count == 0) {
+        const double sigma = std::sqrt(state.s.m2 / state.s.count);
+        if (!(sigma > 0.0)) return std::nullopt;
+        state.converged = true;
+        return NormalParameters{state.s.mean, sigma};
+    }
+
+    state.mu = mu_init;
+    state.sigma = sigma_init;
+    state.ll = LogLikelihood(state.s, truncation_point, mu_init, sigma_init);
+    if (!std::isfinite(state.ll)) {
+        return std::nullopt;
+    }
+    while (state.iterations < NEWTON_MAX_ITERATIONS && NewtonIterate(state, truncation_point)) {
+    }
+
+    if (!IsValidEstimate(state.mu, state.sigma)) {
+        return std::nullopt;
+    }
+    return NormalParameters{state.mu, state.sigma};
+}
+
+} // namespace
+
+std::optional<NormalParameters> EstimateWithNewton(
+    const CensoredSample& sample,
+    double truncation_point,
+    double mu_init,
+    double sigma_init)
+{
+    NewtonState state;
+    return SolveWithNewton(sample, truncation_point, mu_init, sigma_init, state);
+}
+
+void EstimateBatchWithNewton(
+    const CensoredSampleBatch& batch,
+    double truncation_point,
+    BatchEstimate& result)
+{
+    for (size_t i = 0; i < batch.Size(); ++i) {
+        if (!result.valid[i]) continue;
+        NewtonState state;
+        const auto estimate = SolveWithNewton(batch.Get(i), truncation_point, result.mu[i], result.sigma[i], state);
+        result.iterations[i] = state.iterations;
+        result.converged[i] = estimate && state.converged ? 1 : 0;
+        result.valid[i] = estimate ? 1 : 0;
+        if (estimate) {
+            result.mu[i] = estimate->mu;
+            result.sigma[i] = estimate->sigma;
+        }
+    }
+}
+
+} // namespace DynaRange::Math::Estimation::Internal
@@ -5,11 +5,11 @@
  */
 #include "CalibrationEstimator.hpp"
 #include "../io/raw/RawFile.hpp"
+#include "../io/raw/RawSummary.hpp"
 #include "../arguments/ArgumentsOptions.hpp" // For DEFAULT_BLACK_LEVEL
 #include <libintl.h>
 #include <filesystem>
 #include <cmath>
-#include <opencv2/core.hpp> // For cv::minMaxLoc
 #include <algorithm> // For std::min_element, std::max_element
 
 #define _(string) gettext(string)
@@ -17,7 +17,7 @@ namespace fs = std::filesystem;
 
 namespace CalibrationEstimator {
 
-std::optional<double> EstimateBlackLevel(const ProgramOptions& opts, const std::vector<FileInfo>& file_info, std::ostream& log_stream) {
+std::optional<double> EstimateBlackLevel(const ProgramOptions& opts, const std::vector<FileInfo>& file_info, std::ostream& log_stream, DynaRange::IO::Raw::RawFileCache* raw_cache) {
     if (file_info.empty()) {
         return std::nullopt;
     }
@@ -32,20 +32,23 @@ std::optional<double> EstimateBlackLevel(const ProgramOptions& opts, const std::
     log_stream << _("  - Selecting '") << fs::path(estimation_file).filename().string() 
                << _("' for estimation (it is the darkest image).") << std::endl;
 
-    RawFile raw_file(estimation_file);
-    if (!raw_file.Load()) {
-        log_stream << _("  - [Warning] Could not open RAW file to estimate black level: ") << estimation_file << std::endl;
-        return std::nullopt;
+    // The exact pre-analysis summary answers without opening the file again.
+    auto summary = darkest_file_it->summary;
+    if (!summary || summary->IsSampled()) {
+        std::optional<RawFile> local_file;
+        const RawFile* raw_file = DynaRange::IO::Raw::AcquireRawFile(raw_cache, estimation_file, local_file);
+        if (!raw_file) {
+            log_stream << _("  - [Warning] Could not open RAW file to estimate black level: ") << estimation_file << std::endl;
+            return std::nullopt;
+        }
+        summary = raw_file->GetSummary();
     }
-
-    cv::Mat active_img = raw_file.GetActiveRawImage();
-    if (active_img.empty()) {
+    if (!summary || !summary->IsValid()) {
         log_stream << _("  - [Warning] Could not get active image area to estimate black level.") << std::endl;
         return std::nullopt;
     }
 
-    double min_val, max_val;
-    cv::minMaxLoc(active_img, &min_val, &max_val);
+    double min_val = summary->GetMin();
 
     if (min_val <= 1.0) {
         log_stream << _("  - [Warning] Minimum pixel value is too low to reliably estimate black level. Using fallback.") << std::endl;
@@ -63,7 +66,7 @@ std::optional<double> EstimateBlackLevel(const ProgramOptions& opts, const std::
     return estimated_black;
 }
 
-std::optional<double> EstimateSaturationLevel(const ProgramOptions& opts, const std::vector<FileInfo>& file_info, std::ostream& log_stream) {
+std::optional<double> EstimateSaturationLevel(const ProgramOptions& opts, const std::vector<FileInfo>& file_info, std::ostream& log_stream, DynaRange::IO::Raw::RawFileCache* raw_cache) {
     if (file_info.empty()) {
         return std::nullopt;
     }
@@ -76,13 +79,19 @@ std::optional<double> EstimateSaturationLevel(const ProgramOptions& opts, const
 
     const std::string& estimation_file = highest_iso_file_it->filename;
 
-    RawFile raw_file(estimation_file);
-    if (!raw_file.Load()) {
-        log_stream << _("  - [Warning] Could not open RAW file to estimate saturation level: ") << estimation_file << std::endl;
-        return std::nullopt;
+    // The bit depth recorded by the pre-analysis answers without opening the file again.
+    std::optional<int> bit_depth_opt;
+    if (highest_iso_file_it->bit_depth > 0) {
+        bit_depth_opt = highest_iso_file_it->bit_depth;
+    } else {
+        std::optional<RawFile> local_file;
+        const RawFile* raw_file = DynaRange::IO::Raw::AcquireRawFile(raw_cache, estimation_file, local_file);
+        if (!raw_file) {
+            log_stream << _("  - [Warning] Could not open RAW file to estimate saturation level: ") << estimation_file << std::endl;
+            return std::nullopt;
+        }
+        bit_depth_opt = raw_file->GetBitDepth();
     }
-    
-    std::optional<int> bit_depth_opt = raw_file.GetBitDepth();
     int bit_depth;
 
     if (bit_depth_opt.has_value()) {
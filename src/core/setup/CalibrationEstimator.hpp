@@ -9,6 +9,7 @@
 
 #include "../arguments/ArgumentsOptions.hpp"
 #include "MetadataExtractor.hpp" // For FileInfo
+#include "../io/raw/RawFileCache.hpp"
 #include <optional>
 #include <ostream>
 #include <vector>
@@ -20,9 +21,10 @@ namespace CalibrationEstimator {
  * @param opts Program options.
  * @param file_info A vector of pre-analyzed file metadata.
  * @param log_stream Stream for logging messages.
+ * @param raw_cache Optional run-scoped decode cache to borrow the already loaded file from.
  * @return An optional containing the estimated black level, or std::nullopt on failure.
  */
-std::optional<double> EstimateBlackLevel(const ProgramOptions& opts, const std::vector<FileInfo>& file_info, std::ostream& log_stream);
+std::optional<double> EstimateBlackLevel(const ProgramOptions& opts, const std::vector<FileInfo>& file_info, std::ostream& log_stream, DynaRange::IO::Raw::RawFileCache* raw_cache = nullptr);
 
 /**
  * @brief Estimates the saturation level from the highest ISO input file.
@@ -31,8 +33,9 @@ std::optional<double> EstimateBlackLevel(const ProgramOptions& opts, const std::
  * @param opts Program options.
  * @param file_info A vector of pre-analyzed file metadata.
  * @param log_stream Stream for logging messages.
+ * @param raw_cache Optional run-scoped decode cache to borrow the already loaded file from.
  * @return An optional containing the estimated saturation level, or std::nullopt on failure.
  */
-std::optional<double> EstimateSaturationLevel(const ProgramOptions& opts, const std::vector<FileInfo>& file_info, std::ostream& log_stream);
+std::optional<double> EstimateSaturationLevel(const ProgramOptions& opts, const std::vector<FileInfo>& file_info, std::ostream& log_stream, DynaRange::IO::Raw::RawFileCache* raw_cache = nullptr);
 
 } // namespace CalibrationEstimator
\ No newline at end of file
@@ -0,0 +1,219 @@
+// File: src/core/setup/CalibrationProfileStore.cpp
+/**
+ * @file src/core/setup/CalibrationProfileStore.cpp
+ * @brief Implements the persistent on-disk store of calibration profiles.
+ */
+#include "CalibrationProfileStore.hpp"
+#include "Constants.hpp"
+#include "../utils/CacheFileUtils.hpp"
+#include "../utils/PlatformUtils.hpp"
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <locale>
+#include <sstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+using CacheFileUtils::HashString;
+using CacheFileUtils::ToHex;
+
+namespace {
+    constexpr const char* PROFILE_FILE_MAGIC = "DynaRangeCalibrationProfile";
+
+    std::string GetUtcTimestamp() {
+        const std::time_t now = std::time(nullptr);
+        std::tm utc{};
+#ifdef _WIN32
+        gmtime_s(&utc, &now);
+#else
+        gmtime_r(&now, &utc);
+#endif
+        std::ostringstream ss;
+        ss << std::put_time(&utc, "%Y-%m-%dT%H:%M:%SZ");
+        return ss.str();
+    }
+
+    /// Reads the rest of a "key value" line; values may be empty or contain spaces.
+    bool ReadTextField(std::istream& stream, const char* name, std::string& value) {
+        std::string key;
+        if (!(stream >> key) || key != name || !std::getline(stream, value)) return false;
+        if (!value.empty()) value.erase(0, 1);
+        return true;
+    }
+
+    void WriteRecord(std::ostream& stream, const char* name, const std::optional<CalibrationRecord>& record) {
+        stream << "record " << name << " " << (record ? 1 : 0) << "\n";
+        if (!record) return;
+        stream << "level " << std::setprecision(17) << record->level << "\n";
+        stream << "channel_levels " << (record->channel_levels ? 1 : 0);
+        if (record->channel_levels) {
+            for (double level : *record->channel_levels) stream << " " << level;
+        }
+        stream << "\n";
+        stream << "source " << record->source << "\n";
+        stream << "fingerprint " << record->fingerprint << "\n";
+        stream << "created " << record->created << "\n";
+        stream << "files " << record->files.size() << "\n";
+        for (const auto& file : record->files) stream << file << "\n";
+    }
+
+    /// @return false if the stream is malformed; `record` is left empty for absent records.
+    bool ReadRecord(std::istream& stream, const char* name, std::optional<CalibrationRecord>& record) {
+        std::string key, stored_name;
+        int present = 0;
+        if (!(stream >> key >> stored_name >> present) || key != "record" || stored_name != name) return false;
+        if (!present) return true;
+
+        CalibrationRecord result;
+        int has_channels = 0;
+        size_t file_count = 0;
+        if (!(stream >> key >> result.level) || key != "level") return false;
+        if (!(stream >> key >> has_channels) || key != "channel_levels") return false;
+        if (has_channels) {
+            std::array<double, 4> levels{};
+            for (double& level : levels) {
+                if (!(stream >> level)) return false;
+            }
+            result.channel_levels = levels;
+        }
+        if (!ReadTextField(stream, "source", result.source)) return false;
+        if (!ReadTextField(stream, "fingerprint", result.fingerprint)) return false;
+        if (!ReadTextField(stream, "created", result.created)) return false;
+        if (!(stream >> key >> file_count) || key != "files") return false;
+        stream >> std::ws;
+        for (size_t i = 0; i < file_count; ++i) {
+            std::string file;
+            if (!std::getline(stream, file)) return false;
+            result.files.push_back(std::move(file));
+        }
+        record = std::move(result);
+        return true;
+    }
+}
+
+std::string CalibrationProfileKey::ToString() const {
+    std::ostringstream ss;
+    ss.imbue(std::locale::classic());
+    ss << camera_model;
+    if (!serial_number.empty()) ss << " #" << serial_number;
+    ss << ", ISO " << iso_speed;
+    if (bit_depth > 0) ss << ", " << bit_depth << "-bit";
+    return ss.str();
+}
+
+std::vector<CalibrationProfileGroup> MakeCalibrationProfileGroups(const std::vector<FileInfo>& file_info) {
+    std::vector<CalibrationProfileGroup> groups;
+    if (file_info.empty() || file_info.front().camera_model.empty()) return groups;
+    const FileInfo& first = file_info.front();
+    for (const auto& info : file_info) {
+        if (info.camera_model != first.camera_model || info.serial_number != first.serial_number ||
+            info.bit_depth != first.bit_depth) {
+            return {};
+        }
+        auto group = std::find_if(groups.begin(), groups.end(),
+                                  [&](const CalibrationProfileGroup& g) { return g.key.iso_speed == info.iso_speed; });
+        if (group == groups.end()) {
+            groups.push_back({{first.camera_model, first.serial_number, info.iso_speed, first.bit_depth}, {}});
+            group = std::prev(groups.end());
+        }
+        group->files.push_back(info.filename);
+    }
+    std::sort(groups.begin(), groups.end(), [](const CalibrationProfileGroup& a, const CalibrationProfileGroup& b) {
+        return a.key.iso_speed < b.key.iso_speed;
+    });
+    return groups;
+}
+
+CalibrationProfileStore::CalibrationProfileStore(fs::path directory) : m_directory(std::move(directory)) {}
+
+fs::path CalibrationProfileStore::GetDefaultDirectory() {
+    fs::path base = PlatformUtils::GetUserCacheDirectory();
+    return base.empty() ? base : base / "calibration";
+}
+
+bool CalibrationProfileStore::IsEnabled() const {
+    return !m_directory.empty();
+}
+
+fs::path CalibrationProfileStore::GetEntryPath(const CalibrationProfileKey& key) const {
+    return m_directory / (ToHex(HashString(key.ToString())) + ".txt");
+}
+
+std::string CalibrationProfileStore::FingerprintFiles(const std::vector<std::string>& files) {
+    uint64_t hash = CacheFileUtils::FNV_OFFSET_BASIS;
+    for (const auto& file : files) {
+        std::error_code ec;
+        const std::string path = fs::absolute(file, ec).lexically_normal().string();
+        if (ec) return {};
+        const uintmax_t size = fs::file_size(file, ec);
+        if (ec) return {};
+        const auto mtime = fs::last_write_time(file, ec);
+        if (ec) return {};
+        hash = HashString(path + "\n" + std::to_string(size) + "\n" +
+                          std::to_string(static_cast<int64_t>(mtime.time_since_epoch().count())) + "\n", hash);
+    }
+    return ToHex(hash);
+}
+
+std::optional<CalibrationProfile> CalibrationProfileStore::Lookup(const CalibrationProfileKey& key) const {
+    if (!IsEnabled()) return std::nullopt;
+    const fs::path entry_path = GetEntryPath(key);
+    std::ifstream stream(entry_path);
+    if (!stream) return std::nullopt;
+    stream.imbue(std::locale::classic());
+
+    // Unreadable or outdated entries are removed so they are measured again.
+    auto drop = [&]() -> std::optional<CalibrationProfile> {
+        stream.close();
+        std::error_code ec;
+        fs::remove(entry_path, ec);
+        return std::nullopt;
+    };
+
+    std::string magic, key_name;
+    int version = 0;
+    CalibrationProfileKey stored;
+    if (!(stream >> magic >> version) || magic != PROFILE_FILE_MAGIC || version != DynaRange::Setup::Constants::CALIBRATION_PROFILE_VERSION) return drop();
+    if (!ReadTextField(stream, "camera_model", stored.camera_model)) return drop();
+    if (!ReadTextField(stream, "serial_number", stored.serial_number)) return drop();
+    if (!(stream >> key_name >> stored.iso_speed) || key_name != "iso_speed") return drop();
+    if (!(stream >> key_name >> stored.bit_depth) || key_name != "bit_depth") return drop();
+    // Guard against hash collisions between keys.
+    if (stored.camera_model != key.camera_model || stored.serial_number != key.serial_number ||
+        stored.iso_speed != key.iso_speed || stored.bit_depth != key.bit_depth) {
+        return std::nullopt;
+    }
+
+    CalibrationProfile profile;
+    if (!ReadRecord(stream, "black", profile.black)) return drop();
+    if (!ReadRecord(stream, "saturation", profile.saturation)) return drop();
+    return profile;
+}
+
+void CalibrationProfileStore::Store(const CalibrationProfileKey& key, const CalibrationProfile& profile) const {
+    if (!IsEnabled()) return;
+    std::error_code ec;
+    fs::create_directories(m_directory, ec);
+    if (ec) return;
+
+    // Records are timestamped here unless they carry the time they were first measured.
+    CalibrationProfile stamped = profile;
+    const std::string now = GetUtcTimestamp();
+    for (auto* record : {&stamped.black, &stamped.saturation}) {
+        if (*record && (*record)->created.empty()) (*record)->created = now;
+    }
+
+    CacheFileUtils::WriteFileAtomically(GetEntryPath(key), [&](std::ostream& stream) {
+        stream << PROFILE_FILE_MAGIC << " " << DynaRange::Setup::Constants::CALIBRATION_PROFILE_VERSION << "\n";
+        stream << "camera_model " << key.camera_model << "\n";
+        stream << "serial_number " << key.serial_number << "\n";
+        stream << "iso_speed " << std::setprecision(9) << key.iso_speed << "\n";
+        stream << "bit_depth " << key.bit_depth << "\n";
+        WriteRecord(stream, "black", stamped.black);
+        WriteRecord(stream, "saturation", stamped.saturation);
+    });
+}
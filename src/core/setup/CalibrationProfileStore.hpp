@@ -0,0 +1,123 @@
+// File: src/core/setup/CalibrationProfileStore.hpp
+/**
+ * @file src/core/setup/CalibrationProfileStore.hpp
+ * @brief Declares a persistent on-disk store of per-camera calibration results.
+ * @details Black and saturation levels are properties of a camera body at a given
+ * ISO and bit depth. Every run used to recompute them, by re-reading the dark and
+ * saturation frames or by reloading input files for the estimation heuristics. This
+ * store keeps the results, with where they came from, so a later session on the
+ * same body can skip that I/O.
+ */
+#pragma once
+
+#include "MetadataExtractor.hpp"
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @struct CalibrationProfileKey
+ * @brief Identifies the camera configuration a calibration belongs to.
+ */
+struct CalibrationProfileKey {
+    std::string camera_model;
+    std::string serial_number; ///< Empty if the files do not record one.
+    float iso_speed = 0.0f;
+    int bit_depth = 0;         ///< 0 if unknown.
+
+    /// @brief Gets a printable form of the key, e.g. for logging.
+    std::string ToString() const;
+};
+
+/**
+ * @struct CalibrationProfileGroup
+ * @brief The input files of a session that share one profile key.
+ */
+struct CalibrationProfileGroup {
+    CalibrationProfileKey key;
+    std::vector<std::string> files;
+};
+
+/**
+ * @brief Groups the pre-analyzed input files of a session by profile key.
+ * @details The inputs must come from a single body (same model, serial number and bit
+ * depth). Each ISO present among them gets its own key, since black and saturation
+ * levels may change with ISO.
+ * @param file_info The pre-analyzed input files.
+ * @return One group per ISO, in increasing ISO order; empty if the files are empty,
+ *         lack a camera model or come from several bodies.
+ */
+std::vector<CalibrationProfileGroup> MakeCalibrationProfileGroups(const std::vector<FileInfo>& file_info);
+
+/**
+ * @struct CalibrationRecord
+ * @brief One stored level with its provenance.
+ */
+struct CalibrationRecord {
+    double level = 0.0;
+    std::optional<std::array<double, 4>> channel_levels; ///< Per CfaSite, when measured from frames.
+    std::string source;                 ///< "frames" (measured from calibration frames) or "estimated".
+    std::vector<std::string> files;     ///< Files the level was measured or estimated from.
+    std::string fingerprint;            ///< Fingerprint of `files` (see FingerprintFiles()).
+    std::string created;                ///< UTC time the record was written (ISO 8601).
+};
+
+/**
+ * @struct CalibrationProfile
+ * @brief The stored calibration of one key.
+ */
+struct CalibrationProfile {
+    std::optional<CalibrationRecord> black;
+    std::optional<CalibrationRecord> saturation;
+};
+
+/**
+ * @class CalibrationProfileStore
+ * @brief Stores and retrieves calibration profiles in a directory.
+ * @details One text file per key, written with CacheFileUtils::WriteFileAtomically().
+ */
+class CalibrationProfileStore {
+public:
+    /// Source of records measured from calibration frames.
+    static constexpr const char* SOURCE_FRAMES = "frames";
+    /// Source of records estimated from the input files.
+    static constexpr const char* SOURCE_ESTIMATED = "estimated";
+
+    /**
+     * @brief Constructs a store rooted at the given directory.
+     * @param directory The store directory; an empty path disables the store.
+     */
+    explicit CalibrationProfileStore(std::filesystem::path directory = GetDefaultDirectory());
+
+    /// @brief Gets the default store directory (inside the user cache directory).
+    static std::filesystem::path GetDefaultDirectory();
+
+    /// @brief Checks whether the store has a usable directory.
+    bool IsEnabled() const;
+
+    /**
+     * @brief Looks up the profile of a key.
+     * @details Entries of an older format version or that cannot be read are removed.
+     * @return The profile, or std::nullopt if none is stored or it cannot be read.
+     */
+    std::optional<CalibrationProfile> Lookup(const CalibrationProfileKey& key) const;
+
+    /**
+     * @brief Stores the profile of a key, replacing any previous one.
+     */
+    void Store(const CalibrationProfileKey& key, const CalibrationProfile& profile) const;
+
+    /**
+     * @brief Fingerprints a set of files from their paths, sizes and modification times.
+     * @details Only file system metadata is read, never the files' contents.
+     * @return The fingerprint, or an empty string if a file cannot be inspected.
+     */
+    static std::string FingerprintFiles(const std::vector<std::string>& files);
+
+private:
+    std::filesystem::path GetEntryPath(const CalibrationProfileKey& key) const;
+
+    std::filesystem::path m_directory;
+};
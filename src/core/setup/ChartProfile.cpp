@@ -14,6 +14,7 @@ ChartProfile::ChartProfile(
     const std::vector<double>& chart_coords,
     int patches_m,
     int patches_n,
+    double patch_ratio,
     const std::optional<std::vector<cv::Point2d>>& detected_corners,
     std::ostream& log_stream)
     : m_grid_cols(patches_n),
@@ -89,6 +90,22 @@ ChartProfile::ChartProfile(
     double max_y = std::max({m_corner_points[0].y, m_corner_points[1].y, m_corner_points[2].y, m_corner_points[3].y});
 
     m_destination_points = {{min_x, min_y}, {min_x, max_y}, {max_x, max_y}, {max_x, min_y}};
+
+    // --- CROP AREA: destination rectangle minus the gap around the patch grid ---
+    double gap_x = 0.0;
+    double gap_y = 0.0;
+    // Apply gap only if corners were auto-detected (not manually specified or default)
+    if (!m_has_manual_coords) {
+        gap_x = (max_x - min_x) / (m_grid_cols + 1) / 2.0;
+        gap_y = (max_y - min_y) / (m_grid_rows + 1) / 2.0;
+    }
+    const double crop_width = round((max_x - gap_x) - (min_x + gap_x));
+    const double crop_height = round((max_y - gap_y) - (min_y + gap_y));
+    if (crop_width > 0 && crop_height > 0) {
+        m_crop_area = cv::Rect(static_cast<int>(round(min_x + gap_x)), static_cast<int>(round(min_y + gap_y)),
+                               static_cast<int>(crop_width), static_cast<int>(crop_height));
+        m_sampling_plan = CompilePatchSamplingPlan(m_crop_area->size(), m_grid_cols, m_grid_rows, patch_ratio);
+    }
 }
 
 const std::vector<cv::Point2d>& ChartProfile::GetCornerPoints() const {
@@ -111,6 +128,14 @@ bool ChartProfile::HasManualCoords() const {
     return m_has_manual_coords;
 }
 
+const std::optional<cv::Rect>& ChartProfile::GetCropArea() const {
+    return m_crop_area;
+}
+
+const PatchSamplingPlan& ChartProfile::GetSamplingPlan() const {
+    return m_sampling_plan;
+}
+
 void ChartProfile::LogCornerPoints(const std::vector<cv::Point2d>& points, const std::string& source_msg, std::ostream& log_stream) const {
     log_stream << source_msg << std::endl;
 
@@ -5,6 +5,7 @@
  */
 #pragma once
 
+#include "../analysis/PatchSamplingPlan.hpp"
 #include <vector>
 #include <optional>
 #include <opencv2/core.hpp>
@@ -21,6 +22,7 @@ public:
      * @param chart_coords Manually specified coordinates from user arguments.
      * @param patches_m The number of rows in the patch grid.
      * @param patches_n The number of columns in the patch grid.
+     * @param patch_ratio The relative area of the center of each patch to sample.
      * @param detected_corners An optional vector with coordinates from automatic detection.
      * @param log_stream The output stream for logging messages.
      */
@@ -28,6 +30,7 @@ public:
         const std::vector<double>& chart_coords,
         int patches_m,
         int patches_n,
+        double patch_ratio,
         const std::optional<std::vector<cv::Point2d>>& detected_corners,
         std::ostream& log_stream
     );
@@ -42,6 +45,19 @@ public:
     int GetGridRows() const;
     /// @brief Checks if the profile was constructed with user-provided coordinates.
     bool HasManualCoords() const;
+    /**
+     * @brief Gets the area of the keystone-corrected plane that is analyzed.
+     * @details The destination rectangle, shrunk by half a patch on every side unless
+     * the corners were given manually.
+     * @return The area, or std::nullopt if it would be empty.
+     */
+    const std::optional<cv::Rect>& GetCropArea() const;
+    /**
+     * @brief Gets the patch rectangles to sample inside the crop area.
+     * @details Compiled once at construction and shared by every file, channel and pass.
+     * @return The plan; it has no patches if there is no crop area.
+     */
+    const PatchSamplingPlan& GetSamplingPlan() const;
 
 private:
     /**
@@ -57,4 +73,6 @@ private:
     int m_grid_cols;                               ///< Number of columns of patches.
     int m_grid_rows;                               ///< Number of rows of patches.
     bool m_has_manual_coords = false;              ///< True if user-provided coords were used.
+    std::optional<cv::Rect> m_crop_area;           ///< Analyzed area of the corrected plane.
+    PatchSamplingPlan m_sampling_plan;             ///< Patch rectangles inside the crop area.
 };
\ No newline at end of file
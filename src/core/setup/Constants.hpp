@@ -5,6 +5,9 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 namespace DynaRange::Setup::Constants {
 
     /**
@@ -15,4 +18,49 @@ namespace DynaRange::Setup::Constants {
      */
     constexpr double MAX_PRE_ANALYSIS_SATURATION_RATIO = 0.001; // 0.1%
 
+    /**
+     * @brief Fraction of the saturation level from which a pixel counts as saturated
+     * in the pre-analysis check.
+     */
+    constexpr double PRE_ANALYSIS_SATURATION_FACTOR = 0.99;
+
+    /**
+     * @brief Version of the on-disk pre-analysis cache format.
+     * @details Bump it whenever the stored fields or the way they are computed change,
+     * so entries written by older versions are ignored.
+     */
+    constexpr int PRE_ANALYSIS_CACHE_VERSION = 2;
+
+    /**
+     * @brief Number of bytes hashed at the start and at the end of a file to build
+     * its pre-analysis cache key.
+     */
+    constexpr size_t PRE_ANALYSIS_CACHE_HASH_BYTES = 64 * 1024;
+
+    /**
+     * @brief Size limit of the pre-analysis cache directory.
+     * @details An entry takes from a few kB to about 200 kB (a sparse histogram), so
+     * this keeps a few thousand files. Least recently used entries are evicted first.
+     */
+    constexpr uintmax_t PRE_ANALYSIS_CACHE_MAX_BYTES = 512ull * 1024 * 1024;
+
+    /**
+     * @brief Version of the on-disk calibration profile format.
+     * @details Bump it whenever the stored fields or the way they are measured or keyed
+     * change, so profiles written by older versions are ignored.
+     */
+    constexpr int CALIBRATION_PROFILE_VERSION = 3;
+
+    /**
+     * @brief Block stride of the sampled (fast) pre-analysis.
+     * @details One 2x2 CFA block every 8 blocks in each direction, i.e. 1/64 of the pixels.
+     */
+    constexpr int FAST_PRE_ANALYSIS_BLOCK_STRIDE = 8;
+
+    /**
+     * @brief Number of standard errors in the brightness interval reported by the
+     * sampled pre-analysis. Files whose intervals overlap are re-scanned fully.
+     */
+    constexpr double FAST_PRE_ANALYSIS_ERROR_SIGMAS = 3.0;
+
 } // namespace DynaRange::Setup::Constants
\ No newline at end of file
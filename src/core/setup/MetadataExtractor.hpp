@@ -7,10 +7,14 @@
  */
 #pragma once
 #include "raw/RawFile.hpp"
+#include "raw/RawFileCache.hpp"
+#include <memory>
 #include <string>
 #include <vector>
 #include <ostream>
 
+class PreAnalysisCache;
+
 /**
  * @struct FileInfo
  * @brief Holds extracted metadata for a single RAW file. This struct serves
@@ -20,15 +24,25 @@ struct FileInfo {
     std::string filename;
     double mean_brightness = 0.0;
     float iso_speed = 0.0f;
+    std::string camera_model;  ///< Camera model from the metadata.
+    std::string serial_number; ///< Body serial number, or empty if unknown.
+    int bit_depth = 0;         ///< Bit depth from the metadata, or 0 if unknown.
+    /// Histogram summary from the pre-analysis; later stages read it instead of opening the file.
+    std::shared_ptr<const DynaRange::IO::Raw::RawSummary> summary;
 };
 
 
 /**
- * @brief Extracts metadata and loads RawFile objects in parallel.
+ * @brief Extracts metadata from the input files, decoding each one through the run cache.
+ * @details The decoded RawFile objects remain owned by @p raw_cache, so later
+ * initialization stages (calibration estimation, resolution detection, analysis)
+ * reuse them instead of reloading the files from disk.
  * @param input_files The list of input file paths.
  * @param log_stream Stream for logging messages.
- * @return A pair containing:
- * 1. A vector of FileInfo structs for each successfully processed file.
- * 2. A vector of the fully loaded RawFile objects.
+ * @param raw_cache The run-scoped decode cache that will own the loaded files.
+ * @param persistent_cache Optional on-disk cache of earlier pre-analysis results;
+ *        files found there are not decoded.
+ * @param fast_sampling If true, brightness is estimated from a pixel sample (see PreAnalyzeRawFiles).
+ * @return A vector of FileInfo structs for each successfully processed file.
  */
-std::pair<std::vector<FileInfo>, std::vector<RawFile>> ExtractFileInfo(const std::vector<std::string>& input_files, std::ostream& log_stream);
+std::vector<FileInfo> ExtractFileInfo(const std::vector<std::string>& input_files, std::ostream& log_stream, DynaRange::IO::Raw::RawFileCache& raw_cache, PreAnalysisCache* persistent_cache = nullptr, bool fast_sampling = false);
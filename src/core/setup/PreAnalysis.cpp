@@ -6,53 +6,207 @@
 #include "PreAnalysis.hpp"
 #include "Constants.hpp"
 #include "../io/raw/RawFile.hpp"
-#include <opencv2/imgproc.hpp>
+#include "../io/raw/RawFileCache.hpp"
+#include "../io/raw/RawSummary.hpp"
+#include "PreAnalysisCache.hpp"
+#include "../utils/ThreadPool.hpp"
+#include <algorithm>
+#include <optional>
+#include <sstream>
 #include <libintl.h>
 
 #define _(string) gettext(string)
 
+bool HasSaturatedPixels(const DynaRange::IO::Raw::RawSummary& summary, double saturation_value)
+{
+    // Answered from the histogram, so any candidate saturation level costs O(bins).
+    double saturation_ratio = summary.GetRatioAtOrAbove(saturation_value * DynaRange::Setup::Constants::PRE_ANALYSIS_SATURATION_FACTOR);
+    return saturation_ratio > DynaRange::Setup::Constants::MAX_PRE_ANALYSIS_SATURATION_RATIO;
+}
+
+namespace {
+
+/**
+ * @brief Pre-analyzes a single file by decoding it (the persistent cache is only written).
+ * @param log_stream Receives this file's messages (nullptr to discard them).
+ * @param local_file Holds the file when there is no @p raw_cache. A file already
+ *        opened there (by an earlier sampled pass) is reused instead of reopened.
+ * @return The result, or std::nullopt if the file cannot be analyzed.
+ */
+std::optional<PreAnalysisResult> PreAnalyzeRawFile(
+    const std::string& filename,
+    double saturation_value,
+    std::ostream* log_stream,
+    DynaRange::IO::Raw::RawFileCache* raw_cache,
+    PreAnalysisCache* persistent_cache,
+    bool fast_sampling,
+    std::optional<RawFile>& local_file)
+{
+    const RawFile* raw_file = (!raw_cache && local_file && local_file->IsLoaded())
+        ? &*local_file
+        : DynaRange::IO::Raw::AcquireRawFile(raw_cache, filename, local_file);
+    if (!raw_file) {
+        if (log_stream) {
+            (*log_stream) << _("Warning: Could not pre-load RAW file for metadata extraction: ") << filename << std::endl;
+        }
+        return std::nullopt;
+    }
+    // Reject formats without a CFA mosaic from the headers alone, before decoding any pixels.
+    std::shared_ptr<const DynaRange::IO::Raw::RawSummary> summary;
+    if (raw_file->HasRawMosaicData()) {
+        // Sampling only applies to files read in place; the others are decoded and
+        // get the exact summary, which is persisted below.
+        summary = fast_sampling
+            ? raw_file->GetSampledSummary(DynaRange::Setup::Constants::FAST_PRE_ANALYSIS_BLOCK_STRIDE)
+            : raw_file->GetSummary();
+    }
+    if (!summary || !summary->IsValid()) {
+        if (log_stream) {
+            (*log_stream) << _("[FATAL ERROR] Could not read direct raw sensor data from input file: ") << filename << std::endl;
+            (*log_stream) << _("  This is likely because the file is in a compressed RAW format that is not supported for analysis.") << std::endl;
+        }
+        return std::nullopt;
+    }
+    PreAnalysisResult result;
+    result.filename = filename;
+    result.mean_brightness = summary->GetMean();
+    result.iso_speed = raw_file->GetIsoSpeed();
+    result.has_saturated_pixels = HasSaturatedPixels(*summary, saturation_value);
+    result.saturation_value_used = saturation_value;
+    result.summary = summary;
+    result.is_sampled = summary->IsSampled();
+    result.camera_model = raw_file->GetCameraModel();
+    result.serial_number = raw_file->GetSerialNumber();
+    result.bit_depth = raw_file->GetBitDepth().value_or(0);
+    result.mean_brightness_error = summary->GetMeanStandardError() * DynaRange::Setup::Constants::FAST_PRE_ANALYSIS_ERROR_SIGMAS;
+    if (result.is_sampled) {
+        // Estimates are not cached: only exact summaries may be reused by later runs.
+        if (log_stream) {
+            std::ostringstream interval;
+            interval.setf(std::ios::fixed);
+            interval.precision(2);
+            interval << result.mean_brightness << " +/- " << result.mean_brightness_error;
+            (*log_stream) << _("Pre-analyzed file (sampled, mean ") << interval.str() << "): " << filename << std::endl;
+        }
+        return result;
+    }
+    if (persistent_cache) {
+        persistent_cache->Store(result);
+    }
+
+    if (log_stream) {
+        (*log_stream) << _("Pre-analyzed file: ") << filename << std::endl;
+    }
+    return result;
+}
+
+/**
+ * @brief Finds sampled results whose brightness order is not certain.
+ * @details Results are sorted by estimated brightness; two neighbours are ambiguous
+ * when their intervals overlap. Exact results have a zero-width interval.
+ * @return The indices of the sampled results that need a full scan.
+ */
+std::vector<size_t> FindAmbiguousSamples(const std::vector<std::optional<PreAnalysisResult>>& results)
+{
+    std::vector<size_t> order;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i]) order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return results[a]->mean_brightness < results[b]->mean_brightness;
+    });
+
+    std::vector<bool> is_ambiguous(results.size(), false);
+    for (size_t k = 1; k < order.size(); ++k) {
+        const PreAnalysisResult& lower = *results[order[k - 1]];
+        const PreAnalysisResult& upper = *results[order[k]];
+        if (lower.mean_brightness + lower.mean_brightness_error >= upper.mean_brightness - upper.mean_brightness_error) {
+            is_ambiguous[order[k - 1]] = true;
+            is_ambiguous[order[k]] = true;
+        }
+    }
+
+    std::vector<size_t> to_rescan;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (is_ambiguous[i] && results[i]->is_sampled) to_rescan.push_back(i);
+    }
+    return to_rescan;
+}
+
+} // namespace
+
 std::vector<PreAnalysisResult> PreAnalyzeRawFiles(
     const std::vector<std::string>& input_files,
     double saturation_value,
-    std::ostream* log_stream)
+    std::ostream* log_stream,
+    DynaRange::IO::Raw::RawFileCache* raw_cache,
+    PreAnalysisCache* persistent_cache,
+    bool fast_sampling)
 {
-    std::vector<PreAnalysisResult> results;
-    results.reserve(input_files.size());
-    for (const auto& filename : input_files) {
-        RawFile raw_file(filename);
-        if (!raw_file.Load()) {
-            if (log_stream) {
-                (*log_stream) << _("Warning: Could not pre-load RAW file for metadata extraction: ") << filename << std::endl;
+    // Files are analyzed on the shared pool; results and messages are kept per
+    // index and emitted in input order, so the output does not depend on timing.
+    std::vector<std::optional<PreAnalysisResult>> file_results(input_files.size());
+    std::vector<std::ostringstream> file_logs(input_files.size());
+
+    // Files known to the persistent cache are answered from it without being opened;
+    // a later stage opens them only if it needs their pixels.
+    if (persistent_cache) {
+        DynaRange::Utils::ThreadPool::Shared().ParallelFor(input_files.size(), [&](size_t i) {
+            file_results[i] = persistent_cache->Lookup(input_files[i], saturation_value);
+            if (file_results[i] && log_stream) {
+                file_logs[i] << _("Pre-analyzed file (cached): ") << input_files[i] << std::endl;
             }
-            continue;
+        });
+    }
+    std::vector<size_t> to_decode;
+    for (size_t i = 0; i < input_files.size(); ++i) {
+        if (!file_results[i]) to_decode.push_back(i);
+    }
+    if (raw_cache) {
+        // Only the files that have to be decoded are read ahead.
+        std::vector<std::string> filenames;
+        filenames.reserve(to_decode.size());
+        for (size_t i : to_decode) filenames.push_back(input_files[i]);
+        raw_cache->Prefetch(filenames);
+    }
+    // Without a raw_cache, sampled files (opened but never decoded) stay open until
+    // the re-scan has decided; decoded files are closed at once.
+    std::vector<std::optional<RawFile>> local_files(input_files.size());
+    DynaRange::Utils::ThreadPool::Shared().ParallelFor(to_decode.size(), [&](size_t k) {
+        const size_t i = to_decode[k];
+        file_results[i] = PreAnalyzeRawFile(input_files[i], saturation_value, log_stream ? &file_logs[i] : nullptr, raw_cache, persistent_cache, fast_sampling, local_files[i]);
+        if (!file_results[i] || !file_results[i]->is_sampled) local_files[i].reset();
+    });
+
+    if (fast_sampling) {
+        std::vector<size_t> to_rescan = FindAmbiguousSamples(file_results);
+        std::vector<bool> is_rescanned(input_files.size(), false);
+        for (size_t i : to_rescan) is_rescanned[i] = true;
+        for (size_t i = 0; i < input_files.size(); ++i) {
+            if (!is_rescanned[i]) local_files[i].reset();
         }
-        cv::Mat active_img = raw_file.GetActiveRawImage();
-        if (active_img.empty()) {
-            if (log_stream) {
-                (*log_stream) << _("[FATAL ERROR] Could not read direct raw sensor data from input file: ") << filename << std::endl;
-                (*log_stream) << _("  This is likely because the file is in a compressed RAW format that is not supported for analysis.") << std::endl;
-            }
-            continue;
-        }
-        double mean_brightness = cv::mean(active_img)[0];
-        
-        // Se calcula el ratio de píxeles saturados.
-        int saturated_pixels = cv::countNonZero(active_img >= (saturation_value * 0.99));
-        double total_pixels = active_img.total();
-        double saturation_ratio = (total_pixels > 0) ? static_cast<double>(saturated_pixels) / total_pixels : 0.0;
-        
-        PreAnalysisResult result;
-        result.filename = filename;
-        result.mean_brightness = mean_brightness;
-        result.iso_speed = raw_file.GetIsoSpeed();
-        // Se utiliza la nueva constante para determinar si el fichero está saturado.
-        result.has_saturated_pixels = (saturation_ratio > DynaRange::Setup::Constants::MAX_PRE_ANALYSIS_SATURATION_RATIO);
-
-        result.saturation_value_used = saturation_value;
-        results.push_back(result);
+        if (!to_rescan.empty() && log_stream) {
+            (*log_stream) << _("Brightness intervals overlap; re-scanning files fully: ") << to_rescan.size() << std::endl;
+        }
+        DynaRange::Utils::ThreadPool::Shared().ParallelFor(to_rescan.size(), [&](size_t k) {
+            const size_t i = to_rescan[k];
+            file_results[i] = PreAnalyzeRawFile(input_files[i], saturation_value, log_stream ? &file_logs[i] : nullptr, raw_cache, persistent_cache, false, local_files[i]);
+            local_files[i].reset();
+        });
+    }
 
+    if (persistent_cache) {
+        persistent_cache->EnforceSizeLimit();
+    }
+
+    std::vector<PreAnalysisResult> results;
+    results.reserve(input_files.size());
+    for (size_t i = 0; i < input_files.size(); ++i) {
         if (log_stream) {
-            (*log_stream) << _("Pre-analyzed file: ") << filename << std::endl;
+            (*log_stream) << file_logs[i].str();
+        }
+        if (file_results[i]) {
+            results.push_back(std::move(*file_results[i]));
         }
     }
     return results;
@@ -7,8 +7,17 @@
  * It is designed to be used by both the CLI and the GUI.
  */
 #pragma once
+#include <memory>
 #include <string>
 #include <vector>
+#include <ostream>
+
+namespace DynaRange::IO::Raw {
+    class RawFileCache;
+    class RawSummary;
+}
+class PreAnalysisCache;
+
 /**
  * @struct PreAnalysisResult
  * @brief Holds the extracted metadata for a single RAW file after pre-analysis.
@@ -19,19 +28,55 @@ struct PreAnalysisResult {
     float iso_speed = 0.0f;
     bool has_saturated_pixels = false;
     double saturation_value_used = 0.0; ///< The saturation value used for the saturated pixel check.
+    /// Histogram summary of the file; lets the saturation check be redone for another level without I/O.
+    std::shared_ptr<const DynaRange::IO::Raw::RawSummary> summary;
+    /// Half-width of the brightness interval (0 for an exact value); set when the file was sampled.
+    double mean_brightness_error = 0.0;
+    bool is_sampled = false; ///< True if the statistics come from a strided subset of the pixels.
+    std::string camera_model;  ///< Camera model from the metadata.
+    std::string serial_number; ///< Body serial number, or empty if unknown.
+    int bit_depth = 0;         ///< Bit depth from the metadata, or 0 if unknown.
 };
+
+/**
+ * @brief Checks from a file's histogram summary whether it has too many saturated pixels.
+ * @details This is the predicate the pre-analysis has always stored in
+ * PreAnalysisResult::has_saturated_pixels (CLI and GUI alike): a few clipped
+ * pixels (hot pixels, specular highlights) do not disqualify a file as the
+ * preview/corner-detection source, only a ratio above
+ * MAX_PRE_ANALYSIS_SATURATION_RATIO does.
+ * @param summary The histogram summary of the file.
+ * @param saturation_value The sensor's saturation level.
+ * @return true if the ratio of pixels near saturation exceeds the pre-analysis limit.
+ */
+bool HasSaturatedPixels(const DynaRange::IO::Raw::RawSummary& summary, double saturation_value);
 /**
  * @brief Pre-analyzes a list of RAW files to extract essential metadata.
- * @details This function loads each file, extracts its active area, and calculates
- * the mean brightness and a flag for saturated pixels. It is designed to be efficient
+ * @details This function opens each file, rejects formats without raw CFA data from
+ * their headers alone, then takes the mean brightness and a flag for saturated
+ * pixels from the file's histogram summary (built once when it is decoded). It is designed to be efficient
  * and safe for use in both CLI and GUI contexts.
  * @param input_files The list of input file paths to analyze.
  * @param saturation_value The sensor's saturation level used to check for saturated pixels.
  * @param log_stream An optional output stream for logging messages. If nullptr, no logging occurs.
+ * @param raw_cache An optional run-scoped decode cache. When provided, files are borrowed
+ *        from it (and stay decoded for later stages) instead of being loaded and discarded.
+ * @param persistent_cache An optional on-disk cache consulted before decoding a file and
+ *        updated afterwards. On a hit the file is not opened at all (nor added to
+ *        @p raw_cache); its size limit is enforced before returning.
+ * @param fast_sampling If true, files whose backend reads pixels in place are
+ *        estimated from a strided subset of the pixels, with an error bound, without
+ *        being decoded. Files whose intervals overlap (so their order is uncertain)
+ *        are re-scanned fully. Files that must be decoded (e.g. through LibRaw) get
+ *        the exact summary, which the decode yields at no extra cost, and it is
+ *        stored in @p persistent_cache.
  * @return A vector of PreAnalysisResult structs for successfully processed files.
  *         If a file fails to load or process, it is simply omitted from the result.
  */
 std::vector<PreAnalysisResult> PreAnalyzeRawFiles(
     const std::vector<std::string>& input_files,
     double saturation_value,
-    std::ostream* log_stream = nullptr);
\ No newline at end of file
+    std::ostream* log_stream = nullptr,
+    DynaRange::IO::Raw::RawFileCache* raw_cache = nullptr,
+    PreAnalysisCache* persistent_cache = nullptr,
+    bool fast_sampling = false);
\ No newline at end of file
@@ -0,0 +1,228 @@
+// File: src/core/setup/PreAnalysisCache.cpp
+/**
+ * @file src/core/setup/PreAnalysisCache.cpp
+ * @brief Implements the persistent on-disk pre-analysis cache.
+ */
+#include "PreAnalysisCache.hpp"
+#include "Constants.hpp"
+#include "../io/raw/RawSummary.hpp"
+#include "../utils/CacheFileUtils.hpp"
+#include "../utils/PlatformUtils.hpp"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <locale>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+using CacheFileUtils::HashBytes;
+using CacheFileUtils::ToHex;
+
+namespace {
+    constexpr const char* CACHE_FILE_MAGIC = "DynaRangePreAnalysisCache";
+}
+
+PreAnalysisCache::PreAnalysisCache(fs::path directory) : m_directory(std::move(directory)) {}
+
+fs::path PreAnalysisCache::GetDefaultDirectory() {
+    fs::path base = PlatformUtils::GetUserCacheDirectory();
+    return base.empty() ? base : base / "preanalysis";
+}
+
+bool PreAnalysisCache::IsEnabled() const {
+    return !m_directory.empty();
+}
+
+std::optional<PreAnalysisCache::FileIdentity> PreAnalysisCache::Identify(const std::string& filename) {
+    std::error_code ec;
+    FileIdentity identity;
+    identity.path = fs::absolute(filename, ec).lexically_normal().string();
+    if (ec) return std::nullopt;
+    identity.size = fs::file_size(filename, ec);
+    if (ec) return std::nullopt;
+    auto mtime = fs::last_write_time(filename, ec);
+    if (ec) return std::nullopt;
+    identity.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+
+    // Hash the head and the tail: cheap, yet catches files rewritten in place.
+    std::ifstream stream(filename, std::ios::binary);
+    if (!stream) return std::nullopt;
+    const size_t chunk = static_cast<size_t>(std::min<uintmax_t>(identity.size, DynaRange::Setup::Constants::PRE_ANALYSIS_CACHE_HASH_BYTES));
+    std::vector<char> buffer(chunk);
+    uint64_t hash = CacheFileUtils::FNV_OFFSET_BASIS;
+    if (!stream.read(buffer.data(), static_cast<std::streamsize>(chunk))) return std::nullopt;
+    hash = HashBytes(buffer.data(), chunk, hash);
+    if (identity.size > chunk) {
+        stream.seekg(static_cast<std::streamoff>(identity.size - chunk), std::ios::beg);
+        if (!stream.read(buffer.data(), static_cast<std::streamsize>(chunk))) return std::nullopt;
+        hash = HashBytes(buffer.data(), chunk, hash);
+    }
+    identity.content_hash = hash;
+    return identity;
+}
+
+fs::path PreAnalysisCache::GetEntryPath(const FileIdentity& identity) const {
+    uint64_t key = HashBytes(identity.path.data(), identity.path.size());
+    return m_directory / (ToHex(key) + ".txt");
+}
+
+std::optional<PreAnalysisResult> PreAnalysisCache::Lookup(const std::string& filename, double saturation_value) {
+    if (!IsEnabled()) return std::nullopt;
+    auto miss = [this]() -> std::optional<PreAnalysisResult> {
+        m_misses++;
+        return std::nullopt;
+    };
+
+    std::optional<FileIdentity> identity = Identify(filename);
+    if (!identity) return miss();
+    const fs::path entry_path = GetEntryPath(*identity);
+    std::ifstream stream(entry_path);
+    if (!stream) return miss();
+    stream.imbue(std::locale::classic());
+    // Stale, outdated or damaged entries are deleted so they do not accumulate.
+    auto drop = [&]() -> std::optional<PreAnalysisResult> {
+        stream.close();
+        std::error_code ec;
+        fs::remove(entry_path, ec);
+        return miss();
+    };
+
+    std::string magic, key, path;
+    int version = 0;
+    FileIdentity stored;
+    float iso_speed = 0.0f;
+    std::array<uint64_t, 4> channel_sums{};
+    std::array<uint64_t, 4> channel_counts{};
+    size_t bin_count = 0;
+    if (!(stream >> magic >> version) || magic != CACHE_FILE_MAGIC || version != DynaRange::Setup::Constants::PRE_ANALYSIS_CACHE_VERSION) return drop();
+    if (!(stream >> key) || key != "path" || !std::getline(stream >> std::ws, stored.path)) return drop();
+    if (!(stream >> key >> stored.size) || key != "size") return drop();
+    if (!(stream >> key >> stored.mtime) || key != "mtime") return drop();
+    if (!(stream >> key >> std::hex >> stored.content_hash >> std::dec) || key != "content_hash") return drop();
+    if (stored.path != identity->path || stored.size != identity->size ||
+        stored.mtime != identity->mtime || stored.content_hash != identity->content_hash) {
+        return drop(); // Stale entry: the file changed since it was cached.
+    }
+    if (!(stream >> key >> iso_speed) || key != "iso_speed") return drop();
+    std::string camera_model, serial_number;
+    int bit_depth = 0;
+    if (!(stream >> key) || key != "camera_model" || !std::getline(stream, camera_model)) return drop();
+    if (!(stream >> key) || key != "serial_number" || !std::getline(stream, serial_number)) return drop();
+    if (!(stream >> key >> bit_depth) || key != "bit_depth") return drop();
+    if (!(stream >> key) || key != "channel_sums") return drop();
+    for (auto& value : channel_sums) stream >> value;
+    if (!(stream >> key) || key != "channel_counts") return drop();
+    for (auto& value : channel_counts) stream >> value;
+    if (!(stream >> key >> bin_count) || key != "histogram") return drop();
+
+    // The histogram is stored sparsely as "value count" pairs.
+    std::vector<uint32_t> histogram;
+    for (size_t i = 0; i < bin_count; ++i) {
+        size_t value = 0;
+        uint32_t count = 0;
+        if (!(stream >> value >> count) || value >= 65536) return drop();
+        if (histogram.size() <= value) histogram.resize(value + 1, 0);
+        histogram[value] = count;
+    }
+
+    auto summary = std::make_shared<const DynaRange::IO::Raw::RawSummary>(
+        DynaRange::IO::Raw::RawSummary::FromParts(std::move(histogram), channel_sums, channel_counts));
+    if (!summary->IsValid()) return drop();
+
+    PreAnalysisResult result;
+    result.filename = filename;
+    result.mean_brightness = summary->GetMean();
+    result.iso_speed = iso_speed;
+    result.has_saturated_pixels = HasSaturatedPixels(*summary, saturation_value);
+    result.saturation_value_used = saturation_value;
+    result.summary = summary;
+    // Values are written after a single separator space; they may be empty or contain spaces.
+    result.camera_model = camera_model.empty() ? camera_model : camera_model.substr(1);
+    result.serial_number = serial_number.empty() ? serial_number : serial_number.substr(1);
+    result.bit_depth = bit_depth;
+    stream.close();
+    // The modification time of an entry records its last use, for EnforceSizeLimit().
+    std::error_code ec;
+    fs::last_write_time(entry_path, fs::file_time_type::clock::now(), ec);
+    m_hits++;
+    return result;
+}
+
+void PreAnalysisCache::Store(const PreAnalysisResult& result) {
+    if (!IsEnabled() || !result.summary || !result.summary->IsValid()) return;
+    std::optional<FileIdentity> identity = Identify(result.filename);
+    if (!identity) return;
+
+    std::error_code ec;
+    fs::create_directories(m_directory, ec);
+    if (ec) return;
+
+    const bool written = CacheFileUtils::WriteFileAtomically(GetEntryPath(*identity), [&](std::ostream& stream) {
+        const auto& summary = *result.summary;
+        stream << CACHE_FILE_MAGIC << " " << DynaRange::Setup::Constants::PRE_ANALYSIS_CACHE_VERSION << "\n";
+        stream << "path " << identity->path << "\n";
+        stream << "size " << identity->size << "\n";
+        stream << "mtime " << identity->mtime << "\n";
+        stream << "content_hash " << ToHex(identity->content_hash) << "\n";
+        stream << "iso_speed " << std::setprecision(9) << result.iso_speed << "\n";
+        stream << "camera_model " << result.camera_model << "\n";
+        stream << "serial_number " << result.serial_number << "\n";
+        stream << "bit_depth " << result.bit_depth << "\n";
+        stream << "channel_sums";
+        for (int i = 0; i < 4; ++i) stream << " " << summary.GetChannelSum(i);
+        stream << "\nchannel_counts";
+        for (int i = 0; i < 4; ++i) stream << " " << summary.GetChannelCount(i);
+        const auto& histogram = summary.GetHistogram();
+        size_t non_empty_bins = 0;
+        for (uint32_t count : histogram) non_empty_bins += (count != 0);
+        stream << "\nhistogram " << non_empty_bins << "\n";
+        for (size_t value = 0; value < histogram.size(); ++value) {
+            if (histogram[value] != 0) {
+                stream << value << " " << histogram[value] << "\n";
+            }
+        }
+    });
+    if (written) {
+        m_stores++;
+    }
+}
+
+void PreAnalysisCache::EnforceSizeLimit() {
+    if (!IsEnabled() || m_stores == 0) return;
+
+    struct EntryFile {
+        fs::path path;
+        uintmax_t size;
+        fs::file_time_type last_use;
+    };
+    std::vector<EntryFile> entries;
+    uintmax_t total_size = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it(m_directory, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code entry_ec;
+        if (it->path().extension() != ".txt" || !it->is_regular_file(entry_ec)) continue;
+        const uintmax_t size = it->file_size(entry_ec);
+        const fs::file_time_type last_use = it->last_write_time(entry_ec);
+        if (entry_ec) continue;
+        entries.push_back({it->path(), size, last_use});
+        total_size += size;
+    }
+    const uintmax_t max_size = DynaRange::Setup::Constants::PRE_ANALYSIS_CACHE_MAX_BYTES;
+    if (total_size <= max_size) return;
+
+    // Least recently used entries go first, down to 90% of the limit so the
+    // directory is not scanned again on every run.
+    std::sort(entries.begin(), entries.end(), [](const EntryFile& a, const EntryFile& b) {
+        return a.last_use < b.last_use;
+    });
+    const uintmax_t target_size = max_size / 10 * 9;
+    for (const auto& entry : entries) {
+        if (total_size <= target_size) break;
+        if (fs::remove(entry.path, ec)) {
+            total_size -= entry.size;
+        }
+    }
+}
@@ -0,0 +1,95 @@
+// File: src/core/setup/PreAnalysisCache.hpp
+/**
+ * @file src/core/setup/PreAnalysisCache.hpp
+ * @brief Declares a persistent on-disk cache of pre-analysis results.
+ * @details Re-running the analysis over the same archive of RAW files with
+ * different settings used to decode every file again just to get its brightness,
+ * ISO and saturation information. This cache stores, per file, the ISO and the
+ * histogram summary (from which the mean brightness and any saturation check are
+ * derived), keyed by the file's identity, so a warm run skips that decode.
+ */
+#pragma once
+
+#include "PreAnalysis.hpp"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+/**
+ * @class PreAnalysisCache
+ * @brief Stores and retrieves pre-analysis results in a cache directory.
+ * @details Each file gets its own entry, keyed by its absolute path, size,
+ * modification time and a fast hash of its first and last bytes. Entries are
+ * written with CacheFileUtils::WriteFileAtomically(), so the cache can be shared
+ * by concurrent threads and processes. All methods are thread-safe.
+ * Entries that no longer match their file are deleted when looked up, and the
+ * directory is kept under a size limit by evicting the least recently used ones.
+ */
+class PreAnalysisCache {
+public:
+    /**
+     * @brief Constructs a cache rooted at the given directory.
+     * @param directory The cache directory; an empty path disables the cache.
+     */
+    explicit PreAnalysisCache(std::filesystem::path directory = GetDefaultDirectory());
+
+    /**
+     * @brief Gets the default cache directory (inside the user cache directory).
+     */
+    static std::filesystem::path GetDefaultDirectory();
+
+    /** @brief Checks whether the cache has a usable directory. */
+    bool IsEnabled() const;
+
+    /**
+     * @brief Looks up the pre-analysis result of a file.
+     * @param filename The path to the RAW file.
+     * @param saturation_value The saturation level for the saturated-pixel flag,
+     *        which is re-evaluated from the stored histogram.
+     * @return The result if a valid entry exists for the file as it is on disk now.
+     */
+    std::optional<PreAnalysisResult> Lookup(const std::string& filename, double saturation_value);
+
+    /**
+     * @brief Stores the pre-analysis result of a file.
+     * @details Results without a histogram summary are ignored, and so are I/O
+     * errors (see CacheFileUtils.hpp).
+     * @param result The result to store.
+     */
+    void Store(const PreAnalysisResult& result);
+
+    /**
+     * @brief Deletes the least recently used entries once the cache exceeds its size limit.
+     * @details Does nothing if no entry was stored through this object. A lookup hit
+     * counts as a use. See Constants::PRE_ANALYSIS_CACHE_MAX_BYTES.
+     */
+    void EnforceSizeLimit();
+
+    /** @brief Gets the number of successful lookups. */
+    size_t GetHitCount() const { return m_hits; }
+
+    /** @brief Gets the number of failed lookups. */
+    size_t GetMissCount() const { return m_misses; }
+
+private:
+    /**
+     * @struct FileIdentity
+     * @brief What must be unchanged for a cached entry to still describe a file.
+     */
+    struct FileIdentity {
+        std::string path;
+        uintmax_t size = 0;
+        int64_t mtime = 0;
+        uint64_t content_hash = 0;
+    };
+
+    static std::optional<FileIdentity> Identify(const std::string& filename);
+    std::filesystem::path GetEntryPath(const FileIdentity& identity) const;
+
+    std::filesystem::path m_directory;
+    std::atomic<size_t> m_hits{0};
+    std::atomic<size_t> m_misses{0};
+    std::atomic<size_t> m_stores{0};
+};
@@ -6,7 +6,7 @@
 #include "PreAnalysisManager.hpp"
 
 bool PreAnalysisManager::AddFile(const std::string& filepath, double saturation_value) {
-    auto results = PreAnalyzeRawFiles({filepath}, saturation_value, nullptr);
+    auto results = PreAnalyzeRawFiles({filepath}, saturation_value, nullptr, nullptr, &m_persistent_cache);
     if (results.empty()) {
         return false;
     }
@@ -14,6 +14,19 @@ bool PreAnalysisManager::AddFile(const std::string& filepath, double saturation_
     return true;
 }
 
+void PreAnalysisManager::AddResult(const PreAnalysisResult& result) {
+    m_cache.push_back(result);
+}
+
+void PreAnalysisManager::UpdateSaturationValue(double saturation_value) {
+    for (auto& entry : m_cache) {
+        if (entry.summary && entry.saturation_value_used != saturation_value) {
+            entry.has_saturated_pixels = HasSaturatedPixels(*entry.summary, saturation_value);
+            entry.saturation_value_used = saturation_value;
+        }
+    }
+}
+
 void PreAnalysisManager::RemoveFile(const std::string& filepath) {
     m_cache.erase(
         std::remove_if(m_cache.begin(), m_cache.end(),
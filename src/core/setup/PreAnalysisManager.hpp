@@ -8,6 +8,7 @@
  */
 #pragma once
 #include "PreAnalysis.hpp"
+#include "PreAnalysisCache.hpp"
 #include <string>
 #include <vector>
 #include <optional>
@@ -21,12 +22,26 @@ class PreAnalysisManager {
 public:
     /**
      * @brief Adds a new file to the cache by analyzing it.
+     * @details The on-disk pre-analysis cache is consulted first.
      * @param filepath The path to the RAW file.
      * @param saturation_value The sensor's saturation level.
      * @return true if the file was successfully analyzed and added, false otherwise.
      */
     bool AddFile(const std::string& filepath, double saturation_value);
 
+    /**
+     * @brief Adds an already computed pre-analysis result to the cache.
+     * @param result The result of PreAnalyzeRawFiles() for one file.
+     */
+    void AddResult(const PreAnalysisResult& result);
+
+    /**
+     * @brief Re-evaluates the saturated-pixel flag of every cached file for a new level.
+     * @details Uses the stored histogram summaries, so no file is read again.
+     * @param saturation_value The new saturation level.
+     */
+    void UpdateSaturationValue(double saturation_value);
+
     /**
      * @brief Removes a file from the cache.
      * @param filepath The path to the RAW file to remove.
@@ -52,4 +67,5 @@ public:
 
 private:
     std::vector<PreAnalysisResult> m_cache;
+    PreAnalysisCache m_persistent_cache; ///< On-disk results of earlier sessions.
 };
\ No newline at end of file
@@ -5,20 +5,23 @@
  */
 #include "SensorResolution.hpp"
 #include "../io/raw/RawFile.hpp"
+#include "../io/raw/RawFileCache.hpp"
+#include <optional>
 #include <iomanip>
 #include <libintl.h>
 
 #define _(string) gettext(string)
 
-double DetectSensorResolution(const std::vector<std::string>& input_files, std::ostream& log_stream) {
+double DetectSensorResolution(const std::vector<std::string>& input_files, std::ostream& log_stream, DynaRange::IO::Raw::RawFileCache* raw_cache) {
     for (const std::string& name : input_files) {
-        RawFile raw_file(name);
-        if (!raw_file.Load()) {
+        std::optional<RawFile> local_file;
+        const RawFile* raw_file = DynaRange::IO::Raw::AcquireRawFile(raw_cache, name, local_file);
+        if (!raw_file) {
             continue;
         }
 
         // Attempt to get resolution from specific metadata first
-        double sensor_res_from_metadata = raw_file.GetSensorResolutionMPx();
+        double sensor_res_from_metadata = raw_file->GetSensorResolutionMPx();
         if (sensor_res_from_metadata > 0.0) {
             log_stream << _("Sensor resolution detected from RAW metadata: ")
                        << std::fixed << std::setprecision(1) << sensor_res_from_metadata << _(" Mpx") << std::endl;
@@ -26,8 +29,8 @@ double DetectSensorResolution(const std::vector<std::string>& input_files, std::
         }
         
         // Fallback to image dimensions if metadata tag is missing
-        int width = raw_file.GetWidth();
-        int height = raw_file.GetHeight();
+        int width = raw_file->GetWidth();
+        int height = raw_file->GetHeight();
         if (width > 0 && height > 0) {
             double sensor_res_from_dims = static_cast<double>(width * height) / 1000000.0;
             if (sensor_res_from_dims > 0.1) { // Avoid absurdly small values
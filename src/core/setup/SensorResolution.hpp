@@ -10,12 +10,17 @@
 #include <vector>
 #include <ostream>
 
+namespace DynaRange::IO::Raw {
+    class RawFileCache;
+}
+
 /**
  * @brief Detects sensor resolution from RAW metadata.
  * @details Iterates through files to find a valid resolution, first from specific
  * metadata tags, falling back to image dimensions as a secondary source.
  * @param input_files The list of input file paths.
  * @param log_stream Stream for logging messages.
+ * @param raw_cache Optional run-scoped decode cache to borrow already loaded files from.
  * @return The detected sensor resolution in megapixels, or 0.0 if not found.
  */
-double DetectSensorResolution(const std::vector<std::string>& input_files, std::ostream& log_stream);
\ No newline at end of file
+double DetectSensorResolution(const std::vector<std::string>& input_files, std::ostream& log_stream, DynaRange::IO::Raw::RawFileCache* raw_cache = nullptr);
\ No newline at end of file
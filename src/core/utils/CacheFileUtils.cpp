@@ -0,0 +1,82 @@
+// File: src/core/utils/CacheFileUtils.cpp
+/**
+ * @file src/core/utils/CacheFileUtils.cpp
+ * @brief Implements the helpers shared by the on-disk caches.
+ */
+#include "CacheFileUtils.hpp"
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <locale>
+#include <sstream>
+#include <system_error>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace CacheFileUtils {
+
+namespace {
+    constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+    long GetProcessId() {
+#ifdef _WIN32
+        return static_cast<long>(_getpid());
+#else
+        return static_cast<long>(getpid());
+#endif
+    }
+}
+
+uint64_t HashBytes(const char* data, size_t size, uint64_t hash) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+uint64_t HashString(const std::string& text, uint64_t hash) {
+    return HashBytes(text.data(), text.size(), hash);
+}
+
+std::string ToHex(uint64_t value) {
+    std::ostringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << value;
+    return ss.str();
+}
+
+bool WriteFileAtomically(const fs::path& path, const std::function<void(std::ostream&)>& write) {
+    static std::atomic<uint64_t> temp_counter{0};
+    fs::path temp_path = path;
+    temp_path += ".tmp" + std::to_string(GetProcessId()) + "-" +
+                 ToHex(std::hash<std::thread::id>{}(std::this_thread::get_id())) + "-" +
+                 std::to_string(temp_counter++);
+
+    std::error_code ec;
+    {
+        std::ofstream stream(temp_path, std::ios::trunc);
+        if (!stream) return false;
+        stream.imbue(std::locale::classic());
+        write(stream);
+        if (!stream) {
+            stream.close();
+            fs::remove(temp_path, ec);
+            return false;
+        }
+    }
+    fs::rename(temp_path, path, ec);
+    if (ec) {
+        fs::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace CacheFileUtils
@@ -0,0 +1,47 @@
+// File: src/core/utils/CacheFileUtils.hpp
+/**
+ * @file src/core/utils/CacheFileUtils.hpp
+ * @brief Declares helpers shared by the on-disk caches (pre-analysis, calibration profiles).
+ * @details The caches are only accelerators: a failed read or write is never an error,
+ * the data is simply computed again. Entries are written to a temporary file and renamed
+ * into place, so concurrent threads and processes never see a partial entry.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace CacheFileUtils {
+
+/// Offset basis of the 64-bit FNV-1a hash.
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+
+/**
+ * @brief Continues a 64-bit FNV-1a hash over a block of bytes.
+ * @param hash The hash so far, FNV_OFFSET_BASIS for a new one.
+ */
+uint64_t HashBytes(const char* data, size_t size, uint64_t hash = FNV_OFFSET_BASIS);
+
+/// @brief Continues a 64-bit FNV-1a hash over a string.
+uint64_t HashString(const std::string& text, uint64_t hash = FNV_OFFSET_BASIS);
+
+/// @brief Formats a 64-bit value as 16 lowercase hexadecimal digits.
+std::string ToHex(uint64_t value);
+
+/**
+ * @brief Writes a cache entry atomically.
+ * @details The content goes to a temporary file next to @p path, named after the process,
+ * the thread and a per-process counter, which is then renamed over @p path. The stream is
+ * imbued with the classic locale. On any failure the temporary file is removed and
+ * @p path is left as it was.
+ * @param path The entry to write.
+ * @param write Writes the content; a failed stream state counts as a failure.
+ * @return true if the entry was replaced.
+ */
+bool WriteFileAtomically(const std::filesystem::path& path, const std::function<void(std::ostream&)>& write);
+
+} // namespace CacheFileUtils
@@ -54,26 +54,30 @@ std::string GenerateCommand(CommandFormat format)
         add_arg(FullDebug); // Añade --debug o -D
     }
 
-    std::string black_file = mgr.Get<std::string>(BlackFile);
-    if (!black_file.empty()) {
+    const auto black_files = mgr.Get<std::vector<std::string>>(BlackFile);
+    if (!black_files.empty()) {
         add_arg(BlackFile);
-        if (format == CommandFormat::GuiPreview || format == CommandFormat::Full) {
-            command_ss << " \"" << black_file << "\"";
-        } else {
-            command_ss << " \"" << fs::path(black_file).filename().string() << "\"";
+        for (const auto& black_file : black_files) {
+            if (format == CommandFormat::GuiPreview || format == CommandFormat::Full) {
+                command_ss << " \"" << black_file << "\"";
+            } else {
+                command_ss << " \"" << fs::path(black_file).filename().string() << "\"";
+            }
         }
     } else if (!mgr.Get<bool>(BlackLevelIsDefault)) { // Add -B only if not default
         add_arg(BlackLevel);
         command_ss << " " << std::fixed << std::setprecision(2) << mgr.Get<double>(BlackLevel);
     }
 
-    std::string sat_file = mgr.Get<std::string>(SaturationFile);
-    if (!sat_file.empty()) {
+    const auto sat_files = mgr.Get<std::vector<std::string>>(SaturationFile);
+    if (!sat_files.empty()) {
         add_arg(SaturationFile);
-        if (format == CommandFormat::GuiPreview || format == CommandFormat::Full) {
-            command_ss << " \"" << sat_file << "\"";
-        } else {
-            command_ss << " \"" << fs::path(sat_file).filename().string() << "\"";
+        for (const auto& sat_file : sat_files) {
+            if (format == CommandFormat::GuiPreview || format == CommandFormat::Full) {
+                command_ss << " \"" << sat_file << "\"";
+            } else {
+                command_ss << " \"" << fs::path(sat_file).filename().string() << "\"";
+            }
         }
     } else if (!mgr.Get<bool>(SaturationLevelIsDefault)) { // Add -S only if not default
         add_arg(SaturationLevel);
@@ -4,13 +4,14 @@
  * @brief Implements platform-specific utility functions.
  */
 #include "PlatformUtils.hpp"
+#include <cstdlib>
 
 #ifdef _WIN32
 #include <windows.h>
-#include <filesystem>
-namespace fs = std::filesystem;
 #endif
 
+namespace fs = std::filesystem;
+
 namespace PlatformUtils {
 
 // The implementation is compiled conditionally. On non-Windows platforms,
@@ -49,4 +50,23 @@ std::vector<std::string> ExpandWildcards(const std::vector<std::string>& files)
 #endif
 }
 
+fs::path GetUserCacheDirectory() {
+#ifdef _WIN32
+    const char* local_app_data = std::getenv("LOCALAPPDATA");
+    if (local_app_data != nullptr && *local_app_data != '\0') {
+        return fs::path(local_app_data) / "dynaRange" / "cache";
+    }
+#else
+    const char* xdg_cache = std::getenv("XDG_CACHE_HOME");
+    if (xdg_cache != nullptr && *xdg_cache != '\0') {
+        return fs::path(xdg_cache) / "dynaRange";
+    }
+    const char* home_dir = std::getenv("HOME");
+    if (home_dir != nullptr && *home_dir != '\0') {
+        return fs::path(home_dir) / ".cache" / "dynaRange";
+    }
+#endif
+    return {};
+}
+
 } // namespace PlatformUtils
\ No newline at end of file
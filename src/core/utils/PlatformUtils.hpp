@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <filesystem>
 #include <string>
 #include <vector>
 
@@ -21,4 +22,13 @@ namespace PlatformUtils {
  */
 std::vector<std::string> ExpandWildcards(const std::vector<std::string>& files);
 
+/**
+ * @brief Gets the per-user directory for application cache data.
+ * @details Uses %LOCALAPPDATA% on Windows and $XDG_CACHE_HOME (falling back to
+ * ~/.cache) elsewhere. The directory is not created.
+ * @return The path to the "dynaRange" folder inside the user cache directory,
+ *         or an empty path if no suitable location could be determined.
+ */
+std::filesystem::path GetUserCacheDirectory();
+
 } // namespace PlatformUtils
\ No newline at end of file
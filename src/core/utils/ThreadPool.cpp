@@ -0,0 +1,122 @@
+// File: src/core/utils/ThreadPool.cpp
+/**
+ * @file src/core/utils/ThreadPool.cpp
+ * @brief Implements the shared worker pool.
+ */
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace DynaRange::Utils {
+
+namespace {
+    /**
+     * @brief State of one ParallelFor call, shared with the helper tasks.
+     * @details Held by shared_ptr because helper tasks may still be queued (and
+     * later run and find no work) after the loop has returned.
+     */
+    struct LoopState {
+        LoopState(size_t count, const std::function<void(size_t)>& body) : count(count), body(body) {}
+        const size_t count;
+        const std::function<void(size_t)>& body; // Valid while any index is unfinished.
+        std::atomic<size_t> next_index{0};
+        std::atomic<bool> failed{false};
+        size_t finished = 0;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable done_cv;
+    };
+
+    void RunLoopIterations(const std::shared_ptr<LoopState>& state) {
+        size_t completed = 0;
+        for (size_t i = state->next_index.fetch_add(1); i < state->count; i = state->next_index.fetch_add(1)) {
+            if (!state->failed) {
+                try {
+                    state->body(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (!state->error) state->error = std::current_exception();
+                    state->failed = true;
+                }
+            }
+            completed++;
+        }
+        if (completed == 0) return;
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->finished += completed;
+        if (state->finished == state->count) {
+            state->done_cv.notify_all();
+        }
+    }
+}
+
+ThreadPool::ThreadPool(size_t num_threads) {
+    if (num_threads == 0) {
+        unsigned int hardware_threads = std::thread::hardware_concurrency();
+        num_threads = hardware_threads > 1 ? hardware_threads - 1 : 0;
+    }
+    m_workers.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::Shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::WorkerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+            if (m_stop && m_tasks.empty()) return;
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0) return;
+    if (count == 1 || m_workers.empty()) {
+        for (size_t i = 0; i < count; ++i) body(i);
+        return;
+    }
+
+    auto state = std::make_shared<LoopState>(count, body);
+    const size_t helpers = std::min(count - 1, m_workers.size());
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < helpers; ++i) {
+            m_tasks.emplace_back([state]() { RunLoopIterations(state); });
+        }
+    }
+    m_cv.notify_all();
+
+    // The caller works too, then waits only for indices already claimed by helpers.
+    RunLoopIterations(state);
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done_cv.wait(lock, [&state]() { return state->finished == state->count; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+} // namespace DynaRange::Utils
@@ -0,0 +1,72 @@
+// File: src/core/utils/ThreadPool.hpp
+/**
+ * @file src/core/utils/ThreadPool.hpp
+ * @brief Declares a fixed-size worker pool with a caller-participating parallel loop.
+ * @details Replaces ad-hoc std::async fan-outs with a single set of long-lived
+ * threads shared by all stages of a run, so that concurrent stages do not
+ * oversubscribe the machine.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DynaRange::Utils {
+
+/**
+ * @class ThreadPool
+ * @brief A pool of worker threads executing ParallelFor loops.
+ * @details The calling thread always takes part in its own loop, so a
+ * ParallelFor issued from inside a pool task (nested parallelism) makes progress
+ * even when every worker is busy and can never deadlock.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Starts the pool.
+     * @param num_threads Number of worker threads; 0 uses hardware_concurrency() - 1,
+     *        since the calling thread also works.
+     */
+    explicit ThreadPool(size_t num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Gets the process-wide pool shared by the analysis stages.
+     */
+    static ThreadPool& Shared();
+
+    /**
+     * @brief Runs body(i) for every i in [0, count), in parallel, and waits for completion.
+     * @details Indices are handed out dynamically, so uneven work items balance
+     * across threads. The order in which indices run is unspecified; callers that
+     * need deterministic output should store results by index. If a body throws,
+     * the remaining indices are skipped and the first exception is rethrown here.
+     * @param count Number of iterations.
+     * @param body The loop body; must be safe to call concurrently.
+     */
+    void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    /**
+     * @brief Gets the number of threads that can work on a loop (workers + caller).
+     */
+    size_t GetConcurrency() const { return m_workers.size() + 1; }
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+};
+
+} // namespace DynaRange::Utils
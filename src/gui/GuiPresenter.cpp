@@ -13,7 +13,9 @@
 #include "../core/utils/OutputNamingContext.hpp"
 #include "../core/arguments/Constants.hpp"
 #include "../core/setup/PreAnalysis.hpp"
+#include "../core/setup/PreAnalysisCache.hpp"
 #include <algorithm>
+#include <chrono>
 #include <future>
 #include <ostream>
 #include <set>
@@ -84,8 +86,11 @@ void GuiPresenter::UpdateManagerFromView()
 
     // --- Update ArgumentManager with values from GUI controls (most are unchanged) ---
     mgr.Set(InputFiles, m_inputFileManager.GetInputFiles()); // Use manager's clean list
-    mgr.Set(BlackFile, inputCtrl->GetDarkFilePath());
-    mgr.Set(SaturationFile, inputCtrl->GetSaturationFilePath());
+    // The GUI selects a single calibration frame of each kind.
+    const std::string dark_file = inputCtrl->GetDarkFilePath();
+    const std::string sat_file = inputCtrl->GetSaturationFilePath();
+    mgr.Set(BlackFile, dark_file.empty() ? std::vector<std::string>{} : std::vector<std::string>{dark_file});
+    mgr.Set(SaturationFile, sat_file.empty() ? std::vector<std::string>{} : std::vector<std::string>{sat_file});
     mgr.Set(BlackLevel, inputCtrl->GetDarkValue());
     mgr.Set(SaturationLevel, inputCtrl->GetSaturationValue());
     mgr.Set(PatchRatio, inputCtrl->GetPatchRatio());
@@ -284,10 +289,9 @@ void GuiPresenter::StartAnalysis()
     }
 
     // 6. Filter calibration files from the input list for this run
-    if (!runOpts.dark_file_path.empty() || !runOpts.sat_file_path.empty()) {
-        std::set<std::string> calibration_files;
-        if (!runOpts.dark_file_path.empty()) calibration_files.insert(runOpts.dark_file_path);
-        if (!runOpts.sat_file_path.empty()) calibration_files.insert(runOpts.sat_file_path);
+    if (!runOpts.dark_file_paths.empty() || !runOpts.sat_file_paths.empty()) {
+        std::set<std::string> calibration_files(runOpts.dark_file_paths.begin(), runOpts.dark_file_paths.end());
+        calibration_files.insert(runOpts.sat_file_paths.begin(), runOpts.sat_file_paths.end());
 
         // Remove calibration files directly from the runOpts copy
         runOpts.input_files.erase(
@@ -342,39 +346,26 @@ void GuiPresenter::AddInputFiles(const std::vector<std::string>& files_to_add)
 
     if (new_valid_files.empty()) return;
 
-    std::vector<std::future<PreAnalysisResult>> futures;
     double sat_value = m_view->GetSaturationValue();
-    for (const auto& file : new_valid_files) {
-        futures.push_back(std::async(std::launch::async, [file, sat_value]() -> PreAnalysisResult {
-            RawFile raw_file(file);
-            if (!raw_file.Load()) {
-                return {file, -1.0, 0.0f, true, sat_value}; // Signal load failure
-            }
-           
-             cv::Mat active_img = raw_file.GetActiveRawImage();
-            if (active_img.empty()) {
-                return {file, -1.0, 0.0f, true, sat_value}; // Signal invalid image
-            }
-            double mean_brightness = cv::mean(active_img)[0];
-            int saturated_pixels = cv::countNonZero(active_img >= (sat_value * 0.99));
-           
-             return {file, mean_brightness, raw_file.GetIsoSpeed(), saturated_pixels > 0, sat_value};
-        }));
-    }
-
-    std::vector<PreAnalysisResult> loaded_files;
-    for (auto& fut : futures) {
+    PreAnalysisCache persistent_cache; // Outlives the task below, which is joined before returning.
+    // The batch is pre-analyzed on the shared pool from a background task, so the UI keeps
+    // processing events. Files read in place are estimated from a pixel sample, and only
+    // those whose order is uncertain are scanned fully; decoded files get the exact
+    // summary, which is cached for later runs. Failed files are simply omitted.
+    auto future = std::async(std::launch::async, [&new_valid_files, sat_value, &persistent_cache]() {
+        return PreAnalyzeRawFiles(new_valid_files, sat_value, nullptr, nullptr, &persistent_cache, true);
+    });
+    while (future.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready) {
         wxTheApp->Yield();
-        auto result = fut.get();
-        if (result.mean_brightness >= 0.0) { // Only keep successfully loaded files
-            loaded_files.push_back(result);
-        }
     }
+    std::vector<PreAnalysisResult> loaded_files = future.get();
 
     if (loaded_files.empty()) return;
 
+    // The results carry the same ratio-based saturation flag that PreAnalysisManager::AddFile
+    // used to recompute for every added file (see HasSaturatedPixels()).
     for (const auto& entry : loaded_files) {
-        m_preAnalysisManager.AddFile(entry.filename, sat_value);
+        m_preAnalysisManager.AddResult(entry);
     }
 
     UpdateRawPreviewFromCache();
@@ -441,12 +432,19 @@ void GuiPresenter::UpdateCalibrationFiles()
 
     if (clean_list != current_list) {
         wxBusyInfo wait(_("Updating file list and preview..."), m_view);
-        // Rebuild the pre-analysis manager from the clean list
-        m_preAnalysisManager.Clear();
+        // Sync the pre-analysis manager with the clean list, only analyzing files it does not know yet.
         double sat_value = m_view->GetSaturationValue();
+        for (const auto& file : current_list) {
+            if (std::find(clean_list.begin(), clean_list.end(), file) == clean_list.end()) {
+                m_preAnalysisManager.RemoveFile(file);
+            }
+        }
         for (const auto& file : clean_list) {
-            m_preAnalysisManager.AddFile(file, sat_value);
+            if (std::find(current_list.begin(), current_list.end(), file) == current_list.end()) {
+                m_preAnalysisManager.AddFile(file, sat_value);
+            }
         }
+        m_preAnalysisManager.UpdateSaturationValue(sat_value);
         UpdateRawPreviewFromCache();
     }
     
@@ -11,9 +11,9 @@
 #include "../../core/arguments/ArgumentsOptions.hpp"
 #include "../../core/utils/OutputNamingContext.hpp" 
 #include "../../core/utils/OutputFilenameGenerator.hpp"
+#include "../../core/io/raw/RawFile.hpp"
 #include "../GuiPresenter.hpp"
 #include "../helpers/RawExtensionHelper.hpp"
-#include <libraw/libraw.h>
 #include <set>
 #include <sstream>
 #include <string>
@@ -142,8 +142,10 @@ void InputController::PerformFileRemoval() {
     m_frame->m_removeRawFilesButton->Enable(false);
 }
 bool InputController::IsSupportedRawFile(const wxString& filePath) {
-    LibRaw p;
-    return p.open_file(filePath.mb_str()) == LIBRAW_SUCCESS;
+    // Header-only check: rejects unreadable files and formats without CFA data
+    // (e.g. sRAW, linear DNG) without decoding any pixels.
+    RawFile raw_file(std::string(filePath.mb_str()));
+    return raw_file.LoadMetadata() && raw_file.HasRawMosaicData();
 }
 void InputController::AddDroppedFiles(const wxArrayString& filenames) {
     std::vector<std::string> files_to_add;
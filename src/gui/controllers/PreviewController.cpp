@@ -59,7 +59,8 @@ void PreviewController::DisplayPreviewImage(const std::string &path) {
         m_manualCoordsActive = false; // Deactivate on clear
     } else {
         RawFile raw_file(path);
-        if (raw_file.Load()) {
+        // Metadata-only open; the pixel data is decoded lazily by GetProcessedImage().
+        if (raw_file.LoadMetadata()) {
             m_rawOrientation = raw_file.GetOrientation();
             m_originalActiveWidth = raw_file.GetActiveWidth();
             m_originalActiveHeight = raw_file.GetActiveHeight();
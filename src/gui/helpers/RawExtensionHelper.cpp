@@ -5,6 +5,7 @@
  */
 #include "RawExtensionHelper.hpp"
 #include "../Constants.hpp"
+#include "../../core/io/raw/Constants.hpp"
 #include <libraw/libraw.h>
 #include <libraw/libraw_version.h>
 
@@ -35,6 +36,12 @@ const std::vector<std::string>& GetSupportedRawExtensions() {
         if (extensions.empty()) {
             extensions = DynaRange::Gui::Constants::FALLBACK_RAW_EXTENSIONS;
         }
+        // Plain mosaics are read by DynaRange itself, not by LibRaw.
+        for (const char* mosaic_extension : DynaRange::IO::Raw::Constants::PLAIN_MOSAIC_EXTENSIONS) {
+            if (std::find(extensions.begin(), extensions.end(), mosaic_extension) == extensions.end()) {
+                extensions.push_back(mosaic_extension);
+            }
+        }
     }
     return extensions;
 }